@@ -29,8 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h"
+#include <boost/bind.hpp>
 #include "Boss.h"
-#include "engine/CallbackInterpolator.h"
 #include "engine/Dimmer.h"
 #include "engine/GameStateMenu.h"
 
@@ -64,15 +64,11 @@ void Boss::OnDeath(void)
 
 	// Dim the screen and Return to the menu after a short delay
 	float delay = 4000.0f;
-	boost::function<void (void)> fn = boost::bind(&Boss::returnToMenu, this);
-	Task *task = Engine::makeCallbackInterpolator(&Dimmer::alphaBlur, 0.0f, 1.0f, delay, fn);
-	g_Application.addTask(task);
+	g_Scheduler.scheduleInterpolation(&Dimmer::alphaBlur, 0.0f, 1.0f, delay, boost::bind(&Boss::returnToMenu, zoneName));
 }
 
-void Boss::returnToMenu(void)
+void Boss::returnToMenu(const string &zoneName)
 {
-	const string &zoneName = toLowerCase(getZone().getName());
-
 	// Enter the lead-out menu
 	     if(zoneName == "world3")
 		GameStateMenu::GetSingleton().enterGameMenuWorldLeadOut(3);
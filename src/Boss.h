@@ -56,8 +56,12 @@ public:
 	virtual void OnDeath(void);
 
 private:
-	/** Return to the menu a short time after the boss dies */
-	void returnToMenu(void);
+	/**
+	Return to the menu a short time after the boss dies.
+	The boss may have been deleted by then, so this must not refer to it.
+	@param zoneName Lower-case name of the zone the boss died in
+	*/
+	static void returnToMenu(const string &zoneName);
 };
 
 } //namespace
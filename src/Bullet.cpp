@@ -37,6 +37,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace Arbarlith2 {
 
 GEN_ACTOR_RTTI_CPP(Bullet, "class Arbarlith2::Bullet")
+GEN_ACTOR_POOL_CPP(Bullet, 64)
 
 Bullet::Bullet(OBJECT_ID ID)
 :Trigger(ID)
@@ -100,36 +101,36 @@ void Bullet::shoot(OBJECT_ID owner, const vec3 &velocity, int damageValue, const
 	particleHandle = getZone().SpawnPfx(particleDef, getPos());
 }
 
-bool Bullet::pollConditions(void) const
+bool Bullet::findTarget(OBJECT_ID &id) const
 {
-	OBJECT_ID unused;
-
-	/*
-	Having difficulties here.
-	Broken up to aid in dissecting the backtrace
-	*/
+	const vector<OBJECT_ID> &occupants = getRegionOccupants();
 
-	const World &world = getZone();
-
-	const ActorSet &objects = world.getObjects();
-
-	const ActorSet &creatures = objects.typeFilter<Creature>();
+	// Only consider Creatures near the Bullet that are not the Bullet owner
+	for(vector<OBJECT_ID>::const_iterator i = occupants.begin(); i != occupants.end(); ++i)
+	{
+		if(*i != owner && isInProximity(*i, getCylinderRadius()))
+		{
+			id = *i;
+			return true;
+		}
+	}
 
-	const ActorSet &creatures_notowner = creatures.exclude(owner);
+	return false;
+}
 
-	return isAnythingInProximity(creatures_notowner, unused);
+bool Bullet::pollConditions(void) const
+{
+	OBJECT_ID unused;
+	return findTarget(unused);
 }
 
 void Bullet::onTrigger(void)
 {
 	OBJECT_ID id = INVALID_ID;
 
-	// Only consider Creature from our World that are not the Bullet owner
-	ActorSet s = getZone().getObjects().typeFilter<Creature>().exclude(owner);
-
-	if(isAnythingInProximity(s, id))
+	if(findTarget(id))
 	{
-		Creature& creature = dynamic_cast<Creature&>(s.get(id));
+		Creature& creature = dynamic_cast<Creature&>(getZone().getObjects().get(id));
 
 		creature.damage(damageValue, owner);
 		creature.applyKnockBack(creature.getPos()-getPos());
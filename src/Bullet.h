@@ -101,6 +101,32 @@ protected:
 	*/
 	virtual bool pollConditions(void) const;
 
+	/**
+	Bullets can strike any creature
+	@return REGION_OCCUPANT_ANY
+	*/
+	virtual unsigned int getRegionMask(void) const
+	{
+		return REGION_OCCUPANT_ANY;
+	}
+
+	/**
+	The region is padded by the distance the bullet may travel in one tick,
+	as the region's occupants are those of the previous tick.
+	@return radius of the region
+	*/
+	virtual float getRegionRadius(void) const
+	{
+		return getCylinderRadius() + topSpeed * 0.1f;
+	}
+
+	/**
+	Finds a creature, other than the owner, struck by the bullet
+	@param id Returns the ID of the creature
+	@return true if a creature was struck
+	*/
+	bool findTarget(OBJECT_ID &id) const;
+
 	/** Called in the event of the Trigger activating */
 	virtual void onTrigger(void);
 
@@ -40,6 +40,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace Arbarlith2 {
 
 GEN_ACTOR_RTTI_CPP(Monster, "class Arbarlith2::Monster")
+GEN_ACTOR_POOL_CPP(Monster, 32)
 
 Monster::Monster(OBJECT_ID ID)
 : Creature(ID)
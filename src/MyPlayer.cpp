@@ -29,10 +29,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h"
+#include <boost/bind.hpp>
 
 #include "engine/gl.h"
 #include "engine/LinearInterpolator.h"
-#include "engine/CallbackTask.h"
 
 #include "Spell.h"
 #include "SpellFireBall.h"
@@ -221,9 +221,7 @@ bool MyPlayer::doUseAction(void)
 				float delay = getAnimationLength(animHandle);
 				ChangeAnimation(animHandle);
 
-				boost::function<void (void)> fn = boost::bind(&MyPlayer::startAttackAction, this, i->first);
-				Task *task = Engine::makeCallbackTask(delay*.075f, fn);
-				g_Application.addTask(task);
+				g_Scheduler.schedule(delay*.075f, boost::bind(&MyPlayer::startAttackAction, this, i->first), m_ID);
 			}
 
 			// Signal that SOME action was taken
@@ -249,26 +247,27 @@ bool MyPlayer::canMove(void) const
 	return Player::canMove();
 }
 
-void MyPlayer::drawObject(void) const
+void MyPlayer::submit(RenderQueue &queue) const
 {
-	Player::drawObject();
+	Player::submit(queue);
 
 	// Draw the HP and charge bar unless the Creature class is going to do that
 	if(isAlive() && !g_Application.displayDebugData)
 	{
-		drawHealthBar();
-		drawChargeBar();
+		queue.addCustom(RenderQueue::OPAQUE_BUCKET, getPos(), boost::bind(&MyPlayer::drawHealthBar, this));
+		queue.addCustom(RenderQueue::OPAQUE_BUCKET, getPos(), boost::bind(&MyPlayer::drawChargeBar, this));
 	}
 
 	if(state == GHOST)
 	{
-		drawStateCountdown();
+		queue.addCustom(RenderQueue::TRANSPARENT_BUCKET, getPos(), boost::bind(&MyPlayer::drawStateCountdown, this));
 	}
 
 	// Draw spell effects
+	const vec3 center = getPos() + vec3(0, this->m_desiredHeight, 0);
 	for(vector<Spell*>::const_iterator iter = spellList.begin(); iter != spellList.end(); ++iter)
 	{
-		(*iter)->draw(getPos() + vec3(0, this->m_desiredHeight, 0));
+		queue.addCustom(RenderQueue::TRANSPARENT_BUCKET, center, boost::bind(&Spell::draw, *iter, center));
 	}
 }
 
@@ -134,8 +134,11 @@ public:
 		getSpell(spellIdx).available = enable;
 	}
 
-	/** Transforms and renders the player */
-	virtual void drawObject(void) const;
+	/**
+	Queues the player, its status bars, and its spell effects to be rendered
+	@param queue The render queue
+	*/
+	virtual void submit(Engine::RenderQueue &queue) const;
 
 	/** Used by drawObject to render Debug data */
 	virtual void drawObjectDebugData(void) const;
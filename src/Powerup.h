@@ -58,6 +58,15 @@ public:
 	virtual void update(float milliseconds);
 
 protected:
+	/**
+	Powerups spin in place and so never sleep
+	@return false
+	*/
+	virtual bool canSleep(void) const
+	{
+		return false;
+	}
+
 	/**
 	Called whenever the player picks up the powerup
 	@param player the pointer to the player who picks up
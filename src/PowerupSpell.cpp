@@ -30,7 +30,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "engine/world.h"
-#include "engine/CallbackTask.h"
 #include "engine/ListPaneWidget.h"
 #include "engine/GameStateRun.h"
 #include "MyPlayer.h"
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "engine/gl.h"
+#include "engine/StateCache.h"
 #include "engine/LinearInterpolator.h"
 #include "engine/GameStateSpellMenu.h"
 #include "Spell.h"
@@ -123,13 +124,13 @@ void Spell::create(PropertyBag &xml)
 
 void Spell::drawIcon(bool active, const vec3 &center, float size) const
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-		glDisable(GL_LIGHTING);
-		glDisable(GL_COLOR_MATERIAL);
-		glDisable(GL_CULL_FACE);
+		g_StateCache.disable(GL_LIGHTING);
+		g_StateCache.disable(GL_COLOR_MATERIAL);
+		g_StateCache.disable(GL_CULL_FACE);
 
-		glEnable(GL_TEXTURE_2D);
+		g_StateCache.enable(GL_TEXTURE_2D);
 		(active ? matActive : matInactive).bind();
 
 		glPushMatrix();
@@ -152,12 +153,12 @@ void Spell::drawIcon(bool active, const vec3 &center, float size) const
 			glEnd();
 
 		glPopMatrix();
-	glPopAttrib();
+	g_StateCache.pop();
 }
 
 void Spell::drawIcon2D(bool active, float x, float y, float size) const
 {
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.enable(GL_TEXTURE_2D);
 	(active ? matActive : matInactive).bind();
 
 	glBegin(GL_QUADS);
@@ -181,10 +182,10 @@ void Spell::drawIcon2D(bool active, float x, float y, float size) const
 
 void Spell::drawSpell_X(float x, float y, float size) const
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glDisable(GL_TEXTURE_2D);
-	glEnable(GL_LINE_SMOOTH);
+	g_StateCache.disable(GL_TEXTURE_2D);
+	g_StateCache.enable(GL_LINE_SMOOTH);
 	glLineWidth(3);
 	glColor4fv(red);
 
@@ -196,16 +197,19 @@ void Spell::drawSpell_X(float x, float y, float size) const
 		glVertex3f(x + size, y + 0.0f, 0.0f);
 	glEnd();
 
-	glPopAttrib();
+	glLineWidth(1);
+	glColor4fv(white);
+
+	g_StateCache.pop();
 }
 
 void Spell::drawSpell_Lock(float x, float y, float size) const
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glEnable(GL_TEXTURE_2D);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_BLEND);
+	g_StateCache.enable(GL_TEXTURE_2D);
+	g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	g_StateCache.enable(GL_BLEND);
 	GameStateSpellMenu::GetSingleton().padlock.bind();
 
 	glBegin(GL_QUADS);
@@ -215,7 +219,7 @@ void Spell::drawSpell_Lock(float x, float y, float size) const
 		glTexCoord2f(1.0f, 0.0f); glVertex3f(x + size, y + 0.0f, 0.0f);
 	glEnd();
 
-	glPopAttrib();
+	g_StateCache.pop();
 }
 
 void Spell::update(float deltaTime)
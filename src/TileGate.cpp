@@ -29,9 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h"
+#include <boost/bind.hpp>
 #include "engine/world.h"
-#include "engine/CallbackInterpolator.h"
-#include "engine/CallbackTask.h"
 #include "engine/ListPaneWidget.h"
 #include "engine/ListElementTweaker.h"
 #include "engine/ToggleWidgetText.h"
@@ -56,6 +55,7 @@ void TileGate::clear(void)
 	unlockTime = 1000.0f;
 	reactionDelay = 0.0f;
 	initiallyLocked = true;
+	bakedHeight = 0.0f;
 	unlockSfx="nill";
 	lockSfx="nill";
 }
@@ -102,6 +102,19 @@ void TileGate::load(const PropertyBag &xml)
 	}
 }
 
+void TileGate::update(float deltaTime)
+{
+	Actor::update(deltaTime);
+
+	const float height = getTile().getTileHeight();
+
+	if(fabsf(height - bakedHeight) > FLT_EPSILON)
+	{
+		getZone().getMap().invalidateTile(getPos().x, getPos().z);
+		bakedHeight = height;
+	}
+}
+
 bool TileGate::saveTidy(PropertyBag &xml, PropertyBag &editorData) const
 {
 	saveTag(xml, editorData, "lockedHeight",	lockedHeight);
@@ -124,9 +137,7 @@ void TileGate::unlockGate(void)
 	}
 	else
 	{
-		boost::function<void (void)> fn = boost::bind(&TileGate::unlockGateImmediately, this);
-		Task *task = makeCallbackTask(reactionDelay, fn);
-		g_Application.addTask(task);
+		g_Scheduler.schedule(reactionDelay, boost::bind(&TileGate::unlockGateImmediately, this), m_ID);
 	}
 }
 
@@ -138,9 +149,7 @@ void TileGate::lockGate(void)
 	}
 	else
 	{
-		boost::function<void (void)> fn = boost::bind(&TileGate::lockGateImmediately, this);
-		Task *task = makeCallbackTask(reactionDelay, fn);
-		g_Application.addTask(task);
+		g_Scheduler.schedule(reactionDelay, boost::bind(&TileGate::lockGateImmediately, this), m_ID);
 	}
 }
 
@@ -150,9 +159,12 @@ void TileGate::unlockGateImmediately(void)
 
 	Tile &tile = getTile();
 
-	boost::function<void (void)> fn = boost::bind(&TileGate::onUnlocked, this);
-	Task *task = makeCallbackInterpolator(tile.getModifiableTileHeight(), tile.getTileHeight(), unlockedHeight, unlockTime, fn);
-	g_Application.addTask(task);
+	g_Scheduler.scheduleInterpolation(tile.getModifiableTileHeight(),
+	                                  tile.getTileHeight(),
+	                                  unlockedHeight,
+	                                  unlockTime,
+	                                  boost::bind(&TileGate::onUnlocked, this),
+	                                  m_ID);
 
 	if(unlockSfx!="nill")
 		g_SoundSystem.play(unlockSfx);
@@ -164,9 +176,12 @@ void TileGate::lockGateImmediately(void)
 
 	Tile &tile = getTile();
 
-	boost::function<void (void)> fn = boost::bind(&TileGate::onLocked, this);
-	Task *task = makeCallbackInterpolator(tile.getModifiableTileHeight(), tile.getTileHeight(), lockedHeight, lockTime, fn);
-	g_Application.addTask(task);
+	g_Scheduler.scheduleInterpolation(tile.getModifiableTileHeight(),
+	                                  tile.getTileHeight(),
+	                                  lockedHeight,
+	                                  lockTime,
+	                                  boost::bind(&TileGate::onLocked, this),
+	                                  m_ID);
 
 	if(lockSfx!="nill")
 		g_SoundSystem.play(lockSfx);
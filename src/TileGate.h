@@ -59,6 +59,12 @@ public:
 	*/
 	virtual void load(const PropertyBag &data);
 
+	/**
+	Updates the gate, rebuilding the map around it while the tile moves
+	@param deltaTime milliseconds since the last update
+	*/
+	virtual void update(float deltaTime);
+
 	/** Unlocks the gate after the reaction time delay has passed */
 	void unlockGate(void);
 
@@ -123,6 +129,9 @@ private:
 	/** The gate is to be locked when the map is loaded */
 	bool initiallyLocked;
 
+	/** Height of the tile when the map was last told that it changed */
+	float bakedHeight;
+
 	/** Sound effect file to play when the gate unlocks */
 	string unlockSfx;
 
@@ -51,6 +51,17 @@ template<class T> struct ActorRegistrar
 
 #define GEN_ACTOR_RTTI_CPP(TYPE, NAME) namespace { ::Engine::ActorRegistrar< TYPE > _registrar(NAME); }
 
+template<class T> struct ActorPoolRegistrar
+{
+	ActorPoolRegistrar(size_t capacity)
+	{
+		::Engine::getActorFactory().enablePool<T>(capacity);
+	}
+};
+
+/** Recycles released actors of the type, holding no more than CAPACITY of them for reuse */
+#define GEN_ACTOR_POOL_CPP(TYPE, CAPACITY) namespace { ::Engine::ActorPoolRegistrar< TYPE > _poolRegistrar(CAPACITY); }
+
 } // namespace Engine
 
 #endif
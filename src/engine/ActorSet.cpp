@@ -65,6 +65,7 @@ static Actor* toActor(pair<OBJECT_ID,Actor*> p)
 
 void ActorSet::destroy(void)
 {
+	spawnData.clear();
 	clear();
 }
 
@@ -131,27 +132,35 @@ Actor* ActorSet::getPtr(OBJECT_ID id)
 		return 0;
 }
 
-void ActorUpdate(pair<OBJECT_ID,Actor*> p, float deltaTime)
+void ActorUpdate(Actor *a, float deltaTime)
 {
-	if(!p.second->zombie)
+	if(!a->zombie)
 	{
-		p.second->update(deltaTime);
+		a->update(deltaTime);
 	}
 }
 
-void ActorCollisionDetection(pair<OBJECT_ID,Actor*> p, ActorSet * s)
+void ActorCollisionDetection(Actor *a, ActorSet * s)
 {
-	if(!p.second->zombie)
+	if(!a->zombie)
 	{
-		p.second->DoCollisionDetection(*s);
+		a->DoCollisionDetection(*s);
 	}
 }
 
-void ActorCollisionResponse(pair<OBJECT_ID,Actor*> p)
+void ActorCollisionResponse(Actor *a)
 {
-	if(!p.second->zombie)
+	if(!a->zombie)
 	{
-		p.second->DoCollisionResponse();
+		a->DoCollisionResponse();
+	}
+}
+
+void ActorUpdateActivity(Actor *a, float deltaTime)
+{
+	if(!a->zombie)
+	{
+		a->updateActivity(deltaTime);
 	}
 }
 
@@ -159,9 +168,26 @@ void ActorSet::update(float deltaTime, World *world)
 {
 	PROFILE
 
-	for_each(begin(), end(), bind(ActorUpdate, _1, deltaTime));
-	for_each(begin(), end(), bind(ActorCollisionDetection, _1, this));
-	for_each(begin(), end(), bind(ActorCollisionResponse, _1));
+	// Sleeping actors are skipped, but awake actors still collide against them
+	awake.clear();
+	numAsleep = 0;
+	for(const_iterator iter = begin(); iter != end(); ++iter)
+	{
+		Actor *a = iter->second;
+
+		if(a->zombie)
+			continue;
+
+		if(a->isAsleep())
+			numAsleep++;
+		else
+			awake.push_back(a);
+	}
+
+	for_each(awake.begin(), awake.end(), bind(ActorUpdate, _1, deltaTime));
+	for_each(awake.begin(), awake.end(), bind(ActorCollisionDetection, _1, this));
+	for_each(awake.begin(), awake.end(), bind(ActorCollisionResponse, _1));
+	for_each(awake.begin(), awake.end(), bind(ActorUpdateActivity, _1, deltaTime));
 
 	// Spawn creatures as requested
 	for_each(requestedSpawns.begin(), requestedSpawns.end(), bind(&ActorSet::doSpawnRequest, this, _1, world));
@@ -170,6 +196,26 @@ void ActorSet::update(float deltaTime, World *world)
 	garbageCollection(); // TODO: MAKE THIS A PERIODIC TASK
 }
 
+void ActorSet::wakeWithin(float minX, float minZ, float maxX, float maxZ)
+{
+	for(iterator iter = begin(); iter != end(); ++iter)
+	{
+		Actor *a = iter->second;
+
+		if(!a->isAsleep())
+			continue;
+
+		const vec3 &pos = a->getPos();
+		const float r = a->getCylinderRadius();
+
+		if(pos.x + r >= minX && pos.x - r <= maxX &&
+		   pos.z + r >= minZ && pos.z - r <= maxZ)
+		{
+			a->wake();
+		}
+	}
+}
+
 vector<Actor*> ActorSet::getByName(const string &name)
 {
 	vector<Actor*> actors;
@@ -189,53 +235,26 @@ vector<Actor*> ActorSet::getByName(const string &name)
 
 void ActorSet::garbageCollection(void)
 {
-	// delete zombie actors
-	ActorSet::const_iterator iter = begin();
-	ActorSet::const_iterator nextIter;
+	ActorSet::iterator iter = begin();
 
 	while(iter != end())
 	{
-		// Get an iterator to the next element (or the end of the map)
-		nextIter = iter;
-		nextIter++;
-
 		if(static_cast<Actor*>(iter->second)->zombie)
 		{
-			Engine::getActorFactory().remove(iter->first);
-			erase(iter->first);
-		}
+			const OBJECT_ID id = iter->first;
+			g_Scheduler.cancelAll(id);
+			erase(iter++);
 
-		iter = nextIter;
+			// delete the actor, or return it to its pool
+			Engine::getActorFactory().remove(id);
+		}
+		else
+		{
+			++iter;
+		}
 	}
 }
 
-void ActorSet::drawActor(const Frustum *frustum, Actor *p)
-{
-	ASSERT(frustum!=0, "Null parameter! frustum was null");
-	ASSERT(p!=0, "Null parameter! p was null");
-
-	if(!p->zombie && frustum->SphereInFrustum2(p->getPos(), p->getSphereRadius()*2))
-		p->drawObject();
-}
-
-void ActorSet::drawActorTransparent(const Frustum *frustum, Actor *p)
-{
-	ASSERT(frustum!=0, "Null parameter! frustum was null");
-	ASSERT(p!=0, "Null parameter! p was null");
-
-	if(!p->zombie && frustum->SphereInFrustum2(p->getPos(), p->getSphereRadius()*2))
-		p->drawTransparentObject();
-}
-
-void ActorSet::drawActorDebugText(const Frustum *frustum, Actor *p)
-{
-	ASSERT(frustum!=0, "Null parameter! frustum was null");
-	ASSERT(p!=0, "Null parameter! p was null");
-
-	if(!p->zombie && frustum->SphereInFrustum2(p->getPos(), p->getSphereRadius()*2))
-		p->drawObjectDebugData();
-}
-
 void ActorSet::drawActorToDepthBuffer(Actor *p)
 {
 	ASSERT(p!=0, "Null parameter! p was null");
@@ -247,12 +266,19 @@ void ActorSet::drawActorToDepthBuffer(Actor *p)
 ActorSet ActorSet::isWithin(const Frustum &frustum) const
 {
 	ActorSet s;
+	SphereBatch bounds;
 
 	for(const_iterator i=begin(); i!=end(); ++i)
 	{
-		const Actor *p = i->second;
+		bounds.add(i->second->getPos(), i->second->getSphereRadius()*2);
+	}
 
-		if(!p->zombie && frustum.SphereInFrustum2(p->getPos(), p->getSphereRadius()*2))
+	frustum.cull(bounds);
+
+	size_t index = 0;
+	for(const_iterator i=begin(); i!=end(); ++i, ++index)
+	{
+		if(!i->second->zombie && bounds.isVisible(index))
 		{
 			s.insert(*i);
 		}
@@ -264,12 +290,19 @@ ActorSet ActorSet::isWithin(const Frustum &frustum) const
 ActorSet ActorSet::isNotWithin(const Frustum &frustum) const
 {
 	ActorSet s;
+	SphereBatch bounds;
 
 	for(const_iterator i=begin(); i!=end(); ++i)
 	{
-		const Actor *p = i->second;
+		bounds.add(i->second->getPos(), i->second->getSphereRadius()*2);
+	}
 
-		if(!p->zombie && !frustum.SphereInFrustum2(p->getPos(), p->getSphereRadius()*2))
+	frustum.cull(bounds);
+
+	size_t index = 0;
+	for(const_iterator i=begin(); i!=end(); ++i, ++index)
+	{
+		if(!i->second->zombie && !bounds.isVisible(index))
 		{
 			s.insert(*i);
 		}
@@ -295,19 +328,6 @@ ActorSet ActorSet::haveMoved(void) const
 	return s;
 }
 
-void ActorSet::draw(const Frustum &frustum) const
-{
-	PROFILE
-	for_each(begin(), end(), bind(&ActorSet::drawActor, &frustum, bind(&toActor, _1)));
-
-	for_each(begin(), end(), bind(&ActorSet::drawActorTransparent, &frustum, bind(&toActor, _1)));
-
-	if(g_Application.displayDebugData)
-	{
-		for_each(begin(), end(), bind(&ActorSet::drawActorDebugText, &frustum, bind(&toActor, _1)));
-	}
-}
-
 void ActorSet::drawToDepthBuffer(void) const
 {
 	for_each(begin(), end(), bind(&ActorSet::drawActorToDepthBuffer, bind(&toActor, _1)));
@@ -338,9 +358,16 @@ void ActorSet::doSpawnRequest(const RequestedSpawn &request, World *zone)
 
 void ActorSet::spawnNow(const string &dataFile, const vec3 &position, World *zone)
 {
-	PropertyBag xml;
-	xml.loadFromFile(dataFile);
-	spawnNow(xml, position, zone);
+	map<string, PropertyBag>::iterator iter = spawnData.find(dataFile);
+
+	if(iter == spawnData.end())
+	{
+		PropertyBag xml;
+		xml.loadFromFile(dataFile);
+		iter = spawnData.insert(make_pair(dataFile, xml)).first;
+	}
+
+	spawnNow(iter->second, position, zone);
 }
 
 Actor& ActorSet::spawnNow(const PropertyBag &data, World *zone)
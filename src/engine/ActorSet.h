@@ -51,6 +51,7 @@ class ActorSet : public map<const Engine::OBJECT_ID, Engine::Actor*>
 public:
 	/** Creates an empty set */
 	ActorSet(void)
+	: numAsleep(0)
 	{
 		clear();
 	}
@@ -61,6 +62,7 @@ public:
 	@param zone The home zone of the object
 	*/
 	ActorSet(const PropertyBag &xml, World *zone)
+	: numAsleep(0)
 	{
 		ASSERT(zone!=0, "zone was NULL");
 		clear();
@@ -139,12 +141,6 @@ public:
 	*/
 	const Actor& get(OBJECT_ID id) const;
 
-	/**
-	Draws all objects in the set
-	@param frustum The frustum of the camera
-	*/
-	void draw(const Frustum &frustum) const;
-
 	/** Draws all objects in the set to the depth buffer */
 	void drawToDepthBuffer(void) const;
 
@@ -155,6 +151,33 @@ public:
 	*/
 	void update(float deltaTime, World *zone);
 
+	/**
+	Gets the number of actors that were awake and updated during the last tick
+	@return number of awake actors
+	*/
+	inline size_t getNumAwake(void) const
+	{
+		return awake.size();
+	}
+
+	/**
+	Gets the number of actors that were asleep during the last tick
+	@return number of sleeping actors
+	*/
+	inline size_t getNumAsleep(void) const
+	{
+		return numAsleep;
+	}
+
+	/**
+	Wakes every sleeping actor standing over a rectangle in the XZ-plane
+	@param minX Western edge of the rectangle
+	@param minZ Southern edge of the rectangle
+	@param maxX Eastern edge of the rectangle
+	@param maxZ Northern edge of the rectangle
+	*/
+	void wakeWithin(float minX, float minZ, float maxX, float maxZ);
+
 	/**
 	Add the objects from one actor set to another.
 	The original actor set can still destroy the objects it contains; be careful!
@@ -381,6 +404,15 @@ private:
 
 	vector<RequestedSpawn> requestedSpawns;
 
+	/** Spawn data files that have been loaded, as spawners request the same few over and over */
+	map<string, PropertyBag> spawnData;
+
+	/** Actors that were awake at the start of the last tick */
+	vector<Actor*> awake;
+
+	/** Number of actors that were asleep at the start of the last tick */
+	size_t numAsleep;
+
 	/**
 	Handle a requested spawn
 	@param request The requested spawn
@@ -408,27 +440,6 @@ private:
 		}
 	}
 
-	/**
-	If the actor is within the viewing frustum, draw the actor
-	@param frustum he viewing frustum
-	@param p The actor in question
-	*/
-	static void drawActor(const Frustum *frustum, Actor *p);
-
-	/**
-	If the actor is within the viewing frustum, draw the actor
-	@param frustum he viewing frustum
-	@param p The actor in question
-	*/
-	static void drawActorTransparent(const Frustum *frustum, Actor *p);
-
-	/**
-	If the actor is within the viewing frustum, draw the actor
-	@param frustum he viewing frustum
-	@param p The actor in question
-	*/
-	static void drawActorDebugText(const Frustum *frustum, Actor *p);
-
 	/**
 	If the actor is within the viewing frustum, draw the actor to the depth buffer
 	@param frustum he viewing frustum
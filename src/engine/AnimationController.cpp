@@ -37,6 +37,7 @@ namespace Engine {
 
 
 
+size_t AnimationController::numNameLookups = 0;
 
 AnimationController::AnimationController(void)
 {
@@ -50,11 +51,33 @@ void AnimationController::draw(void)
 	m_Animations[m_nCurrentAnimation].draw();
 }
 
-void AnimationController::update(float milliseconds)
+bool AnimationController::update(float milliseconds)
 {
 	ASSERT(m_nCurrentAnimation < m_Animations.size(), string("Invalid m_nCurrentAnimation: ") + itoa((int)m_nCurrentAnimation));
 
-	m_Animations[m_nCurrentAnimation].update(milliseconds);
+	AnimationSequence &animation = m_Animations[m_nCurrentAnimation];
+
+	animation.update(milliseconds);
+
+	const float poseTime = animation.getPoseTime();
+
+	const bool poseChanged = (m_nPoseAnimation != m_nCurrentAnimation) || (m_PoseTime != poseTime);
+
+	m_nPoseAnimation = m_nCurrentAnimation;
+	m_PoseTime = poseTime;
+
+	return poseChanged;
+}
+
+void AnimationController::rewind(void)
+{
+	m_nCurrentAnimation = 0;
+
+	if(!m_Animations.empty())
+	{
+		m_Animations[0].SetTime(0.0f);
+		m_Animations[0].setSpeed(1.0f);
+	}
 }
 
 const AnimationSequence& AnimationController::getAnimation(void) const
@@ -83,6 +106,8 @@ size_t AnimationController::addAnimation(AnimationSequence &animation)
 
 size_t AnimationController::getAnimationHandle(const string &name) const
 {
+	numNameLookups++;
+
 	// for all animations
 	for(size_t i=0; i<m_Animations.size(); ++i)
 	{
@@ -98,6 +123,23 @@ size_t AnimationController::getAnimationHandle(const string &name) const
 	return 0;
 }
 
+size_t AnimationController::getSharedMemoryUsage(void) const
+{
+	size_t bytes = 0;
+
+	for(size_t i=0; i<m_Animations.size(); ++i)
+	{
+		bytes += m_Animations[i].getSharedMemoryUsage();
+	}
+
+	return bytes;
+}
+
+size_t AnimationController::getInstanceMemoryUsage(void) const
+{
+	return sizeof(AnimationController) + sizeof(AnimationSequence) * m_Animations.capacity();
+}
+
 bool AnimationController::requestAnimationChange(size_t handle, float speed)
 {
 	ASSERT(handle				< m_Animations.size(),	string("Invalid handle: ") + itoa((int)handle));
@@ -157,6 +199,8 @@ float AnimationController::calculateHeight(float Time)
 void AnimationController::clear(void)
 {
 	m_nCurrentAnimation = 0;
+	m_nPoseAnimation = (size_t)-1; // report a change on the first update
+	m_PoseTime = 0.0f;
 	m_Animations.clear();
 }
 
@@ -45,6 +45,15 @@ private:
 	/** Records which of the above animation objects is currently being utilized by the model */
 	size_t m_nCurrentAnimation;
 
+	/** Animation of the pose reported by the last update */
+	size_t m_nPoseAnimation;
+
+	/** Pose time reported by the last update */
+	float m_PoseTime;
+
+	/** Number of animations looked up by name, across all controllers */
+	static size_t numNameLookups;
+
 public:
 	/** Constructs a blank animation controller */
 	AnimationController(void);
@@ -55,8 +64,12 @@ public:
 	/**
 	Updates the current animation
 	@param timeStep time since the last tick
+	@return true if the drawn pose has changed since the last update
 	*/
-	void update(float timeStep);
+	bool update(float timeStep);
+
+	/** Returns to the start of the first animation, as when first loaded */
+	void rewind(void);
 
 	/**
 	Gets the specified animation
@@ -109,6 +122,27 @@ public:
 	*/
 	size_t getAnimationHandle(const string &name) const;
 
+	/**
+	Gets the memory used by the animation data shared by all copies of the controller
+	@return bytes
+	*/
+	size_t getSharedMemoryUsage(void) const;
+
+	/**
+	Gets the memory used by one copy of the controller, excluding shared data
+	@return bytes
+	*/
+	size_t getInstanceMemoryUsage(void) const;
+
+	/**
+	Gets the number of animations looked up by name so far, across all controllers
+	@return number of name lookups
+	*/
+	static size_t getNumNameLookups(void)
+	{
+		return numNameLookups;
+	}
+
 	/**
 	Records an animation request
 	@param name The name of the animation
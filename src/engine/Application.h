@@ -39,6 +39,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "text.h"
 #include "opengl.h"
 #include "task.h"
+#include "Scheduler.h"
 #include "widgetmanager.h"
 #include "SoundSystem.h"
 #include "TextureManager.h"
@@ -127,6 +128,15 @@ public:
 	*/
 	virtual Task* addTask(Task *task);
 
+	/**
+	Allows access to the scheduler for delayed callbacks
+	@return Returns the scheduler
+	*/
+	Scheduler& getScheduler(void)
+	{
+		return scheduler;
+	}
+
 	/**
 	Gets the frame rate (FPS)
 	@return FPS
@@ -293,6 +303,9 @@ private:
 	/**	The list of live tasks */
 	list<Task*> tasks;
 
+	/** Executes delayed callbacks */
+	Scheduler scheduler;
+
 	/** the texture manager */
 	TextureManager m_Tex;
 
@@ -324,6 +337,7 @@ extern Engine::Application* g_pApplication;
 #define g_SoundSystem	(Engine::g_pApplication->getSoundSystem())
 #define g_TextureMgr	(Engine::g_pApplication->getTextureManager())
 #define g_Camera	(Engine::g_pApplication->getCamera())
+#define g_Scheduler	(Engine::g_pApplication->getScheduler())
 #define g_Window	(Engine::SDLWindow::GetSingleton())
 #define g_Input		(Engine::SDLWindow::GetSingleton().input)
 
@@ -30,17 +30,28 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "SDLwindow.h"
-#include "EffectManager.h"
-#include "world.h"
+#include "profile.h"
 #include "Blur.h"
 
 
 
 namespace Engine {
 
-
-
+/**
+Draws a textured quad over the whole viewport, when the projection and
+model view matrices are both the identity
+*/
+static void drawViewportQuad(float s0, float t0, float s1, float t1)
+{
+	glBegin(GL_QUADS);
+		glTexCoord2f(s1, t0); glVertex2f( 1.0f, -1.0f);
+		glTexCoord2f(s1, t1); glVertex2f( 1.0f,  1.0f);
+		glTexCoord2f(s0, t1); glVertex2f(-1.0f,  1.0f);
+		glTexCoord2f(s0, t0); glVertex2f(-1.0f, -1.0f);
+	glEnd();
+}
 
 Blur::Blur(int width, int height)
 {
@@ -57,29 +68,105 @@ void Blur::clear(void)
 {
 	update = false;
 	scene = 0;
+	shrunk = 0;
+	shrunkWidth = 0;
+	shrunkHeight = 0;
 	alphaBlur = 0.0f;
 	BLUR_TEXTURE_WIDTH = 0;
 	BLUR_TEXTURE_HEIGHT = 0;
+	sceneWidth = 0;
+	sceneHeight = 0;
+	frameWidth = 0;
+	frameHeight = 0;
+	blurLevel = 0;
+	generateMipmapsByHand = false;
 	alphaBlur = 1.0f;
-	zone = 0;
 }
 
 void Blur::release(void)
 {
+	StateCache::forgetTexture(scene);
 	glDeleteTextures(1, &scene);
 	scene=0;
+
+	if(shrunk)
+	{
+		StateCache::forgetTexture(shrunk);
+		glDeleteTextures(1, &shrunk);
+		shrunk=0;
+	}
 }
 
 void Blur::reaquire(void)
 {
 	release();
 
-	// Create the capture textures
+	frameWidth = (int)SDLWindow::GetSingleton().GetWidth();
+	frameHeight = (int)SDLWindow::GetSingleton().GetHeight();
+
+	sceneWidth = 1;
+	while(sceneWidth < frameWidth) sceneWidth <<= 1;
+
+	sceneHeight = 1;
+	while(sceneHeight < frameHeight) sceneHeight <<= 1;
+
+	// The blur is the first mipmap no larger than the blurred image size
+	const bool autoMipmaps = glewIsExtensionSupported("GL_SGIS_generate_mipmap")==GL_TRUE;
+	generateMipmapsByHand = g_bUseFramebufferObjects && !autoMipmaps;
+
+	blurLevel = 0;
+	if(autoMipmaps || generateMipmapsByHand)
+	{
+		while((frameWidth >> blurLevel) > BLUR_TEXTURE_WIDTH || (frameHeight >> blurLevel) > BLUR_TEXTURE_HEIGHT)
+		{
+			++blurLevel;
+		}
+	}
+
+	// Create the capture texture
 	glGenTextures(1, &scene);
-	glBindTexture(GL_TEXTURE_2D, scene);
-	glTexImage2D(GL_TEXTURE_2D, 0, 4, BLUR_TEXTURE_WIDTH, BLUR_TEXTURE_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	g_StateCache.bindTexture(scene);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (blurLevel>0) ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+
+	// Sample only the blur level, even though the quad covers the screen
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, blurLevel);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, (float)blurLevel);
+
+	if(autoMipmaps && blurLevel>0)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP_SGIS, GL_TRUE);
+	}
+
+	// Whatever lies beyond the frame is filtered into its edges, so make it black
+	vector<unsigned char> black(sceneWidth * sceneHeight * 4, 0);
+	glTexImage2D(GL_TEXTURE_2D, 0, 4, sceneWidth, sceneHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, &black[0]);
+
+	if(generateMipmapsByHand && blurLevel>0)
+	{
+		glGenerateMipmapEXT(GL_TEXTURE_2D);
+	}
+
+	// Without mipmaps, the frame is shrunk into a texture of the blurred image size
+	if(!autoMipmaps && !generateMipmapsByHand)
+	{
+		shrunkWidth = min(BLUR_TEXTURE_WIDTH, frameWidth);
+		shrunkHeight = min(BLUR_TEXTURE_HEIGHT, frameHeight);
+
+		glGenTextures(1, &shrunk);
+		g_StateCache.bindTexture(shrunk);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexImage2D(GL_TEXTURE_2D, 0, 4, BLUR_TEXTURE_WIDTH, BLUR_TEXTURE_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	}
+
+	CHECK_GL_ERROR();
 }
 
 void Blur::create(int width, int height)
@@ -100,40 +187,112 @@ void Blur::destroy(void)
 
 void Blur::capture(void)
 {
+	PROFILE
+
 	if(update)
 	{
 		update = false;
 
-		// Render the scene in the correct resolution
-		glViewport(0, 0, BLUR_TEXTURE_WIDTH, BLUR_TEXTURE_HEIGHT);
-		zone->draw();
+		// The capture texture must cover the whole screen
+		if(frameWidth != (int)SDLWindow::GetSingleton().GetWidth() ||
+		   frameHeight != (int)SDLWindow::GetSingleton().GetHeight())
+		{
+			reaquire();
+		}
+
+		// Copy the frame buffer at full resolution, then shrink it
+		g_StateCache.bindTexture(scene);
+		glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, frameWidth, frameHeight);
+
+		if(generateMipmapsByHand && blurLevel>0)
+		{
+			glGenerateMipmapEXT(GL_TEXTURE_2D);
+		}
 
-		// Read the frame buffer into a texture
-		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, scene);
-		glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, BLUR_TEXTURE_WIDTH, BLUR_TEXTURE_HEIGHT);
+		if(shrunk)
+		{
+			shrink();
+		}
 
-		// Reset the scene
-		glViewport(0, 0, SDLWindow::GetSingleton().GetWidth(), SDLWindow::GetSingleton().GetHeight());
+		CHECK_GL_ERROR();
 	}
 }
 
+void Blur::shrink(void)
+{
+	g_StateCache.push();
+
+	g_StateCache.disable(GL_LIGHTING);
+	g_StateCache.disable(GL_FOG);
+	g_StateCache.disable(GL_DEPTH_TEST);
+	g_StateCache.disable(GL_BLEND);
+	g_StateCache.enable(GL_TEXTURE_2D);
+	glColor4f(1, 1, 1, 1);
+
+	g_StateCache.matrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+
+	g_StateCache.matrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glViewport(0, 0, shrunkWidth, shrunkHeight);
+
+	// Draw the whole frame into the corner, filtered down, and copy it out
+	g_StateCache.bindTexture(scene);
+	drawViewportQuad(0.0f, 0.0f, (float)frameWidth / sceneWidth, (float)frameHeight / sceneHeight);
+
+	g_StateCache.bindTexture(shrunk);
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, shrunkWidth, shrunkHeight);
+
+	// Put the corner back, one texel to each pixel
+	g_StateCache.bindTexture(scene);
+	drawViewportQuad(0.0f, 0.0f, (float)shrunkWidth / sceneWidth, (float)shrunkHeight / sceneHeight);
+
+	glViewport(0, 0, frameWidth, frameHeight);
+
+	glPopMatrix();
+	g_StateCache.matrixMode(GL_PROJECTION);
+	glPopMatrix();
+	g_StateCache.matrixMode(GL_MODELVIEW);
+
+	g_StateCache.pop();
+}
+
 void Blur::draw(void)
 {
+	PROFILE
+
 	if(alphaBlur > FLT_EPSILON)
 	{
-		glPushAttrib(GL_ENABLE_BIT);
+		// Only part of the capture texture holds the frame
+		const float texel = (float)(1 << blurLevel);
+		float s0 = 0.5f * texel / sceneWidth;
+		float t0 = 0.5f * texel / sceneHeight;
+		float s1 = (frameWidth - 0.5f * texel) / sceneWidth;
+		float t1 = (frameHeight - 0.5f * texel) / sceneHeight;
+
+		if(shrunk)
+		{
+			s0 = 0.5f / BLUR_TEXTURE_WIDTH;
+			t0 = 0.5f / BLUR_TEXTURE_HEIGHT;
+			s1 = (shrunkWidth - 0.5f) / BLUR_TEXTURE_WIDTH;
+			t1 = (shrunkHeight - 0.5f) / BLUR_TEXTURE_HEIGHT;
+		}
+
+		g_StateCache.push();
 
 		glColor4f(1, 0, 0, alphaBlur);
-		glDisable(GL_LIGHTING);
-		glDisable(GL_FOG);
-		glDisable(GL_DEPTH_TEST);
+		g_StateCache.disable(GL_LIGHTING);
+		g_StateCache.disable(GL_FOG);
+		g_StateCache.disable(GL_DEPTH_TEST);
 
-		glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+		g_StateCache.enable(GL_BLEND);
+        g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE);
 
 		// Save the projection matrix
-		glMatrixMode(GL_PROJECTION);
+		g_StateCache.matrixMode(GL_PROJECTION);
 		glPushMatrix();
 
 		// Set up the projection matrix for 2D
@@ -141,7 +300,7 @@ void Blur::draw(void)
 		glOrtho(0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f);
 
 		// Save the model view matrix
-		glMatrixMode(GL_MODELVIEW);
+		g_StateCache.matrixMode(GL_MODELVIEW);
 		glPushMatrix();
 
 		// Set up the model view matrix
@@ -149,29 +308,29 @@ void Blur::draw(void)
 		glTranslatef(0.0f, 0.0f, -0.2f);
 
 		// Render a textured quad over the screen
-		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, scene);
+		g_StateCache.enable(GL_TEXTURE_2D);
+		g_StateCache.bindTexture(shrunk ? shrunk : scene);
 		glBegin(GL_QUADS);
-			glTexCoord2f(1.0f, 0.0f); glVertex3f(1024.0f,   0.0f, 0.0f);
-			glTexCoord2f(1.0f, 1.0f); glVertex3f(1024.0f, 768.0f, 0.0f);
-			glTexCoord2f(0.0f, 1.0f); glVertex3f(   0.0f, 768.0f, 0.0f);
-			glTexCoord2f(0.0f, 0.0f); glVertex3f(   0.0f,   0.0f, 0.0f);
+			glTexCoord2f(s1, t0); glVertex3f(1024.0f,   0.0f, 0.0f);
+			glTexCoord2f(s1, t1); glVertex3f(1024.0f, 768.0f, 0.0f);
+			glTexCoord2f(s0, t1); glVertex3f(   0.0f, 768.0f, 0.0f);
+			glTexCoord2f(s0, t0); glVertex3f(   0.0f,   0.0f, 0.0f);
 		glEnd();
 
 		// Restore the model view matrix
 		glPopMatrix();
 
 		// Restore the projection matrix
-		glMatrixMode(GL_PROJECTION);
+		g_StateCache.matrixMode(GL_PROJECTION);
 		glPopMatrix();
 
 		// Use modelview mode
-		glMatrixMode(GL_MODELVIEW);
+		g_StateCache.matrixMode(GL_MODELVIEW);
 
 		// Restore settings
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glColor4f(1, 1, 1, 1);
-		glPopAttrib();
+		g_StateCache.pop();
 	}
 	else
 	{
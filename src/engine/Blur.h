@@ -35,18 +35,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Engine {
 
-class World;
-
 /**
-Blurs the screen
+Blurs the screen.
+The blur is a copy of a frame that has already been rendered, shrunk by
+box filtering its mipmaps, so its cost does not depend on the scene.
+Without mipmap generation, the copy is instead drawn shrunk into a corner
+of the back buffer and read back into a texture of the blurred image size.
 */
 class Blur
 {
 public:
 	/**
 	Constructs the Blur
-	@param width The width of the screen capture
-	@param height The height of the screen capture
+	@param width The width of the blurred image
+	@param height The height of the blurred image
 	*/
 	Blur(int width, int height);
 
@@ -58,15 +60,18 @@ public:
 
 	/**
 	Creates the Blur
-	@param width The width of the screen capture
-	@param height The height of the screen capture
+	@param width The width of the blurred image
+	@param height The height of the blurred image
 	*/
 	void create(int width, int height);
 
 	/** Destroys the Blur */
 	void destroy(void);
 
-	/** Capture the scene to a texture */
+	/**
+	Copies the back buffer to a texture, if a capture was requested.
+	Call once the scene has been drawn, but before anything is drawn over it.
+	*/
 	void capture(void);
 
 	/** Draw the captured scene as an overlay */
@@ -84,33 +89,55 @@ public:
 	/** Reaquire assets */
 	void reaquire(void);
 
-	/**
-	Sets the current zone for the Blur to re-render it as necessary
-	@param zone the current zone
-	*/
-	inline void setZone(World * zone)
-	{
-		this->zone = zone;
-	}
-
 	/** The blur is enabled as long as this is positive, non-zero */
 	float alphaBlur;
 
 private:
+	/**
+	Shrinks the captured frame into the shrunk texture, for when mipmaps
+	cannot be generated.  The frame is drawn into a corner of the back
+	buffer, copied out, and the corner is then put back from the capture.
+	*/
+	void shrink(void);
+
 	/** A handle to thetexture where the scene is captured */
 	GLuint scene;
 
+	/** A handle to the texture holding the shrunken frame, or zero when mipmaps are used */
+	GLuint shrunk;
+
+	/** Width of the frame within the shrunk texture */
+	int shrunkWidth;
+
+	/** Height of the frame within the shrunk texture */
+	int shrunkHeight;
+
 	/** A screen capture will be performed on the next frame */
 	bool update;
 
-	/** The texture width */
+	/** The blurred image width */
 	int BLUR_TEXTURE_WIDTH;
 
-	/** The texture height */
+	/** The blurred image height */
 	int BLUR_TEXTURE_HEIGHT;
 
-	/** The current zone */
-	World *zone;
+	/** Width of the capture texture, the screen width rounded up to a power of two */
+	int sceneWidth;
+
+	/** Height of the capture texture, the screen height rounded up to a power of two */
+	int sceneHeight;
+
+	/** Width of the captured screen */
+	int frameWidth;
+
+	/** Height of the captured screen */
+	int frameHeight;
+
+	/** Mipmap level closest to the blurred image size, or zero without mipmaps */
+	int blurLevel;
+
+	/** Whether the capture texture's mipmaps are generated by glGenerateMipmapEXT */
+	bool generateMipmapsByHand;
 };
 
 } //namespace Engine
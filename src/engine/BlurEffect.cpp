@@ -66,9 +66,13 @@ void BlurEffect::start(float timePeriod, COLOR color)
 	blur.doCapture();
 }
 
-void BlurEffect::draw(void)
+void BlurEffect::capture(void)
 {
 	blur.capture();
+}
+
+void BlurEffect::draw(void)
+{
 	blur.draw();
 }
 
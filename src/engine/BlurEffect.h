@@ -50,6 +50,12 @@ public:
 	*/
 	void start(float timePeriod, COLOR color);
 
+	/**
+	Captures the frame, if the blur effect was just started.
+	Call after drawing the world, but before drawing the GUI.
+	*/
+	void capture(void);
+
 	/** Draw the blur effect */
 	void draw(void);
 
@@ -65,15 +71,6 @@ public:
 	/** Reaquire assets */
 	void reaquire(void);
 
-	/**
-	Sets the current zone for the Blur to re-render it as necessary
-	@param zone the current zone
-	*/
-	void setZone(World * zone)
-	{
-		blur.setZone(zone);
-	}
-
 private:
 	/** Screen capture */
 	Blur blur;
@@ -68,6 +68,7 @@ ACTION_CODE KEY_EDITOR_ROTATE_DOWN	= INVALID_ACTION_CODE;
 ACTION_CODE KEY_EDITOR_ROTATE_LEFT	= INVALID_ACTION_CODE;
 ACTION_CODE KEY_EDITOR_ROTATE_RIGHT	= INVALID_ACTION_CODE;
 ACTION_CODE KEY_SCREENSHOT		= INVALID_ACTION_CODE;
+ACTION_CODE KEY_SCREENSHOT_BURST	= INVALID_ACTION_CODE;
 ACTION_CODE KEY_ENTER_EDITOR		= INVALID_ACTION_CODE;
 ACTION_CODE KEY_TEST			= INVALID_ACTION_CODE;
 ACTION_CODE KEY_TOGGLE_DEBUG_DATA	= INVALID_ACTION_CODE;
@@ -283,6 +284,7 @@ void Controller::buildActionNames(void)
 	KEY_EDITOR_ROTATE_LEFT	= createAction("Editor-Rotate-Left");
 	KEY_EDITOR_ROTATE_RIGHT	= createAction("Editor-Rotate-Right");
 	KEY_SCREENSHOT		= createAction("Screenshot");
+	KEY_SCREENSHOT_BURST	= createAction("Screenshot-Burst");
 	KEY_ENTER_EDITOR	= createAction("Editor");
 	KEY_TEST		= createAction("Test");
 	KEY_TOGGLE_DEBUG_DATA	= createAction("Toggle-Debug-Data");
@@ -307,6 +309,7 @@ void Controller::setDefaults(void)
 	addBinding(KEY_EDITOR_ROTATE_LEFT,	"Left");
 	addBinding(KEY_EDITOR_ROTATE_RIGHT,	"Right");
 	addBinding(KEY_SCREENSHOT,		    "F11");
+	addBinding(KEY_SCREENSHOT_BURST,	"F12");
 	addBinding(KEY_ENTER_EDITOR,		"F1");
 	addBinding(KEY_TEST,			    "Tab");
 	addBinding(KEY_TOGGLE_DEBUG_DATA,	"F2");
@@ -70,6 +70,7 @@ extern ACTION_CODE KEY_EDITOR_ROTATE_DOWN;
 extern ACTION_CODE KEY_EDITOR_ROTATE_LEFT;
 extern ACTION_CODE KEY_EDITOR_ROTATE_RIGHT;
 extern ACTION_CODE KEY_SCREENSHOT;
+extern ACTION_CODE KEY_SCREENSHOT_BURST;
 extern ACTION_CODE KEY_ENTER_EDITOR;
 extern ACTION_CODE KEY_TEST;
 extern ACTION_CODE KEY_TOGGLE_DEBUG_DATA;
@@ -0,0 +1,259 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _CULLING_BATCH_H_
+#define _CULLING_BATCH_H_
+
+#include "vec4.h"
+
+namespace Engine {
+
+class Frustum;
+
+/**
+Bounding spheres laid out as parallel arrays, so that a Frustum can test a
+whole batch in one tight loop (see Frustum::cull).
+
+Each sphere also remembers which plane rejected it the last time it was
+tested. Objects that were outside last frame are usually still outside the
+same plane, so that plane is tried first. The cache survives clear, so a
+batch that is refilled in the same order every frame keeps its coherency.
+
+With SSE, spheres are tested four at a time.  The cached planes are tried
+first only when all four spheres of a group were rejected last time, as
+testing all six planes costs the same for one survivor as for four.  The
+cache is always refreshed from the full test.
+*/
+class SphereBatch
+{
+	friend class Frustum;
+
+public:
+	/** Empties the batch, keeping the plane coherency cache */
+	void clear(void)
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+		radius.clear();
+		visible.clear();
+	}
+
+	/**
+	Adds a sphere to the batch
+	@param center Center of the sphere
+	@param r Radius of the sphere
+	@return index of the sphere within the batch
+	*/
+	size_t add(const vec3 &center, float r)
+	{
+		x.push_back(center.x);
+		y.push_back(center.y);
+		z.push_back(center.z);
+		radius.push_back(r);
+		visible.push_back(1);
+
+		if(lastPlane.size() < x.size())
+		{
+			lastPlane.push_back(NO_PLANE);
+		}
+
+		return x.size()-1;
+	}
+
+	/**
+	Gets the number of spheres in the batch
+	@return number of spheres
+	*/
+	size_t size(void) const
+	{
+		return x.size();
+	}
+
+	/**
+	Determines whether a sphere passed the last test
+	@param i Index of the sphere
+	@return true if the sphere lies at least partly within the frustum
+	*/
+	bool isVisible(size_t i) const
+	{
+		return visible[i] != 0;
+	}
+
+private:
+	/** Marks a sphere that was not rejected by any plane */
+	enum { NO_PLANE = 6 };
+
+	/** Sphere centers */
+	vector<float> x, y, z;
+
+	/** Sphere radii */
+	vector<float> radius;
+
+	/** Results of the last test */
+	vector<unsigned char> visible;
+
+	/** Plane that rejected each sphere last time, or NO_PLANE */
+	vector<unsigned char> lastPlane;
+};
+
+/**
+Axis-aligned bounding boxes laid out as parallel arrays, so that a Frustum
+can test a whole batch in one tight loop (see Frustum::cull). Boxes keep a
+plane coherency cache just like SphereBatch, and use it the same way in
+groups of four with SSE.
+*/
+class BoxBatch
+{
+	friend class Frustum;
+
+public:
+	/** Empties the batch, keeping the plane coherency cache */
+	void clear(void)
+	{
+		minX.clear();
+		minY.clear();
+		minZ.clear();
+		maxX.clear();
+		maxY.clear();
+		maxZ.clear();
+		visible.clear();
+	}
+
+	/**
+	Adds a box to the batch
+	@param boxMin Minimum corner of the box
+	@param boxMax Maximum corner of the box
+	@return index of the box within the batch
+	*/
+	size_t add(const vec3 &boxMin, const vec3 &boxMax)
+	{
+		minX.push_back(boxMin.x);
+		minY.push_back(boxMin.y);
+		minZ.push_back(boxMin.z);
+		maxX.push_back(boxMax.x);
+		maxY.push_back(boxMax.y);
+		maxZ.push_back(boxMax.z);
+		visible.push_back(1);
+
+		if(lastPlane.size() < minX.size())
+		{
+			lastPlane.push_back(NO_PLANE);
+		}
+
+		return minX.size()-1;
+	}
+
+	/**
+	Changes a box already in the batch
+	@param i Index of the box
+	@param boxMin Minimum corner of the box
+	@param boxMax Maximum corner of the box
+	*/
+	void set(size_t i, const vec3 &boxMin, const vec3 &boxMax)
+	{
+		minX[i] = boxMin.x;
+		minY[i] = boxMin.y;
+		minZ[i] = boxMin.z;
+		maxX[i] = boxMax.x;
+		maxY[i] = boxMax.y;
+		maxZ[i] = boxMax.z;
+	}
+
+	/**
+	Gets the center of a box
+	@param i Index of the box
+	@return center
+	*/
+	vec3 getCenter(size_t i) const
+	{
+		return vec3((minX[i]+maxX[i])*0.5f, (minY[i]+maxY[i])*0.5f, (minZ[i]+maxZ[i])*0.5f);
+	}
+
+	/**
+	Gets the minimum corner of a box
+	@param i Index of the box
+	@return minimum corner
+	*/
+	vec3 getMin(size_t i) const
+	{
+		return vec3(minX[i], minY[i], minZ[i]);
+	}
+
+	/**
+	Gets the maximum corner of a box
+	@param i Index of the box
+	@return maximum corner
+	*/
+	vec3 getMax(size_t i) const
+	{
+		return vec3(maxX[i], maxY[i], maxZ[i]);
+	}
+
+	/**
+	Gets the number of boxes in the batch
+	@return number of boxes
+	*/
+	size_t size(void) const
+	{
+		return minX.size();
+	}
+
+	/**
+	Determines whether a box passed the last test
+	@param i Index of the box
+	@return true if the box lies at least partly within the frustum
+	*/
+	bool isVisible(size_t i) const
+	{
+		return visible[i] != 0;
+	}
+
+private:
+	/** Marks a box that was not rejected by any plane */
+	enum { NO_PLANE = 6 };
+
+	/** Minimum corners */
+	vector<float> minX, minY, minZ;
+
+	/** Maximum corners */
+	vector<float> maxX, maxY, maxZ;
+
+	/** Results of the last test */
+	vector<unsigned char> visible;
+
+	/** Plane that rejected each box last time, or NO_PLANE */
+	vector<unsigned char> lastPlane;
+};
+
+} // namespace Engine
+
+#endif
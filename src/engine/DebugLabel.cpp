@@ -31,13 +31,34 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "stdafx.h"
 #include "MessageRouter.h"
 #include "world.h"
+#include "AnimationController.h"
+#include "MapChunk.h"
+#include "RenderQueue.h"
+#include "StateCache.h"
+#include "particle.h"
+#include "ParticleRenderer.h"
 #include "DebugLabel.h"
 
 namespace Engine {
 
 DebugLabel::DebugLabel(const vec2 &pos, Application &app)
 : LabelWidget("DebugLabel has not gathered stats yet", pos, white, FONT_SIZE_HUGE, app.fontLarge),
-  application(app)
+  application(app),
+  lastNameLookups(0),
+  lastFrameRequests(0),
+  lastFrameCacheHits(0),
+  lastMapDrawCalls(0),
+  lastQueueItems(0),
+  lastMaterialBinds(0),
+  lastSkippedBinds(0),
+  lastLightSetBinds(0),
+  lastStateCallsIssued(0),
+  lastStateCallsElided(0),
+  lastParticlesUpdated(0),
+  lastParticleBatches(0),
+  lastParticleBillboards(0),
+  lastShadowUpdates(0),
+  lastDeferredShadowUpdates(0)
 {
 	m_bVisible = true;
 }
@@ -53,6 +74,91 @@ void DebugLabel::update(float)
 			: "0 ";
 	}
 
+	const ActorSet &objects = application.getWorld().getObjects();
+
+	output += "\nAwake: " + itoa((int)objects.getNumAwake())
+	        + "  Asleep: " + itoa((int)objects.getNumAsleep());
+
+	const size_t nameLookups = AnimationController::getNumNameLookups();
+	output += "  Anim lookups: " + itoa((int)(nameLookups - lastNameLookups));
+	lastNameLookups = nameLookups;
+
+	const size_t frameRequests = AnimationSequence::getNumFrameRequests();
+	const size_t frameCacheHits = AnimationSequence::getNumFrameCacheHits();
+	output += "\nAnim frames: " + itoa((int)(frameRequests - lastFrameRequests))
+	        + "  Cache hits: " + itoa((int)(frameCacheHits - lastFrameCacheHits));
+	lastFrameRequests = frameRequests;
+	lastFrameCacheHits = frameCacheHits;
+
+	const RegionManager &regions = application.getWorld().getRegions();
+
+	output += "\nRegions: " + itoa((int)regions.getNumRegions())
+	        + "  Cells: " + itoa((int)regions.getNumOccupiedCells())
+	        + "  Tests: " + itoa((int)regions.getNumTests())
+	        + "  Events: " + itoa((int)regions.getNumEvents());
+
+	const size_t mapDrawCalls = MapChunk::getNumDrawCalls();
+	output += "\nMap draw calls: " + itoa((int)(mapDrawCalls - lastMapDrawCalls));
+	lastMapDrawCalls = mapDrawCalls;
+
+	const VisibleSet &visible = application.getWorld().getVisibleSet();
+
+	output += "\nVisible chunks: " + itoa((int)visible.getNumChunks())
+	        + "  Actors: " + itoa((int)visible.getNumActors())
+	        + "  Culling tests: " + itoa((int)visible.getNumCullingTests());
+
+	const size_t queueItems = RenderQueue::getNumItems();
+	const size_t materialBinds = RenderQueue::getNumMaterialBinds();
+	const size_t skippedBinds = RenderQueue::getNumSkippedBinds();
+	output += "\nQueued draws: " + itoa((int)(queueItems - lastQueueItems))
+	        + "  Material binds: " + itoa((int)(materialBinds - lastMaterialBinds))
+	        + "  Skipped: " + itoa((int)(skippedBinds - lastSkippedBinds));
+	lastQueueItems = queueItems;
+	lastMaterialBinds = materialBinds;
+	lastSkippedBinds = skippedBinds;
+
+	const size_t lightSetBinds = LightManager::getNumLightSetBinds();
+	output += "\nLight sets: " + itoa((int)application.getWorld().getLightManager().getNumLightSets())
+	        + "  Light set binds: " + itoa((int)(lightSetBinds - lastLightSetBinds));
+	lastLightSetBinds = lightSetBinds;
+
+	const size_t stateCallsIssued = StateCache::getNumIssued();
+	const size_t stateCallsElided = StateCache::getNumElided();
+	output += "\nGL state calls: " + itoa((int)(stateCallsIssued - lastStateCallsIssued))
+	        + "  Elided: " + itoa((int)(stateCallsElided - lastStateCallsElided));
+	lastStateCallsIssued = stateCallsIssued;
+	lastStateCallsElided = stateCallsElided;
+
+	const size_t particlesUpdated = ParticleSystem::getNumParticlesUpdated();
+	const size_t particleBatches = ParticleRenderer::getNumBatches();
+	const size_t particleBillboards = ParticleRenderer::getNumBillboards();
+	output += "\nParticles updated: " + itoa((int)(particlesUpdated - lastParticlesUpdated))
+	        + "  Drawn: " + itoa((int)(particleBillboards - lastParticleBillboards))
+	        + "  Batches: " + itoa((int)(particleBatches - lastParticleBatches));
+	lastParticlesUpdated = particlesUpdated;
+	lastParticleBatches = particleBatches;
+	lastParticleBillboards = particleBillboards;
+
+	const size_t shadowUpdates = ShadowManager::getNumUpdates();
+	const size_t deferredShadowUpdates = ShadowManager::getNumDeferredUpdates();
+	output += "\nShadow maps rendered: " + itoa((int)(shadowUpdates - lastShadowUpdates))
+	        + "  Deferred: " + itoa((int)(deferredShadowUpdates - lastDeferredShadowUpdates));
+	lastShadowUpdates = shadowUpdates;
+	lastDeferredShadowUpdates = deferredShadowUpdates;
+
+	const ActorFactory::mapTypeToPool &pools = getActorFactory().getPools();
+
+	for(ActorFactory::mapTypeToPool::const_iterator i = pools.begin(); i != pools.end(); ++i)
+	{
+		const ActorFactory::Pool &pool = i->second;
+
+		output += "\n" + pool.typeName
+		        + "  Live: " + itoa((int)pool.live)
+		        + "  High: " + itoa((int)pool.highWater)
+		        + "  Free: " + itoa((int)pool.released.size())
+		        + "  Reused: " + itoa((int)pool.reused);
+	}
+
 	setLabel(output);
 }
 
@@ -43,6 +43,51 @@ private:
 	/** The application is our source for all Debug info */
 	Application &application;
 
+	/** Animation name lookups counted as of the previous update */
+	size_t lastNameLookups;
+
+	/** Interpolated animation frames requested as of the previous update */
+	size_t lastFrameRequests;
+
+	/** Animation frame cache hits as of the previous update */
+	size_t lastFrameCacheHits;
+
+	/** Map chunk draw calls counted as of the previous update */
+	size_t lastMapDrawCalls;
+
+	/** Render queue items counted as of the previous update */
+	size_t lastQueueItems;
+
+	/** Render queue material binds counted as of the previous update */
+	size_t lastMaterialBinds;
+
+	/** Render queue skipped binds counted as of the previous update */
+	size_t lastSkippedBinds;
+
+	/** Light set binds counted as of the previous update */
+	size_t lastLightSetBinds;
+
+	/** GL state calls issued as of the previous update */
+	size_t lastStateCallsIssued;
+
+	/** GL state calls elided as of the previous update */
+	size_t lastStateCallsElided;
+
+	/** Particles updated as of the previous update */
+	size_t lastParticlesUpdated;
+
+	/** Particle batches drawn as of the previous update */
+	size_t lastParticleBatches;
+
+	/** Particle billboards drawn as of the previous update */
+	size_t lastParticleBillboards;
+
+	/** Shadow maps rendered as of the previous update */
+	size_t lastShadowUpdates;
+
+	/** Shadow map renders deferred as of the previous update */
+	size_t lastDeferredShadowUpdates;
+
 public:
 	/**
 	Constructor
@@ -60,6 +60,11 @@ bool Detector::pollConditions(void) const
 	return true;
 }
 
+bool Detector::canSleep(void) const
+{
+	return signalFail == -1 && Trigger::canSleep();
+}
+
 void Detector::onDoesntTrigger(void)
 {
 	getZone().router.raiseSignal(signalFail);
@@ -77,6 +82,8 @@ void Detector::update(float deltaTime)
 {
 	Actor::update(deltaTime);
 
+	updateRegion();
+
 	if(pollConditions())
 	{
 		if(!debounce || disallowBounce==false)
@@ -65,9 +65,25 @@ protected:
 	*/
 	virtual bool pollConditions(void) const;
 
+	/**
+	Detectors always trip and so they have no region
+	@return REGION_OCCUPANT_NONE
+	*/
+	virtual unsigned int getRegionMask(void) const
+	{
+		return REGION_OCCUPANT_NONE;
+	}
+
 	/** Called in the event of the Trigger activating */
 	virtual void onTrigger(void);
 
+	/**
+	A detector with a failure signal raises it on every tick that it is
+	not tripped, and so it may only sleep if it has none
+	@return true if the detector is idle
+	*/
+	virtual bool canSleep(void) const;
+
 	/** Called every frame the trigger doesn's activate */
 	virtual void onDoesntTrigger(void);
 
@@ -56,13 +56,30 @@ protected:
 	*/
 	virtual bool pollConditions(void) const
 	{
-		OBJECT_ID unused;
-
 		const ActorSet &objects = getZone().getObjects();
+		const vector<OBJECT_ID> &occupants = getRegionOccupants();
+
+		// Only actors near the detector at the last tick need to be considered
+		for(vector<OBJECT_ID>::const_iterator i = occupants.begin(); i != occupants.end(); ++i)
+		{
+			const Actor *a = objects.getPtr(*i);
 
-		ActorSet s = objects.typeFilter<T>();
+			if(a && instanceof(*a, T) && isInProximity(*i, triggerRadius))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
 
-		return isAnythingInProximity(s, unused, triggerRadius);
+	/**
+	The region admits any creature; occupants are filtered by type when polled
+	@return REGION_OCCUPANT_ANY
+	*/
+	virtual unsigned int getRegionMask(void) const
+	{
+		return REGION_OCCUPANT_ANY;
 	}
 
 public:
@@ -31,6 +31,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "stdafx.h"
 #include "EffectManager.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "Dimmer.h"
 
 namespace Engine { 
@@ -44,19 +45,19 @@ void Dimmer::draw(void) const
 {
 	if(alphaBlur > FLT_EPSILON)
 	{
-		glPushAttrib(GL_ENABLE_BIT);
+		g_StateCache.push();
 
 		glColor4f(0, 0, 0, alphaBlur);
-		glDisable(GL_LIGHTING);
-		glDisable(GL_FOG);
-		glDisable(GL_DEPTH_TEST);
-		glDisable(GL_TEXTURE_2D);
+		g_StateCache.disable(GL_LIGHTING);
+		g_StateCache.disable(GL_FOG);
+		g_StateCache.disable(GL_DEPTH_TEST);
+		g_StateCache.disable(GL_TEXTURE_2D);
 
-		glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+		g_StateCache.enable(GL_BLEND);
+        g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE);
 		
 		// Save the projection matrix
-		glMatrixMode(GL_PROJECTION);
+		g_StateCache.matrixMode(GL_PROJECTION);
 		glPushMatrix();
 
 		// Set up the projection matrix for 2D
@@ -64,7 +65,7 @@ void Dimmer::draw(void) const
 		glOrtho(0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f);
 
 		// Save the model view matrix
-		glMatrixMode(GL_MODELVIEW);
+		g_StateCache.matrixMode(GL_MODELVIEW);
 		glPushMatrix();
 
 		// Set up the model view matrix
@@ -83,16 +84,16 @@ void Dimmer::draw(void) const
 		glPopMatrix();
 
 		// Restore the projection matrix
-		glMatrixMode(GL_PROJECTION);
+		g_StateCache.matrixMode(GL_PROJECTION);
 		glPopMatrix();
 
 		// Use modelview mode
-		glMatrixMode(GL_MODELVIEW);
+		g_StateCache.matrixMode(GL_MODELVIEW);
 		
 		// Restore settings
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glColor4fv(white);
-		glPopAttrib();	
+		g_StateCache.pop();	
 	}
 	else
 	{
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "3dmath.h"
 #include "SDLwindow.h"
 #include "Application.h"
@@ -217,12 +218,12 @@ void EditorToolBar::drawInWorldSpace(void) const
 	vec3 a = mousePos + up*4.0f;
 	vec3 b = mousePos - up*4.0f;
 
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-		glDisable(GL_TEXTURE_2D);
-		glDisable(GL_LIGHTING);
-		glDisable(GL_BLEND);
-		glEnable(GL_LINE_SMOOTH);
+		g_StateCache.disable(GL_TEXTURE_2D);
+		g_StateCache.disable(GL_LIGHTING);
+		g_StateCache.disable(GL_BLEND);
+		g_StateCache.enable(GL_LINE_SMOOTH);
 		glLineWidth(3);
 		glColor4fv(red);
 
@@ -231,7 +232,10 @@ void EditorToolBar::drawInWorldSpace(void) const
 			glVertex3f(b.x, b.y, b.z);
 		glEnd();
 
-	glPopAttrib();
+		glLineWidth(1);
+		glColor4fv(white);
+
+	g_StateCache.pop();
 }
 
 TILE_TYPE EditorToolBar::getTileType(void) const
@@ -345,9 +349,6 @@ void EditorToolBar::update(float deltaTime)
 									  tileEditor_wallTextureFile,
 							          tileEditor_height);
 
-						// Rebuild the map display list
-						map.reaquire();
-
 						g_SoundSystem.play("data/sound/activate.wav");
 					}
 				}
@@ -481,6 +482,7 @@ void EditorToolBar::createNewMap(void)
 	Map &map = world->getMap();
 
 	map.makeNewMap();
+	world->getRegions().create(map);
 
 	// Delete all objects
 	objects.destroy();
@@ -511,10 +513,10 @@ string EditorToolBar::chooseNextObject(void)
 
 vec3 EditorToolBar::getGroundPickPos(float elevation) const
 {
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPushMatrix();
 
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glPushMatrix();
 	glLoadIdentity();
 	g_Camera.setCamera();
@@ -566,10 +568,10 @@ vec3 EditorToolBar::getGroundPickPos(float elevation) const
 
 
 
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPopMatrix();
 
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glPopMatrix();
 
 
@@ -760,8 +762,8 @@ void EditorToolBar::onLeftMouseDown()
                                   map);
 #endif
 
-				// Rebuild the map display list
-				map.reaquire();
+				// Rebuild the chunks around the tile
+				map.invalidateTile(groundPos.x, groundPos.z);
 
 				g_SoundSystem.play("data/sound/click.wav");
 			}
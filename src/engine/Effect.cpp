@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "Effect.h"
 
 
@@ -37,33 +38,8 @@ namespace Engine {
 
 void Effect::setTextureFilters(void)
 {
-	switch(g_Application.textureFilter)
-	{
-	case 2: // aniostropic
-		if(supportsAniostropy)
-		{
-			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, g_Application.aniostropy);
-		}
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		break;
-
-	case 1: // trilinear
-		if(supportsAniostropy)
-		{
-			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, 1.0f); // disables aniostropic filtering
-		}
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		break;
-
-	default: // bilinear
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-		break;
-	};
+	// The state cache remembers the filters of each texture
+	g_StateCache.applyTextureFilters();
 }
 
 void Effect::disableAllTextureUnits(void)
@@ -73,14 +49,14 @@ void Effect::disableAllTextureUnits(void)
 
 	for(int i=0; i<g_MultitextureUnits; ++i)
 	{
-		glActiveTextureARB(textureStages[i]);
-		glDisable(GL_TEXTURE_2D);
+		g_StateCache.activeTexture(textureStages[i]);
+		g_StateCache.disable(GL_TEXTURE_2D);
 	}
 
 	for(int i=0; i<g_MultitextureUnits; ++i)
 	{
-		glClientActiveTextureARB(textureStages[i]);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		g_StateCache.clientActiveTexture(textureStages[i]);
+		g_StateCache.disableClientState(GL_TEXTURE_COORD_ARRAY);
 	}
 }
 
@@ -92,11 +68,11 @@ void Effect::disableExtraTextureUnits(void)
 	disableAllTextureUnits();
 
 	// Enable the primary texture unit
-	glActiveTextureARB(GL_TEXTURE0_ARB);
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.activeTexture(GL_TEXTURE0_ARB);
+	g_StateCache.enable(GL_TEXTURE_2D);
 
-	glClientActiveTextureARB(GL_TEXTURE0_ARB);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	g_StateCache.clientActiveTexture(GL_TEXTURE0_ARB);
+	g_StateCache.enableClientState(GL_TEXTURE_COORD_ARRAY);
 }
 
 Effect::Effect(void)
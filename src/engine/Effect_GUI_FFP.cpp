@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_GUI_FFP.h"
 
@@ -54,32 +55,32 @@ void Effect_GUI_FFP::clear(void)
 
 void Effect_GUI_FFP::begin(void)
 {
-	glPushAttrib(GL_ENABLE_BIT);
+	g_StateCache.push();
 
-	glDisable(GL_LIGHTING);
-	glDisable(GL_BLEND);
-	glDisable(GL_DEPTH_TEST);
+	g_StateCache.disable(GL_LIGHTING);
+	g_StateCache.disable(GL_BLEND);
+	g_StateCache.disable(GL_DEPTH_TEST);
 
 	// Enable alpha test for widgets
-	glEnable(GL_ALPHA_TEST);
-	glAlphaFunc(GL_GREATER, 0.10f);
+	g_StateCache.enable(GL_ALPHA_TEST);
+	g_StateCache.alphaFunc(GL_GREATER, 0.10f);
 
 	// Disable all texture units initially
 	if(g_bUseMultitexture)
 	{
 		for(int i=0; i<g_MultitextureUnits; ++i)
 		{
-			glActiveTextureARB(textureStages[i]);
-			glDisable(GL_TEXTURE_2D);
+			g_StateCache.activeTexture(textureStages[i]);
+			g_StateCache.disable(GL_TEXTURE_2D);
 		}
-		glActiveTextureARB(GL_TEXTURE0_ARB);
+		g_StateCache.activeTexture(GL_TEXTURE0_ARB);
 	}
 
 	// Select a white color by default
 	glColor4fv(white);
 
 	// Save the projection matrix
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPushMatrix();
 
 	// Set up the projection matrix for 2D
@@ -87,7 +88,7 @@ void Effect_GUI_FFP::begin(void)
 	glOrtho(0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f);
 
 	// Save the model view matrix
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glPushMatrix();
 
 	// Set up the model view matrix
@@ -99,16 +100,16 @@ void Effect_GUI_FFP::end(void)
 {
 
 	// Restore the projection matrix
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPopMatrix();
 
 	// Restore the model view matrix
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glPopMatrix();
 
 	//glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
-	glPopAttrib();
+	g_StateCache.pop();
 
 	CHECK_GL_ERROR();
 }
@@ -130,14 +131,14 @@ void Effect_GUI_FFP::passTextureName(unsigned int textureName, unsigned int text
 		// Select the primary texture unit
 		if(g_bUseMultitexture)
 		{
-			glActiveTextureARB(GL_TEXTURE0_ARB);
+			g_StateCache.activeTexture(GL_TEXTURE0_ARB);
 		}
 
 		// Bind the texture
-		glBindTexture(GL_TEXTURE_2D, textureName);
+		g_StateCache.bindTexture(textureName);
 
 		// Finally, ensure the texture is enabled
-		glEnable(GL_TEXTURE_2D);
+		g_StateCache.enable(GL_TEXTURE_2D);
 	}
 }
 
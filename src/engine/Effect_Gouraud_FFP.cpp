@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_Gouraud_FFP.h"
 
@@ -54,21 +55,21 @@ void Effect_Gouraud_FFP::clear(void)
 
 void Effect_Gouraud_FFP::begin(void)
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
 	glColor4fv(white);
-	glEnable(GL_LIGHTING);
-	glEnable(GL_CULL_FACE);
+	g_StateCache.enable(GL_LIGHTING);
+	g_StateCache.enable(GL_CULL_FACE);
 
 	Effect::disableExtraTextureUnits();
 
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_NORMAL_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_NORMAL_ARRAY);
 }
 
 void Effect_Gouraud_FFP::end(void)
 {
-	glPopAttrib();
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
@@ -87,18 +88,18 @@ void Effect_Gouraud_FFP::passTextureName(unsigned int textureName, unsigned int
 	// Select the primary texture unit
 	if(g_bUseMultitexture)
 	{
-		glActiveTextureARB(textureStages[textureUnit]);
-		glEnable(GL_TEXTURE_2D);
+		g_StateCache.activeTexture(textureStages[textureUnit]);
+		g_StateCache.enable(GL_TEXTURE_2D);
 	}
 
 	// Set the texture filtering according to global performance settings
 	Effect::setTextureFilters();
 
 	// Bind the texture
-	glBindTexture(GL_TEXTURE_2D, textureName);
+	g_StateCache.bindTexture(textureName);
 
 	// Finally, ensure the texture is enabled
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.enable(GL_TEXTURE_2D);
 }
 
 void Effect_Gouraud_FFP::passVertexStream(float *stream)
@@ -115,7 +116,7 @@ void Effect_Gouraud_FFP::passTexCoordStream(float *stream, unsigned int textureU
 {
 	if(g_bUseMultitexture)
 	{
-		glClientActiveTextureARB(textureStages[textureUnit]);
+		g_StateCache.clientActiveTexture(textureStages[textureUnit]);
 	}
 
 	glTexCoordPointer(2, GL_FLOAT, 0, stream);
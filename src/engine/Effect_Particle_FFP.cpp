@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_Particle_FFP.h"
 
@@ -54,25 +55,25 @@ void Effect_Particle_FFP::clear(void)
 
 void Effect_Particle_FFP::begin(void)
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
 	glColor4fv(white);
 
-	glDisable(GL_LIGHTING);
+	g_StateCache.disable(GL_LIGHTING);
 
 	// Transparency
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-	glEnable(GL_BLEND);
+	g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE);
+	g_StateCache.enable(GL_BLEND);
 
 	Effect::disableExtraTextureUnits();
 
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_NORMAL_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_NORMAL_ARRAY);
 }
 
 void Effect_Particle_FFP::end(void)
 {
-	glPopAttrib();
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
@@ -90,11 +91,11 @@ void Effect_Particle_FFP::passTextureName(unsigned int textureName, unsigned int
 {
 	if(g_bUseMultitexture)
 	{
-		glActiveTextureARB(textureStages[textureUnit]);
+		g_StateCache.activeTexture(textureStages[textureUnit]);
 	}
 
-	glBindTexture(GL_TEXTURE_2D, textureName);
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.bindTexture(textureName);
+	g_StateCache.enable(GL_TEXTURE_2D);
 }
 
 void Effect_Particle_FFP::passVertexStream(float *stream)
@@ -111,7 +112,7 @@ void Effect_Particle_FFP::passTexCoordStream(float *stream, unsigned int texture
 {
 	if(g_bUseMultitexture)
 	{
-		glClientActiveTextureARB(textureStages[textureUnit]);
+		g_StateCache.clientActiveTexture(textureStages[textureUnit]);
 	}
 
 	glTexCoordPointer(2, GL_FLOAT, 0, stream);
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_Project_Shadows.h"
 
@@ -51,19 +52,19 @@ void Effect_Project_Shadows::clear(void)
 
 void Effect_Project_Shadows::begin(void)
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glEnableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
 
-	glColorMask(0, 0, 0, 0);
+	g_StateCache.colorMask(0, 0, 0, 0);
 
-	glDisable(GL_LIGHTING);
+	g_StateCache.disable(GL_LIGHTING);
 
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_FRONT);
+	g_StateCache.enable(GL_CULL_FACE);
+	g_StateCache.cullFace(GL_FRONT);
 
 	// Use a depth offset to correct Z-aliasing
-	glEnable(GL_POLYGON_OFFSET_FILL);
+	g_StateCache.enable(GL_POLYGON_OFFSET_FILL);
 	glPolygonOffset(3, 3);
 
 	// Disable textures we don't need
@@ -72,7 +73,7 @@ void Effect_Project_Shadows::begin(void)
 
 void Effect_Project_Shadows::end(void)
 {
-	glPopAttrib();
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
@@ -30,12 +30,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_Receive_Shadows.h"
 
 namespace Engine {
 
-static float shadowAlphaThreshold = 0.90f;
+const float Effect_Receive_Shadows::ALPHA_THRESHOLD = 0.90f;
 
 Effect_Receive_Shadows::Effect_Receive_Shadows(void)
 {
@@ -53,23 +54,23 @@ void Effect_Receive_Shadows::clear(void)
 
 void Effect_Receive_Shadows::begin(void)
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glEnable(GL_LIGHTING);
+	g_StateCache.enable(GL_LIGHTING);
 
 	// Discard fragments that fail the shadow test
-	glEnable(GL_ALPHA_TEST);
-	glAlphaFunc(GL_GEQUAL, shadowAlphaThreshold);
+	g_StateCache.enable(GL_ALPHA_TEST);
+	g_StateCache.alphaFunc(GL_GEQUAL, ALPHA_THRESHOLD);
 
 	Effect::disableExtraTextureUnits();
 
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_NORMAL_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_NORMAL_ARRAY);
 }
 
 void Effect_Receive_Shadows::end(void)
 {
-	glPopAttrib();
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
@@ -85,10 +86,10 @@ int Effect_Receive_Shadows::getRequiredTextureUnits(void) const
 
 void Effect_Receive_Shadows::passTextureName(unsigned int textureName, unsigned int textureUnit)
 {
-	glActiveTextureARB(textureStages[textureUnit]);
+	g_StateCache.activeTexture(textureStages[textureUnit]);
 	Effect::setTextureFilters();
-	glBindTexture(GL_TEXTURE_2D, textureName);
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.bindTexture(textureName);
+	g_StateCache.enable(GL_TEXTURE_2D);
 }
 
 void Effect_Receive_Shadows::passVertexStream(float *stream)
@@ -105,7 +106,7 @@ void Effect_Receive_Shadows::passTexCoordStream(float *stream, unsigned int text
 {
 	if(g_bUseMultitexture)
 	{
-		glClientActiveTextureARB(textureStages[textureUnit]);
+		g_StateCache.clientActiveTexture(textureStages[textureUnit]);
 	}
 
 	glTexCoordPointer(2, GL_FLOAT, 0, stream);
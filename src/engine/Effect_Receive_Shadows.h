@@ -38,6 +38,9 @@ namespace Engine {
 class Effect_Receive_Shadows : public Effect
 {
 public:
+	/** Fragments whose shadow test alpha is below this are in shadow */
+	static const float ALPHA_THRESHOLD;
+
 	/** Default constructor */
 	Effect_Receive_Shadows(void);
 
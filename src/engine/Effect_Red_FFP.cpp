@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_Red_FFP.h"
 
@@ -54,25 +55,25 @@ void Effect_Red_FFP::clear(void)
 
 void Effect_Red_FFP::begin(void)
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glDisable(GL_LIGHTING);
-	glDisable(GL_BLEND);
-	glDisable(GL_ALPHA_TEST);
+	g_StateCache.disable(GL_LIGHTING);
+	g_StateCache.disable(GL_BLEND);
+	g_StateCache.disable(GL_ALPHA_TEST);
 
 	// Disable textures we don't need
 	if(g_bUseMultitexture)
 	{
 		for(int i=getRequiredTextureUnits(); i<g_MultitextureUnits; ++i)
 		{
-			glActiveTextureARB(textureStages[i]);
-			glDisable(GL_TEXTURE_2D);
+			g_StateCache.activeTexture(textureStages[i]);
+			g_StateCache.disable(GL_TEXTURE_2D);
 		}
-		glActiveTextureARB(GL_TEXTURE0_ARB);
+		g_StateCache.activeTexture(GL_TEXTURE0_ARB);
 	}
 
 	// Set the appropriate client states
-	glEnableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
 
 	// Select a red color
 	glColor4fv(red);
@@ -81,7 +82,8 @@ void Effect_Red_FFP::begin(void)
 void Effect_Red_FFP::end(void)
 {
 	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-	glPopAttrib();
+	glColor4fv(white);
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
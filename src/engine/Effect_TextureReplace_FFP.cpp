@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_TextureReplace_FFP.h"
 
@@ -56,18 +57,18 @@ void Effect_TextureReplace_FFP::begin(void)
 {
 	CHECK_GL_ERROR();
 
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glDisable(GL_LIGHTING);
-	glDisable(GL_BLEND);
-	glCullFace(GL_BACK);
+	g_StateCache.disable(GL_LIGHTING);
+	g_StateCache.disable(GL_BLEND);
+	g_StateCache.cullFace(GL_BACK);
 	Effect::disableExtraTextureUnits();
-	glEnableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
 }
 
 void Effect_TextureReplace_FFP::end(void)
 {
-	glPopAttrib();
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
@@ -87,11 +88,11 @@ void Effect_TextureReplace_FFP::passTextureName(unsigned int textureName, unsign
 	{
 		if(g_bUseMultitexture)
 		{
-			glActiveTextureARB(GL_TEXTURE0_ARB);
+			g_StateCache.activeTexture(GL_TEXTURE0_ARB);
 		}
 
-		glBindTexture(GL_TEXTURE_2D, textureName);
-		glEnable(GL_TEXTURE_2D);
+		g_StateCache.bindTexture(textureName);
+		g_StateCache.enable(GL_TEXTURE_2D);
 	}
 }
 
@@ -109,7 +110,7 @@ void Effect_TextureReplace_FFP::passTexCoordStream(float *stream, unsigned int t
 {
 	if(g_bUseMultitexture)
 	{
-		glClientActiveTextureARB(textureStages[textureUnit]);
+		g_StateCache.clientActiveTexture(textureStages[textureUnit]);
 	}
 
 	glTexCoordPointer(2, GL_FLOAT, 0, stream);
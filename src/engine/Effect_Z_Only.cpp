@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "PropertyBag.h"
 #include "Effect_Z_Only.h"
 
@@ -51,17 +52,17 @@ void Effect_Z_Only::clear(void)
 
 void Effect_Z_Only::begin(void)
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glColorMask(0, 0, 0, 0);
-	glDisable(GL_LIGHTING);
+	g_StateCache.colorMask(0, 0, 0, 0);
+	g_StateCache.disable(GL_LIGHTING);
 	Effect::disableAllTextureUnits();
-	glEnableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
 }
 
 void Effect_Z_Only::end(void)
 {
-	glPopAttrib();
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
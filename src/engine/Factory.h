@@ -62,6 +62,18 @@ template<class TYPE, class SUB_TYPE> TYPE* allocatorFn(OBJECT_ID handle)
 	return new SUB_TYPE(handle);
 }
 
+/** Readies a pooled object to be held by the pool until it is reused */
+template<class TYPE> void retireFn(TYPE *o)
+{
+	o->retire();
+}
+
+/** Readies a pooled object to be used again under a new handle */
+template<class TYPE> void reuseFn(TYPE *o, OBJECT_ID handle)
+{
+	o->reuse(handle);
+}
+
 /**
 Factory pattern generator.
 Allocates specific objects when passed the type name of the desired object.
@@ -75,6 +87,36 @@ public:
 	typedef TYPE* (*AllocatorFn)(OBJECT_ID);
 	typedef map < OBJECT_ID, TYPE* > mapHandleToObject;
 
+	/** Recycles released objects of a single type */
+	struct Pool
+	{
+		/** Name of the pooled type */
+		string typeName;
+
+		/** Released objects awaiting reuse */
+		vector<TYPE*> released;
+
+		/** Maximum number of released objects to hold */
+		size_t capacity;
+
+		/** Number of objects of the type in use */
+		size_t live;
+
+		/** Greatest number of objects of the type in use at once */
+		size_t highWater;
+
+		/** Number of objects that were reused rather than allocated */
+		size_t reused;
+
+		/** Readies an object to be held by the pool */
+		void (*retire)(TYPE*);
+
+		/** Readies a held object for reuse */
+		void (*reuse)(TYPE*, OBJECT_ID);
+	};
+
+	typedef map < OBJECT_TYPE, Pool > mapTypeToPool;
+
 	/** Stores objects that have been allocated */
 	mapHandleToObject objects;
 
@@ -92,6 +134,9 @@ private:
 	/** Maps from the type to the allocator function */
 	mapTypeToAlloc toAllocator;
 
+	/** Maps from the type to its pool, for pooled types */
+	mapTypeToPool pools;
+
 public:
 	/** Default constructor */
 	Factory(void)
@@ -111,16 +156,82 @@ public:
 			delete(objects.begin()->second);
 			erase(objects.begin());
 		}
+
+		for(typename mapTypeToPool::iterator i = pools.begin(); i != pools.end(); ++i)
+		{
+			vector<TYPE*> &released = i->second.released;
+
+			while(!released.empty())
+			{
+				delete(released.back());
+				released.pop_back();
+			}
+		}
 	}
 
 	/**
-	Removes a single object from the database
+	Removes a single object from the database.
+	Objects of a pooled type are held for reuse while the pool has room.
 	@param handle ID of the object to delete
 	*/
 	void remove(OBJECT_ID handle)
 	{
-		delete(objects.find(handle)->second);
-		objects.erase(objects.find(handle));
+		typename mapHandleToObject::iterator iter = objects.find(handle);
+		TYPE *o = iter->second;
+		objects.erase(iter);
+
+		if(!pools.empty())
+		{
+			typename mapTypeToPool::iterator p = pools.find((OBJECT_TYPE)(&typeid(*o)));
+
+			if(p != pools.end())
+			{
+				Pool &pool = p->second;
+
+				if(pool.live > 0)
+					pool.live--;
+
+				if(pool.released.size() < pool.capacity)
+				{
+					pool.retire(o);
+					pool.released.push_back(o);
+					return;
+				}
+			}
+		}
+
+		delete(o);
+	}
+
+	/**
+	Recycles objects of a registered type through a pool, rather than
+	deleting and allocating them anew.  Pooled types must implement
+	retire() and reuse(OBJECT_ID).
+	@param capacity Maximum number of released objects to hold
+	*/
+	template<class T>
+	void enablePool(size_t capacity)
+	{
+		const OBJECT_TYPE typeID = (OBJECT_TYPE)(&typeid(T));
+
+		Pool &pool = pools[typeID];
+		pool.typeName = T::getTypeString();
+		pool.capacity = capacity;
+		pool.live = 0;
+		pool.highWater = 0;
+		pool.reused = 0;
+		pool.retire = &::Engine::retireFn<TYPE>;
+		pool.reuse = &::Engine::reuseFn<TYPE>;
+		pool.released.reserve(capacity);
+	}
+
+	/**
+	Gets the pools, for reporting
+	@return pools, by type
+	*/
+	const mapTypeToPool& getPools(void) const
+	{
+		return pools;
 	}
 
 	/**
@@ -190,8 +301,31 @@ public:
 		OBJECT_ID handle = uniqueID;
 		uniqueID++;
 
-		TYPE *o = (toAllocator.find(type)->second)(handle);
-		ASSERT(o!=0, "Allocator failed");
+		TYPE *o = 0;
+
+		typename mapTypeToPool::iterator p = pools.find(type);
+
+		if(p != pools.end())
+		{
+			Pool &pool = p->second;
+
+			pool.live++;
+			pool.highWater = max(pool.highWater, pool.live);
+
+			if(!pool.released.empty())
+			{
+				o = pool.released.back();
+				pool.released.pop_back();
+				pool.reuse(o, handle);
+				pool.reused++;
+			}
+		}
+
+		if(o == 0)
+		{
+			o = (toAllocator.find(type)->second)(handle);
+			ASSERT(o!=0, "Allocator failed");
+		}
 
 		objects.insert(make_pair(handle, o));
 
@@ -71,6 +71,13 @@ void GameStateRun::update(float deltaTime)
 	// draw
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 	application.getWorld().draw();
+
+	// The blur reuses the frame as drawn so far
+	if(application.useBlurEffects)
+	{
+		blurEffect.capture();
+	}
+
 	dim.draw();
 	g_GUI.draw();
 
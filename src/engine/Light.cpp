@@ -153,35 +153,55 @@ void Light::bind(unsigned int lightName) const
 	}
 }
 
+float Light::getIntensity(float distance) const
+{
+	const float attenuation = constantAttenuation
+	                        + linearAttenuation * distance
+	                        + quadraticAttenuation * distance * distance;
+
+	const float brightness = BRIGHTNESS * max(diffuse.r, max(diffuse.g, diffuse.b));
+
+	return (attenuation > FLT_EPSILON) ? (brightness / attenuation) : FLT_MAX;
+}
+
+float Light::getInfluenceRadius(void) const
+{
+	// Contributions fainter than this are lost against the ambient light
+	const float cutoff = 1.0f / 64.0f;
+
+	const float brightness = BRIGHTNESS * max(diffuse.r, max(diffuse.g, diffuse.b));
+
+	// Solve for the distance at which the attenuated brightness meets the cutoff
+	const float c = constantAttenuation - brightness / cutoff;
+
+	if(c >= 0.0f)
+	{
+		return 0.0f; // never brighter than the cutoff
+	}
+	else if(quadraticAttenuation > FLT_EPSILON)
+	{
+		const float b = linearAttenuation;
+		const float a = quadraticAttenuation;
+		return (-b + sqrtf(b*b - 4.0f*a*c)) / (2.0f*a);
+	}
+	else if(linearAttenuation > FLT_EPSILON)
+	{
+		return -c / linearAttenuation;
+	}
+	else
+	{
+		return -1.0f; // no attenuation at all
+	}
+}
+
 void Light::calculateMatrices(void)
 {
 	const vec4 lightCenter = lightPosition - lightDirection;
 	const vec4 lightUp = vec4(0, 1, 0, 1);
 
-	// save old matrices
-	glMatrixMode(GL_PROJECTION);
-	glPushMatrix();
-
-	glMatrixMode(GL_MODELVIEW);
-	glPushMatrix();
-
-		// Shadow matrices			
-		glLoadIdentity();
-		gluPerspective(spotAngle, 1.f, .1f, 50.f);
-		glGetFloatv(GL_MODELVIEW_MATRIX, lightProjectionMatrix);
-		
-		glLoadIdentity();
-		gluLookAt(	lightPosition.x, lightPosition.y,	lightPosition.z,
-					lightCenter.x,	 lightCenter.y,		lightCenter.z,
-					lightUp.x,		 lightUp.y,			lightUp.z);
-		glGetFloatv(GL_MODELVIEW_MATRIX, lightViewMatrix);
-	
-	// restore old matrices
-	glMatrixMode(GL_MODELVIEW);
-	glPopMatrix();
-
-	glMatrixMode(GL_PROJECTION);
-	glPopMatrix();
+	// Shadow matrices
+	lightProjectionMatrix.perspective(spotAngle, 1.f, .1f, 50.f);
+	lightViewMatrix.lookAt(lightPosition, lightCenter, lightUp);
 
 	frustum.CalculateFrustum(lightViewMatrix, lightProjectionMatrix);
 }
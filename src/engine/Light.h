@@ -177,6 +177,19 @@ public:
 	*/
 	void bind(unsigned int lightName) const;
 
+	/**
+	Gets the brightness of the Light after attenuation over some distance
+	@param distance Distance from the Light
+	@return brightness, relative to the unattenuated Light
+	*/
+	float getIntensity(float distance) const;
+
+	/**
+	Gets the distance beyond which the Light's contribution is too faint to matter
+	@return radius of influence, or a negative value if the Light never fades out
+	*/
+	float getInfluenceRadius(void) const;
+
 	/**
 	Gets the Light direction for the spot Light.
 	If the Light is not a spot Light, then this is meaningless.
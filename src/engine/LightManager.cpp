@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "frustum.h"
 #include "world.h"
 #include "player.h"
@@ -38,7 +39,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace Engine {
 
 
-GLenum lightNames[7] =
+GLenum lightNames[LightManager::MAX_LIGHTS] =
 {
 	GL_LIGHT1,
 	GL_LIGHT2,
@@ -49,14 +50,23 @@ GLenum lightNames[7] =
 	GL_LIGHT7,
 };
 
+/** Meters along each side of a cell of the light grid */
+const float LIGHT_CELL_SIZE = 16.0f;
 
+/** Lights that would cover more cells than this are treated as reaching everything */
+const int LIGHT_MAX_CELLS = 64;
 
+size_t LightManager::numLightSetBinds = 0;
 
 void LightManager::clear(void)
 {
 	periodicTimer = 0.0f;
 	newHandle = 1000;
 	lights.clear();
+	activeSet.clear();
+	grid.clear();
+	unboundedLights.clear();
+	resetLightSets();
 }
 
 void LightManager::destroy(void)
@@ -77,7 +87,9 @@ HLIGHT LightManager::addLight(Light *light)
 
 	newHandle++;
 	lights.insert(make_pair(newHandle, light));
+	rebuildGrid();
 	computeActiveSet();
+	resetLightSets();
 	return newHandle;
 }
 
@@ -86,7 +98,9 @@ void LightManager::removeLight(HLIGHT handle)
 	if(lights.find(handle) != lights.end())
 	{
 		lights.erase(handle);
+		rebuildGrid();
 		computeActiveSet();
+		resetLightSets();
 	}
 }
 
@@ -115,6 +129,9 @@ vector<const Light*> LightManager::getActiveSet(void) const
 
 void LightManager::update(float deltaTime)
 {
+	// Lights move about, so they are filed in the grid again every frame
+	rebuildGrid();
+
 	// Periodically update the active set
 	periodicTimer -= deltaTime;
 	if(periodicTimer < 0)
@@ -122,52 +139,200 @@ void LightManager::update(float deltaTime)
 		periodicTimer = 1000.0f;
 		computeActiveSet();
 	}
+
+	resetLightSets();
 }
 
 void LightManager::computeActiveSet(void)
 {
-	priority_queue< pair<float,const Light*>, vector< pair<float,const Light*> >, less< pair<float,const Light*> > > q;
-
 	const Player &player = g_Application.getWorld().getPlayer(0);
 	const vec3 playerPos = player.getPos() + vec3(0, player.getSphereRadius(), 0);
 
+	LightSet nearby;
+	collectLights(playerPos, 0.0f, nearby);
+
+	// Order the lights that reach the player from nearest to farthest
+	vector< pair<float,const Light*> > byDistance;
+
+	for(LightSet::const_iterator i=nearby.begin(); i!=nearby.end(); ++i)
+	{
+		byDistance.push_back(make_pair(vec3(playerPos-(*i)->getPosition()).getMagnitude(), *i));
+	}
+
+	sort(byDistance.begin(), byDistance.end());
+
+	activeSet.clear(); // reset
+	for(size_t i=0; i<byDistance.size(); ++i)
+	{
+		activeSet.push_back(byDistance[i].second);
+	}
+}
+
+void LightManager::rebuildGrid(void)
+{
+	grid.clear();
+	unboundedLights.clear();
+
 	for(LIGHTS::const_iterator iter=lights.begin(); iter!=lights.end(); ++iter)
 	{
 		const Light *light = iter->second;
 
 		// Only consider lights that are allowed to be enabled
-		if(light->enable)
+		if(!light->enable)
+			continue;
+
+		const float radius = light->getInfluenceRadius();
+		const vec3 &position = light->getPosition();
+
+		if(radius < 0.0f)
 		{
-			q.push(make_pair(vec3(playerPos-light->getPosition()).getMagnitude(), light));
+			unboundedLights.push_back(light);
+			continue;
+		}
+
+		const int minX = (int)floorf((position.x - radius) / LIGHT_CELL_SIZE);
+		const int minZ = (int)floorf((position.z - radius) / LIGHT_CELL_SIZE);
+		const int maxX = (int)floorf((position.x + radius) / LIGHT_CELL_SIZE);
+		const int maxZ = (int)floorf((position.z + radius) / LIGHT_CELL_SIZE);
+
+		if((maxX-minX+1) * (maxZ-minZ+1) > LIGHT_MAX_CELLS)
+		{
+			unboundedLights.push_back(light);
+			continue;
+		}
+
+		for(int z=minZ; z<=maxZ; ++z)
+		{
+			for(int x=minX; x<=maxX; ++x)
+			{
+				grid[make_pair(x, z)].push_back(light);
+			}
 		}
 	}
+}
 
-	activeSet.clear(); // reset
-	while(!q.empty())
+void LightManager::collectLights(const vec3 &center, float radius, LightSet &lights) const
+{
+	lights.clear();
+
+	const int minX = (int)floorf((center.x - radius) / LIGHT_CELL_SIZE);
+	const int minZ = (int)floorf((center.z - radius) / LIGHT_CELL_SIZE);
+	const int maxX = (int)floorf((center.x + radius) / LIGHT_CELL_SIZE);
+	const int maxZ = (int)floorf((center.z + radius) / LIGHT_CELL_SIZE);
+
+	for(int z=minZ; z<=maxZ; ++z)
+	{
+		for(int x=minX; x<=maxX; ++x)
+		{
+			LightGrid::const_iterator cell = grid.find(make_pair(x, z));
+
+			if(cell != grid.end())
+			{
+				lights.insert(lights.end(), cell->second.begin(), cell->second.end());
+			}
+		}
+	}
+
+	// A light spanning several of the cells was collected from each of them
+	sort(lights.begin(), lights.end());
+	lights.erase(unique(lights.begin(), lights.end()), lights.end());
+
+	lights.insert(lights.end(), unboundedLights.begin(), unboundedLights.end());
+}
+
+size_t LightManager::selectLights(const vec3 &center, float radius) const
+{
+	LightSet candidates;
+	collectLights(center, radius, candidates);
+
+	// Rank the lights by their brightness at the nearest point of the sphere
+	vector< pair<float,const Light*> > ranked;
+
+	for(LightSet::const_iterator i=candidates.begin(); i!=candidates.end(); ++i)
+	{
+		const Light *light = *i;
+
+		const float distance = max(0.0f, vec3(center - light->getPosition()).getMagnitude() - radius);
+		const float influence = light->getInfluenceRadius();
+
+		if(influence < 0.0f || distance <= influence)
+		{
+			ranked.push_back(make_pair(light->getIntensity(distance), light));
+		}
+	}
+
+	const size_t count = min(ranked.size(), (size_t)MAX_LIGHTS);
+
+	partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), greater< pair<float,const Light*> >());
+
+	// Keep the set in a canonical order so that equal selections are shared
+	LightSet selected;
+	for(size_t i=0; i<count; ++i)
+	{
+		selected.push_back(ranked[i].second);
+	}
+	sort(selected.begin(), selected.end());
+
+	return findLightSet(selected);
+}
+
+size_t LightManager::findLightSet(const LightSet &lights) const
+{
+	map<LightSet, size_t>::const_iterator i = lightSetIndices.find(lights);
+
+	if(i != lightSetIndices.end())
 	{
-		activeSet.push_back(q.top().second);
-		q.pop();
+		return i->second;
 	}
+
+	const size_t index = lightSets.size();
+	lightSets.push_back(lights);
+	lightSetIndices.insert(make_pair(lights, index));
+	return index;
+}
+
+void LightManager::resetLightSets(void)
+{
+	lightSets.clear();
+	lightSetIndices.clear();
+
+	// The global set of lights is always the first
+	LightSet nearest(activeSet.begin(), activeSet.begin() + min(activeSet.size(), (size_t)MAX_LIGHTS));
+	sort(nearest.begin(), nearest.end());
+	findLightSet(nearest);
 }
 
 void LightManager::disableAll(void) const
 {
-	for(size_t i=0; i<7; ++i)
-		glDisable(lightNames[i]);
+	for(size_t i=0; i<(size_t)MAX_LIGHTS; ++i)
+		g_StateCache.disable(lightNames[i]);
 }
 
 void LightManager::bindAll(void) const
 {
-	vector<const Light*> s = getActiveSet();
+	bindLightSet(GLOBAL_LIGHT_SET);
+}
 
-	disableAll();
+void LightManager::bindLightSet(size_t lightSet) const
+{
+	ASSERT(lightSet < lightSets.size(), "light set is invalid: " + itoa((int)lightSet));
 
-	// Bind the 7 active lights
-	for(size_t i=0; i<7 && i<s.size(); ++i)
+	const LightSet &s = lightSets[min(lightSet, lightSets.size()-1)];
+
+	for(size_t i=0; i<(size_t)MAX_LIGHTS; ++i)
 	{
-		s[i]->bind(lightNames[i]);
-		glEnable(lightNames[i]);
+		if(i < s.size())
+		{
+			s[i]->bind(lightNames[i]);
+			g_StateCache.enable(lightNames[i]);
+		}
+		else
+		{
+			g_StateCache.disable(lightNames[i]);
+		}
 	}
+
+	numLightSetBinds++;
 }
 
 void LightManager::release(void)
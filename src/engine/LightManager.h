@@ -45,10 +45,45 @@ typedef map<HLIGHT, Light*> LIGHTS;
 /** A handle set to INVALID_LIGHT is a null, or invalid, handle */
 const HLIGHT INVALID_LIGHT = -1;
 
-/** Manages all Lights and how they lights bound for OpenGL */
+/**
+Manages all Lights and how they lights bound for OpenGL.
+Lights are filed in a grid over the ground by their radius of influence,
+so that the few lights that reach a piece of the scene can be found
+without looking at every light in the zone. Each map chunk and actor is
+lit by the brightest lights that reach it, and identical selections share
+one light set so that the render queue can group draws by light set.
+*/
 class LightManager
 {
+public:
+	/** Number of OpenGL lights that a light set may hold */
+	static const int MAX_LIGHTS = 7;
+
+	/** Light set of the lights nearest to the player, for draws not given their own */
+	static const size_t GLOBAL_LIGHT_SET = 0;
+
+	/** A selection of lights bound together */
+	typedef vector<const Light*> LightSet;
+
 private:
+	/** Lights overlapping each cell of the grid, keyed by column and row */
+	typedef map< pair<int,int>, LightSet > LightGrid;
+
+	/** Grid of the lights that fade out */
+	LightGrid grid;
+
+	/** Lights that never fade out, which reach everything */
+	LightSet unboundedLights;
+
+	/** Light sets selected since the grid was last rebuilt */
+	mutable vector<LightSet> lightSets;
+
+	/** Index of each distinct light set within lightSets */
+	mutable map<LightSet, size_t> lightSetIndices;
+
+	/** Light sets bound to OpenGL by all managers */
+	static size_t numLightSetBinds;
+
 	/** Collection of all lights in the zone */
 	LIGHTS lights;
 
@@ -63,6 +98,27 @@ private:
 	/** Determine the active set of lights */
 	void computeActiveSet(void);
 
+	/** Files each enabled light in the grid cells within its radius of influence */
+	void rebuildGrid(void);
+
+	/**
+	Collects the lights whose cells overlap a sphere
+	@param center Center of the sphere
+	@param radius Radius of the sphere
+	@param lights Returns the lights, each listed once
+	*/
+	void collectLights(const vec3 &center, float radius, LightSet &lights) const;
+
+	/**
+	Gets the index of a light set, recording it if it is new
+	@param lights The light set
+	@return index of the light set
+	*/
+	size_t findLightSet(const LightSet &lights) const;
+
+	/** Forgets the selected light sets, keeping only the global one */
+	void resetLightSets(void);
+
 public:
 	/** Ambient light intensity of the scene */
 	float ambientLight;
@@ -138,9 +194,41 @@ public:
 	/** Disables the active set of OpenGL lights */
 	void disableAll(void) const;
 
-	/** Binds the appropriate lights to OpenGL */
+	/** Binds the lights nearest to the player to OpenGL */
 	void bindAll(void) const;
 
+	/**
+	Selects the brightest lights that reach a bounding sphere
+	@param center Center of the sphere
+	@param radius Radius of the sphere
+	@return Light set, valid until the next update
+	*/
+	size_t selectLights(const vec3 &center, float radius) const;
+
+	/**
+	Binds a light set to OpenGL, and disables the remaining lights
+	@param lightSet The light set
+	*/
+	void bindLightSet(size_t lightSet) const;
+
+	/**
+	Gets the number of distinct light sets selected since the last update
+	@return number of light sets
+	*/
+	inline size_t getNumLightSets(void) const
+	{
+		return lightSets.size();
+	}
+
+	/**
+	Gets the number of light sets bound to OpenGL so far
+	@return light set binds since the program started
+	*/
+	static size_t getNumLightSetBinds(void)
+	{
+		return numLightSetBinds;
+	}
+
 	/**
 	Gets the list of active lights
 	return list of active lights
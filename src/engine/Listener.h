@@ -79,6 +79,15 @@ protected:
 	*/
 	bool pollConditions(void) const;
 
+	/**
+	Listeners are triggered by signals and so they have no region
+	@return REGION_OCCUPANT_NONE
+	*/
+	virtual unsigned int getRegionMask(void) const
+	{
+		return REGION_OCCUPANT_NONE;
+	}
+
 	/**
 	Called on the event that a message is received by the object
 	@param message The message received
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "Application.h"
 #include "EffectManager.h"
 #include "Tile.h"
 #include "material.h"
@@ -37,6 +38,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Map.h"
 #include "profile.h"
 #include "file.h"
+#include "VisibleSet.h"
 
 namespace Engine {
 
@@ -55,16 +57,19 @@ void Map::clear(void)
 	grid=0;
 	width=0;
 	height=0;
-	quadTree=0;
+	chunkTiles=0;
+	chunksPerRow=0;
+	chunksPerColumn=0;
+	changed=false;
+	changedMinX=changedMinZ=changedMaxX=changedMaxZ=0;
 }
 
 void Map::destroy(void)
 {
 	TRACE("Destroying Map...");
 
-	delete quadTree;
-	quadTree=0;
-	TRACE("...destroyed Quad-Tree...");
+	destroyChunks();
+	TRACE("...destroyed chunks...");
 
 	delete [] grid;
 	grid = 0;
@@ -73,9 +78,6 @@ void Map::destroy(void)
 	destroyMaterialsLegend();
 	TRACE("...destroyed materials legend...");
 
-	release();
-	TRACE("...released resources...");
-
 	clear();
 
 	TRACE("...finished Destroying Map");
@@ -213,10 +215,7 @@ void Map::create(const PropertyBag &xml)
 		}
 	}
 
-	quadTree = new QuadTreeNode(grid, 0, 0, width, width, tileMetersX);
-
-	// Allocate OpenGL resources
-	reaquire();
+	createChunks();
 }
 
 void Map::makeNewMap(void)
@@ -241,12 +240,14 @@ void Map::resize(int width)
 	// Allocate the new map
 	grid = new Tile[width * height];
 
+	// Chunks of the old map must not be drawn while the new one is filled
+	destroyChunks();
+
 	// Fill the test map
 	fill(TILE_BLOCK, TILE_PROPERTY_IMPASSABLE, "data/tiles/floor/floor.jpg", "data/tiles/wall/wall.jpg", 2.4f);
 
-	// remake the tree
-	delete quadTree;
-	quadTree = new QuadTreeNode(grid, 0, 0, width, width, tileMetersX);
+	// remake the chunks
+	createChunks();
 }
 
 void Map::save(PropertyBag &xml, const string &zoneName) const
@@ -278,7 +279,7 @@ void Map::fill(TILE_TYPE tileType, TILE_PROPERTIES properties, const string &flo
 			getTile(x,y).create(x,y,tileType, properties, tileHeight, floorFileName, wallFileName, *this);
 	}
 
-	reaquire();
+	invalidateBlock(0, 0, width-1, height-1);
 }
 
 void Map::fillRandom(TILE_TYPE tileType, TILE_PROPERTIES properties, const string &floorFileName, const string &wallFileName)
@@ -289,13 +290,35 @@ void Map::fillRandom(TILE_TYPE tileType, TILE_PROPERTIES properties, const strin
 			getTile(x,y).create(x,y, tileType, properties, FRAND_RANGE(0.0f, 2.0f), loadMapMaterial(floorFileName, false), loadMapMaterial(wallFileName, false), *this);
 	}
 
-	reaquire();
+	invalidateBlock(0, 0, width-1, height-1);
 }
 
 void Map::draw(void) const
 {
 	PROFILE;
-	quadTree->draw(vec3(width/2*tileMetersX, 0, height/2*tileMetersX));
+
+	g_Camera.getFrustum().cull(chunkBounds);
+
+	for(size_t i=0; i<chunks.size(); ++i)
+	{
+		if(chunkBounds.isVisible(i))
+		{
+			chunks[i]->draw();
+		}
+	}
+}
+
+void Map::gatherVisible(const Frustum &frustum, VisibleSet &set) const
+{
+	frustum.cull(chunkBounds);
+
+	for(size_t i=0; i<chunks.size(); ++i)
+	{
+		if(chunkBounds.isVisible(i))
+		{
+			set.addChunk(chunks[i], chunkBounds.getMin(i), chunkBounds.getMax(i));
+		}
+	}
 }
 
 void Map::drawToDepthBuffer(void) const
@@ -303,11 +326,128 @@ void Map::drawToDepthBuffer(void) const
 	draw();
 }
 
+void Map::createChunks(void)
+{
+	destroyChunks();
+
+	if(width <= 0 || height <= 0)
+		return;
+
+	// Chunks along the northern and eastern edges hold whatever tiles remain
+	chunkTiles = MapChunk::CHUNK_TILES;
+	chunksPerRow = (width + chunkTiles - 1) / chunkTiles;
+	chunksPerColumn = (height + chunkTiles - 1) / chunkTiles;
+
+	for(int z=0; z<chunksPerColumn; ++z)
+	{
+		for(int x=0; x<chunksPerRow; ++x)
+		{
+			const int left = x*chunkTiles;
+			const int lower = z*chunkTiles;
+
+			MapChunk *chunk = new MapChunk(*this, left, lower,
+			                               min(chunkTiles, width - left),
+			                               min(chunkTiles, height - lower));
+
+			vec3 boxMin, boxMax;
+			chunk->calculateBounds(boxMin, boxMax);
+
+			chunks.push_back(chunk);
+			chunkBounds.add(boxMin, boxMax);
+		}
+	}
+}
+
+void Map::destroyChunks(void)
+{
+	for(size_t i=0; i<chunks.size(); ++i)
+	{
+		delete chunks[i];
+	}
+
+	chunks.clear();
+	chunkBounds.clear();
+	chunkTiles = 0;
+	chunksPerRow = 0;
+	chunksPerColumn = 0;
+}
+
+void Map::invalidateTile(int x, int z) const
+{
+	invalidateBlock(x-1, z-1, x+1, z+1);
+}
+
+void Map::invalidateBlock(int startX, int startZ, int endX, int endZ) const
+{
+	const int x0 = min(startX, endX), x1 = max(startX, endX);
+	const int z0 = min(startZ, endZ), z1 = max(startZ, endZ);
+
+	if(changed)
+	{
+		changedMinX = min(changedMinX, x0);
+		changedMinZ = min(changedMinZ, z0);
+		changedMaxX = max(changedMaxX, x1);
+		changedMaxZ = max(changedMaxZ, z1);
+	}
+	else
+	{
+		changed = true;
+		changedMinX = x0;
+		changedMinZ = z0;
+		changedMaxX = x1;
+		changedMaxZ = z1;
+	}
+
+	if(chunks.empty())
+		return;
+
+	const int minX = max(0, min(startX, endX)) / chunkTiles;
+	const int minZ = max(0, min(startZ, endZ)) / chunkTiles;
+	const int maxX = min(width-1,  max(startX, endX)) / chunkTiles;
+	const int maxZ = min(height-1, max(startZ, endZ)) / chunkTiles;
+
+	for(int z=minZ; z<=maxZ; ++z)
+	{
+		for(int x=minX; x<=maxX; ++x)
+		{
+			const size_t i = z*chunksPerRow + x;
+
+			vec3 boxMin, boxMax;
+			chunks[i]->calculateBounds(boxMin, boxMax);
+
+			chunks[i]->invalidate();
+			chunkBounds.set(i, boxMin, boxMax);
+		}
+	}
+}
+
+bool Map::takeChangedBlock(float &minX, float &minZ, float &maxX, float &maxZ) const
+{
+	if(!changed)
+		return false;
+
+	changed = false;
+
+	minX = changedMinX * tileMetersX;
+	minZ = changedMinZ * tileMetersX;
+	maxX = (changedMaxX + 1) * tileMetersX;
+	maxZ = (changedMaxZ + 1) * tileMetersX;
+
+	return true;
+}
+
 void Map::reaquire(void) const
-{}
+{
+	invalidateBlock(0, 0, width-1, height-1);
+}
 
 void Map::release(void) const
-{}
+{
+	for(size_t i=0; i<chunks.size(); ++i)
+	{
+		chunks[i]->release();
+	}
+}
 
 void Map::fillBlock(int startX, int startZ, int endX, int endZ, TILE_TYPE tileType, TILE_PROPERTIES properties, const string &floorFileName, const string &wallFileName, float tileHeight)
 {
@@ -319,7 +459,8 @@ void Map::fillBlock(int startX, int startZ, int endX, int endZ, TILE_TYPE tileTy
 		}
 	}
 
-	reaquire();
+	// Walls along the edge of the block depend upon the tiles just outside of it
+	invalidateBlock(min(startX, endX)-1, min(startZ, endZ)-1, max(startX, endX)+1, max(startZ, endZ)+1);
 }
 
 void Map::removeAllMaterials(void)
@@ -335,6 +476,8 @@ void Map::removeAllMaterials(void)
 
         tile.setMaterials(wall, floor, *this);
     }
+
+	reaquire();
 }
 
 } // namespace Engine
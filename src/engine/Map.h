@@ -33,10 +33,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "PropertyBag.h"
 #include "Tile.h"
-#include "QuadTreeNode.h"
+#include "CullingBatch.h"
+#include "MapChunk.h"
 
 namespace Engine {
 
+class Frustum;
+class VisibleSet;
+
 /**
 Manages a map made out of Tile objects.
 Provides tools to edit the map graphically.
@@ -56,8 +60,26 @@ private:
 	/**  Two dimensional array of tiles in the map */
 	Tile *grid;
 
-	/** Quad tree spatially organizes the tiles */
-	QuadTreeNode *quadTree;
+	/** Baked geometry for blocks of tiles, ordered by row and then by column */
+	vector<MapChunk*> chunks;
+
+	/** Bounding boxes of the chunks, in the same order as the chunks */
+	mutable BoxBatch chunkBounds;
+
+	/** Number of tiles along each side of a chunk */
+	int chunkTiles;
+
+	/** Number of chunks from west to east */
+	int chunksPerRow;
+
+	/** Number of chunks from south to north */
+	int chunksPerColumn;
+
+	/** Some tiles have been invalidated since takeChangedBlock was last called */
+	mutable bool changed;
+
+	/** Block of tiles invalidated since takeChangedBlock was last called */
+	mutable int changedMinX, changedMinZ, changedMaxX, changedMaxZ;
 
 	/** all map material (index is the material ID) */
 	vector<Material*> materialsLegend;
@@ -77,6 +99,12 @@ private:
 	/** Destroy the materials legend */
 	void destroyMaterialsLegend(void);
 
+	/** Rebuilds the map chunks and their bounding boxes */
+	void createChunks(void);
+
+	/** Destroys the map chunks and their bounding boxes */
+	void destroyChunks(void);
+
 public:
 	/** Constructs an empty map */
 	Map(void);
@@ -90,7 +118,7 @@ public:
 	/** Cleanly destroys a map and then resets it */
 	void destroy(void);
 
-	/** Deletes the display list for the entire map */
+	/** Frees the vertex buffers of every map chunk */
 	void release(void) const;
 
 	/**
@@ -136,6 +164,13 @@ public:
 	/** Draws the map */
 	void draw(void) const;
 
+	/**
+	Adds the map chunks within a frustum to a visible set
+	@param frustum The camera frustum
+	@param set The visible set
+	*/
+	void gatherVisible(const Frustum &frustum, VisibleSet &set) const;
+
 	/** Draws the map to the depth buffer to project shadows */
 	void drawToDepthBuffer(void) const;
 
@@ -290,9 +325,48 @@ public:
 	*/
 	void fillRandom(TILE_TYPE tileType, TILE_PROPERTIES properties, const string &floorFileName, const string &wallFileName);
 
-	/** Rebuilds the display list for the entire map */
+	/** Rebuilds the vertex buffers of every map chunk */
 	void reaquire(void) const;
 
+	/**
+	Rebuilds the chunks that draw a tile, the next time they are drawn.
+	Chunks holding the tile's neighbors are rebuilt too, as their walls
+	depend upon the height of the tile.
+	@param x The x-coordinate of the Tile, in tile-space
+	@param z The z-coordinate of the Tile, in tile-space
+	*/
+	void invalidateTile(int x, int z) const;
+
+	/**
+	Rebuilds the chunks that draw a tile, the next time they are drawn.
+	@param x The x-coordinate of the Tile, in world-space
+	@param z The z-coordinate of the Tile, in world-space
+	*/
+	inline void invalidateTile(float x, float z) const
+	{
+		invalidateTile(tileX(x), tileZ(z));
+	}
+
+	/**
+	Rebuilds the chunks that draw a rectangle of tiles, the next time they are drawn.
+	@param startX
+	@param startZ
+	@param endX
+	@param endZ
+	*/
+	void invalidateBlock(int startX, int startZ, int endX, int endZ) const;
+
+	/**
+	Takes the block enclosing every tile invalidated since the last call,
+	so that actors resting on those tiles may be woken to settle onto them
+	@param minX Returns the western edge of the block, in world-space
+	@param minZ Returns the southern edge of the block, in world-space
+	@param maxX Returns the eastern edge of the block, in world-space
+	@param maxZ Returns the northern edge of the block, in world-space
+	@return true if any tiles were invalidated
+	*/
+	bool takeChangedBlock(float &minX, float &minZ, float &maxX, float &maxZ) const;
+
 	/**
 	Resizes the map and deletes its previous contents
 	@param width The new width of the Map
@@ -329,6 +403,15 @@ public:
 		return tileMetersX;
 	}
 
+	/**
+	Gets the number of chunks the map is divided into
+	@return number of chunks
+	*/
+	inline size_t getNumChunks(void) const
+	{
+		return chunks.size();
+	}
+
     /** Removes all materials on the map and replaces them with some pretty generic ones */
     void removeAllMaterials(void);
 };
@@ -0,0 +1,265 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "stdafx.h"
+#include <boost/bind.hpp>
+#include "gl.h"
+#include "opengl.h"
+#include "EffectManager.h"
+#include "material.h"
+#include "Tile.h"
+#include "Map.h"
+#include "RenderQueue.h"
+#include "MapChunk.h"
+
+namespace Engine {
+
+size_t MapChunk::numDrawCalls = 0;
+
+MapChunk::MapChunk(const Map &owner, int leftColumn, int lowerRow, int numColumns, int numRows)
+: owner(owner),
+  leftColumn(leftColumn),
+  lowerRow(lowerRow),
+  numColumns(numColumns),
+  numRows(numRows),
+  dirty(true),
+  numVertices(0),
+  vbo(0)
+{}
+
+MapChunk::~MapChunk(void)
+{
+	release();
+}
+
+void MapChunk::release(void)
+{
+	if(vbo!=0)
+	{
+		glDeleteBuffersARB(1, &vbo);
+		vbo = 0;
+	}
+
+	dirty = true;
+}
+
+void MapChunk::addQuad(const Material *material, const vec3 &normal, const vec3 &origin, const vec3 &scale, const vec3 positions[4], const float texCoords[8])
+{
+	Staging &s = staging[material];
+
+	for(int i=0; i<4; ++i)
+	{
+		s.positions.push_back(origin.x + positions[i].x*scale.x);
+		s.positions.push_back(origin.y + positions[i].y*scale.y);
+		s.positions.push_back(origin.z + positions[i].z*scale.z);
+
+		s.normals.push_back(normal.x);
+		s.normals.push_back(normal.y);
+		s.normals.push_back(normal.z);
+
+		s.texCoords.push_back(texCoords[i*2 + 0]);
+		s.texCoords.push_back(texCoords[i*2 + 1]);
+	}
+}
+
+void MapChunk::rebuild(void)
+{
+	const float tileMetersX = owner.getTileMetersX();
+
+	staging.clear();
+
+	// Collect the world-space geometry of each tile, grouped by material
+	for(int z=lowerRow; z<lowerRow+numRows; ++z)
+	{
+		for(int x=leftColumn; x<leftColumn+numColumns; ++x)
+		{
+			const Tile &tile = owner.getTile(x, z);
+
+			if(tile.getType() != TILE_BLOCK)
+				continue;
+
+			tile.bake(vec3(x*tileMetersX, 0.0f, z*tileMetersX), *this);
+		}
+	}
+
+	// Count the vertices in the chunk
+	numVertices = 0;
+	for(map<const Material*, Staging>::const_iterator i=staging.begin(); i!=staging.end(); ++i)
+	{
+		numVertices += i->second.positions.size() / 3;
+	}
+
+	// Pack the streams into one array, with each material's vertices contiguous
+	vertices.resize(numVertices * 8);
+	batches.clear();
+
+	float *positions = vertices.empty() ? 0 : &vertices[0];
+	float *normals = positions + numVertices*3;
+	float *texCoords = positions + numVertices*6;
+
+	GLint first = 0;
+
+	for(map<const Material*, Staging>::const_iterator i=staging.begin(); i!=staging.end(); ++i)
+	{
+		const Staging &s = i->second;
+		const GLsizei count = (GLsizei)(s.positions.size() / 3);
+
+		copy(s.positions.begin(), s.positions.end(), positions + first*3);
+		copy(s.normals.begin(), s.normals.end(), normals + first*3);
+		copy(s.texCoords.begin(), s.texCoords.end(), texCoords + first*2);
+
+		Batch batch;
+		batch.material = i->first;
+		batch.first = first;
+		batch.count = count;
+		batches.push_back(batch);
+
+		first += count;
+	}
+
+	staging.clear();
+
+	// Upload to the video card, when it is able to hold the buffer
+	if(g_bUseVertexBufferObjects && !vertices.empty())
+	{
+		if(vbo==0)
+		{
+			glGenBuffersARB(1, &vbo);
+		}
+
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, vbo);
+		glBufferDataARB(GL_ARRAY_BUFFER_ARB, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW_ARB);
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+	}
+
+	dirty = false;
+}
+
+float* MapChunk::getStream(size_t offset)
+{
+	if(vbo!=0)
+	{
+		return reinterpret_cast<float*>(offset * sizeof(float));
+	}
+	else
+	{
+		return &vertices[offset];
+	}
+}
+
+void MapChunk::drawBatch(size_t batch)
+{
+	Effect &effect = EffectManager::GetSingleton().getEffect();
+
+	if(vbo!=0)
+	{
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, vbo);
+	}
+
+	effect.passVertexStream(getStream(0));
+	effect.passNormalStream(getStream(numVertices*3));
+	effect.passTexCoordStream(getStream(numVertices*6), 0);
+
+	glDrawArrays(GL_QUADS, batches[batch].first, batches[batch].count);
+	numDrawCalls++;
+
+	if(vbo!=0)
+	{
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+	}
+}
+
+void MapChunk::calculateBounds(vec3 &boxMin, vec3 &boxMax) const
+{
+	const float tileMetersX = owner.getTileMetersX();
+
+	float minY = 0.0f, maxY = 0.0f;
+
+	for(int z=lowerRow; z<lowerRow+numRows; ++z)
+	{
+		for(int x=leftColumn; x<leftColumn+numColumns; ++x)
+		{
+			const Tile &tile = owner.getTile(x, z);
+
+			if(tile.getType() != TILE_BLOCK)
+				continue;
+
+			minY = min(minY, tile.getTileHeight());
+			maxY = max(maxY, tile.getTileHeight());
+		}
+	}
+
+	boxMin = vec3(leftColumn * tileMetersX, minY, lowerRow * tileMetersX);
+	boxMax = vec3((leftColumn+numColumns) * tileMetersX, maxY, (lowerRow+numRows) * tileMetersX);
+}
+
+void MapChunk::draw(void)
+{
+	if(dirty)
+	{
+		rebuild();
+	}
+
+	CHECK_GL_ERROR();
+
+	for(size_t i=0; i<batches.size(); ++i)
+	{
+		if(batches[i].material) batches[i].material->bind();
+
+		drawBatch(i);
+	}
+
+	FLUSH_GL_ERROR();
+}
+
+void MapChunk::submit(RenderQueue &queue, const vec3 &position)
+{
+	if(dirty)
+	{
+		rebuild();
+	}
+
+	for(size_t i=0; i<batches.size(); ++i)
+	{
+		const RenderQueue::Callback geometry = boost::bind(&MapChunk::drawBatch, this, i);
+
+		if(batches[i].material)
+		{
+			queue.add(RenderQueue::OPAQUE_BUCKET, batches[i].material, position, geometry);
+		}
+		else
+		{
+			queue.addCustom(RenderQueue::OPAQUE_BUCKET, position, geometry);
+		}
+	}
+}
+
+} // namespace Engine
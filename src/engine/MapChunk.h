@@ -0,0 +1,190 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _MAP_CHUNK_H_
+#define _MAP_CHUNK_H_
+
+#include "gl.h"
+#include "vec4.h"
+
+namespace Engine {
+
+class Map;
+class Material;
+class RenderQueue;
+
+/**
+A block of tiles baked into a single vertex buffer.
+Chunks are CHUNK_TILES on a side, except along the northern and eastern
+edges of a map whose size is not a multiple of CHUNK_TILES.
+The geometry of every tile in the chunk is stored in world-space and
+grouped by material, so that drawing the chunk costs one draw call per
+material instead of two immediate-mode batches per tile. The buffer is
+rebuilt lazily the next time the chunk is drawn after it is invalidated.
+*/
+class MapChunk
+{
+public:
+	/** Number of tiles along each side of a full chunk */
+	static const int CHUNK_TILES = 16;
+
+	/**
+	Constructor
+	@param owner Map that owns the tiles
+	@param leftColumn Tile column of the western edge of the chunk
+	@param lowerRow Tile row of the southern edge of the chunk
+	@param numColumns Number of tiles from west to east
+	@param numRows Number of tiles from south to north
+	*/
+	MapChunk(const Map &owner, int leftColumn, int lowerRow, int numColumns, int numRows);
+
+	/** Destructor */
+	~MapChunk(void);
+
+	/** Marks the chunk as needing to be rebuilt before it is drawn again */
+	inline void invalidate(void)
+	{
+		dirty = true;
+	}
+
+	/** Draws the chunk, rebuilding it first if it has been invalidated */
+	void draw(void);
+
+	/**
+	Queues each material batch of the chunk, rebuilding it first if it has been invalidated
+	@param queue The render queue
+	@param position World-space position of the chunk
+	*/
+	void submit(RenderQueue &queue, const vec3 &position);
+
+	/**
+	Calculates the axis-aligned box enclosing the tiles of the chunk
+	@param boxMin Returns the minimum corner of the box
+	@param boxMax Returns the maximum corner of the box
+	*/
+	void calculateBounds(vec3 &boxMin, vec3 &boxMax) const;
+
+	/** Frees the vertex buffer and forces the chunk to be rebuilt */
+	void release(void);
+
+	/**
+	Adds a quad to the chunk while it is being rebuilt
+	@param material Material of the quad (may be null)
+	@param normal Normal of the quad
+	@param origin World-space position of the tile's origin
+	@param scale Dimensions of the tile
+	@param positions Four corners of the quad, in unit tile-space
+	@param texCoords Four texture coordinate pairs, one for each corner
+	*/
+	void addQuad(const Material *material, const vec3 &normal, const vec3 &origin, const vec3 &scale, const vec3 positions[4], const float texCoords[8]);
+
+	/**
+	Gets the number of draw calls issued by all chunks so far
+	@return draw calls issued since the program started
+	*/
+	static size_t getNumDrawCalls(void)
+	{
+		return numDrawCalls;
+	}
+
+private:
+	/** Vertex data for one material while the chunk is being rebuilt */
+	struct Staging
+	{
+		vector<float> positions;
+		vector<float> normals;
+		vector<float> texCoords;
+	};
+
+	/** Range of the vertex buffer that uses one material */
+	struct Batch
+	{
+		const Material *material;
+		GLint first;
+		GLsizei count;
+	};
+
+	/** Rebuilds the vertex buffer from the tiles in the chunk */
+	void rebuild(void);
+
+	/**
+	Draws one material batch, assuming that its material is already bound
+	@param batch Index of the batch
+	*/
+	void drawBatch(size_t batch);
+
+	/**
+	Gets a pointer to pass to the Effect for a vertex stream
+	@param offset Offset of the stream, in floats, from the start of the vertex data
+	@return Pointer into client memory, or offset into the buffer object
+	*/
+	float* getStream(size_t offset);
+
+	/** Map that owns the tiles */
+	const Map &owner;
+
+	/** Tile column of the western edge of the chunk */
+	int leftColumn;
+
+	/** Tile row of the southern edge of the chunk */
+	int lowerRow;
+
+	/** Number of tiles from west to east */
+	int numColumns;
+
+	/** Number of tiles from south to north */
+	int numRows;
+
+	/** The chunk must be rebuilt before it is drawn */
+	bool dirty;
+
+	/** Staging geometry, used only while rebuilding */
+	map<const Material*, Staging> staging;
+
+	/** Positions, then normals, then tex-coords, for every vertex in the chunk */
+	vector<float> vertices;
+
+	/** Number of vertices in the chunk */
+	size_t numVertices;
+
+	/** Material batches, in the order that they are drawn */
+	vector<Batch> batches;
+
+	/** Vertex buffer object, or zero when client-side arrays are used */
+	GLuint vbo;
+
+	/** Draw calls issued by all chunks */
+	static size_t numDrawCalls;
+};
+
+} // namespace Engine
+
+#endif
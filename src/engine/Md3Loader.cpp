@@ -513,8 +513,8 @@ Mesh* Surface::getObject(size_t frame) const
 
 	// Record the number of relevant elements
 	mesh->m_numOfFaces		= header.numTris;
-	mesh->m_numOfVerts		= header.numTris * 3;
-	mesh->m_numTexVertex	= header.numTris * 3;
+	mesh->m_numOfVerts		= header.numVerts;
+	mesh->m_numTexVertex	= header.numVerts;
 
 	memcpy(mesh->m_strName, header.name, MAX_QPATH);
 
@@ -528,46 +528,46 @@ Mesh* Surface::getObject(size_t frame) const
 	mat4 rotation;
 	rotation.rotateX((float)M_PI / 2.0f);
 
-	// Copy faces
+	// Copy faces; MD3 triangles index the vertices and tex coords alike
 	for(int i=0; i<mesh->m_numOfFaces; ++i)
 	{
 		Mesh::Face &face = mesh->m_pFaces[i];
 
 		for(int j=0; j<3; ++j)
 		{
-			int counter = i*3 + j;
-			size_t texIdx = triangles[i].indices[j];
-			size_t vertIdx = triangles[i].indices[j] + frame*header.numVerts;
+			face.vertIndex[j] = triangles[i].indices[j];
+			face.coordIndex[j] = triangles[i].indices[j];
+		}
+	}
 
-			face.vertIndex[j] = counter;
-			face.coordIndex[j] = counter;
+	// Copy the vertices of this frame
+	const float normScale = (float)(2.0 * M_PI) / 255.0f;
 
-			// Copy vert for the face
-			Vertex &v = vertices[vertIdx];
+	for(int i=0; i<mesh->m_numOfVerts; ++i)
+	{
+		const Vertex &v = vertices[i + frame*header.numVerts];
 
-			vec3 out = vec3(0, 0, 0);
-			vec3 in = vec3(v.x, v.y, v.z) * MD3_XYZ_SCALE;
+		vec3 out = vec3(0, 0, 0);
+		vec3 in = vec3(v.x, v.y, v.z) * MD3_XYZ_SCALE;
 
-			out = rotation.transformVector(in);
+		out = rotation.transformVector(in);
 
-			// Set the vertex
-			mesh->m_pVerts[counter].x = out.x;
-			mesh->m_pVerts[counter].y = out.y;
-			mesh->m_pVerts[counter].z = out.z;
+		// Set the vertex
+		mesh->m_pVerts[i].x = out.x;
+		mesh->m_pVerts[i].y = out.y;
+		mesh->m_pVerts[i].z = out.z;
 
-			// Decode the compressed normal
-			const float normScale = (float)(2.0 * M_PI) / 255.0f;
-			float lat = ((v.encodedNormal >> 8) & 255)	* normScale;
-			float lng = (v.encodedNormal & 255)			* normScale;
+		// Decode the compressed normal
+		float lat = ((v.encodedNormal >> 8) & 255)	* normScale;
+		float lng = (v.encodedNormal & 255)			* normScale;
 
-			mesh->m_pNormals[counter].x = cosf(lat) * sinf(lng);
-			mesh->m_pNormals[counter].y = sinf(lat) * sinf(lng);
-			mesh->m_pNormals[counter].z = cosf(lng);
+		mesh->m_pNormals[i].x = cosf(lat) * sinf(lng);
+		mesh->m_pNormals[i].y = sinf(lat) * sinf(lng);
+		mesh->m_pNormals[i].z = cosf(lng);
 
-			// Set the tex coord
-			mesh->m_pTexVerts[counter].x =  texCoords[texIdx].st[0];
-			mesh->m_pTexVerts[counter].y = -texCoords[texIdx].st[1];
-		}
+		// Set the tex coord
+		mesh->m_pTexVerts[i].x =  texCoords[i].st[0];
+		mesh->m_pTexVerts[i].y = -texCoords[i].st[1];
 	}
 
 	// Re-allocate elements
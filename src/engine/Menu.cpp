@@ -31,6 +31,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "stdafx.h"
 #include "LinearInterpolator.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "SDLwindow.h"
 #include "WaitScreen.h"
 #include "Dimmer.h"
@@ -92,15 +93,15 @@ void Menu::draw(void)
 {
 	effect_Begin(effect_GUI);
 
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-	glDisable(GL_LIGHTING);
-	glDisable(GL_FOG);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_COLOR_MATERIAL);
+	g_StateCache.disable(GL_LIGHTING);
+	g_StateCache.disable(GL_FOG);
+	g_StateCache.disable(GL_DEPTH_TEST);
+	g_StateCache.disable(GL_COLOR_MATERIAL);
 
 	// Save the projection matrix
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPushMatrix();
 
 	// Set up the projection matrix for 2D
@@ -108,7 +109,7 @@ void Menu::draw(void)
 	glOrtho(0.0f, 1024.0f, 0.0f, 768.0f, -1.0f, 1.0f);
 
 	// Save the model view matrix
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glPushMatrix();
 
 	// Set up the model view matrix
@@ -117,8 +118,8 @@ void Menu::draw(void)
 
 	// Render a textured quad over the screen
 	menuBackdrop.getTexture().bind();
-	glDisable(GL_BLEND);
-	glDisable(GL_ALPHA_TEST);
+	g_StateCache.disable(GL_BLEND);
+	g_StateCache.disable(GL_ALPHA_TEST);
 	glColor4fv(white);
 	glBegin(GL_QUADS);
 		glTexCoord2f(1.0f, 0.0f); glVertex3f(1024.0f,   0.0f, 0.0f);
@@ -146,13 +147,15 @@ void Menu::draw(void)
 	glPopMatrix();
 
 	// Restore the projection matrix
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPopMatrix();
 
 	// Use modelview mode
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 
-	glPopAttrib();
+	glColor4fv(white);
+
+	g_StateCache.pop();
 
 	effect_End();
 }
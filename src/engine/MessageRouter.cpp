@@ -102,6 +102,7 @@ void MessageRouter::MailIt(Message_s Msg)
 	if(zone->getObjects().isMember(Msg.m_Recipient))
 	{
 		Actor &object = zone->getObjects().get(Msg.m_Recipient);
+		object.wake();
 		object.OnMessage(Msg);
 	}
 }
@@ -67,6 +67,9 @@ AnimationController* ModelLoader::load(const string &fileName)
 		controller = loadFromFile(fileName); // copy allocated for the cache alone
 
 		insertInCache(fileName, controller);
+
+		TRACE(fileName + ": " + itoa((int)controller->getSharedMemoryUsage()) + " bytes shared, "
+		      + itoa((int)controller->getInstanceMemoryUsage()) + " bytes per instance");
 	}
 
 	ASSERT(controller!=0, "controller was null");
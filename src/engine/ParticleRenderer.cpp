@@ -0,0 +1,154 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "stdafx.h"
+#include "gl.h"
+#include "StateCache.h"
+#include "material.h"
+#include "Effect.h"
+#include "EffectManager.h"
+#include "ParticleRenderer.h"
+
+namespace Engine {
+
+size_t ParticleRenderer::numBatches = 0;
+size_t ParticleRenderer::numBillboards = 0;
+
+void ParticleRenderer::Batch::clear(void)
+{
+	material = 0;
+	vertices.clear();
+	texCoords.clear();
+	colors.clear();
+}
+
+ParticleRenderer::ParticleRenderer(void)
+: rightPlusUp(1,1,0),
+  rightMinusUp(1,-1,0)
+{}
+
+void ParticleRenderer::begin(const mat4 &m)
+{
+	for(map<Key, Batch>::iterator i = batches.begin(); i != batches.end(); ++i)
+	{
+		i->second.clear();
+	}
+
+	rightPlusUp  = vec3(m[0] + m[1], m[4] + m[5], m[8] + m[9]);
+	rightMinusUp = vec3(m[0] - m[1], m[4] - m[5], m[8] - m[9]);
+}
+
+void ParticleRenderer::add(const Material &material, const vec3 &p, float radius, const COLOR &color)
+{
+	const TextureHandle *texture = material.getTexture(0);
+	const Key key(material.glow, (texture!=0) ? texture->getID() : 0);
+
+	Batch &batch = batches[key];
+
+	batch.material = &material;
+
+	const vec3 a = rightPlusUp * radius;
+	const vec3 b = rightMinusUp * radius;
+
+	const float vertices[12] =
+	{
+		p.x - a.x, p.y - a.y, p.z - a.z,
+		p.x + b.x, p.y + b.y, p.z + b.z,
+		p.x + a.x, p.y + a.y, p.z + a.z,
+		p.x - b.x, p.y - b.y, p.z - b.z
+	};
+
+	const float texCoords[8] =
+	{
+		0.0f, 0.0f,
+		1.0f, 0.0f,
+		1.0f, 1.0f,
+		0.0f, 1.0f
+	};
+
+	batch.vertices.insert(batch.vertices.end(), vertices, vertices+12);
+	batch.texCoords.insert(batch.texCoords.end(), texCoords, texCoords+8);
+
+	for(int i=0; i<4; ++i)
+	{
+		batch.colors.push_back(color.r);
+		batch.colors.push_back(color.g);
+		batch.colors.push_back(color.b);
+		batch.colors.push_back(color.a);
+	}
+}
+
+void ParticleRenderer::flush(void)
+{
+	CHECK_GL_ERROR();
+
+	Effect &effect = EffectManager::GetSingleton().getEffect();
+
+	g_StateCache.push();
+	g_StateCache.disableClientState(GL_NORMAL_ARRAY);
+	g_StateCache.enableClientState(GL_VERTEX_ARRAY);
+	g_StateCache.enableClientState(GL_TEXTURE_COORD_ARRAY);
+	g_StateCache.enableClientState(GL_COLOR_ARRAY);
+	g_StateCache.depthMask(GL_FALSE);
+
+	for(map<Key, Batch>::iterator i = batches.begin(); i != batches.end(); ++i)
+	{
+		Batch &batch = i->second;
+
+		if(batch.vertices.empty())
+			continue;
+
+		ASSERT(batch.material!=0, "batch.material was null");
+
+		batch.material->bind();
+		g_StateCache.blendFunc(GL_SRC_ALPHA, (i->first.first) ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+
+		effect.passVertexStream(&batch.vertices[0]);
+		effect.passTexCoordStream(&batch.texCoords[0], 0);
+		glColorPointer(4, GL_FLOAT, 0, &batch.colors[0]);
+
+		const GLsizei numVertices = (GLsizei)(batch.vertices.size() / 3);
+
+		glDrawArrays(GL_QUADS, 0, numVertices);
+
+		numBatches++;
+		numBillboards += numVertices / 4;
+
+		batch.clear();
+	}
+
+	g_StateCache.depthMask(GL_TRUE);
+	g_StateCache.pop();
+
+	CHECK_GL_ERROR();
+}
+
+} // namespace Engine
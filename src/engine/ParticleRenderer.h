@@ -0,0 +1,139 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _PARTICLE_RENDERER_H_
+#define _PARTICLE_RENDERER_H_
+
+#include "mat4.h"
+#include "COLOR.h"
+
+namespace Engine {
+
+class Material;
+
+/**
+Collects particle billboards from any number of particle systems and draws
+them with one vertex array draw call per batch. Billboards that share a
+texture and blend mode share a batch, even across particle systems. The
+batches are drawn in order of blend mode and then texture.
+
+The vertex arrays keep their storage from frame to frame, so only the
+first frames pay for allocation.
+*/
+class ParticleRenderer
+{
+public:
+	/** Constructor */
+	ParticleRenderer(void);
+
+	/**
+	Discards all billboards and takes a new camera basis for the frame
+	@param orientation Orientation of the camera; its first two rows are
+	the camera's right and up axes
+	*/
+	void begin(const mat4 &orientation);
+
+	/**
+	Adds a camera-facing billboard.
+	The material must stay valid until the renderer is flushed.
+	@param material The material of the billboard
+	@param position Center of the billboard
+	@param radius Size of the billboard
+	@param color Color of the billboard
+	*/
+	void add(const Material &material, const vec3 &position, float radius, const COLOR &color);
+
+	/** Draws all billboards, then empties the batches */
+	void flush(void);
+
+	/**
+	Gets the number of batches drawn by all renderers so far
+	@return batches drawn since the program started
+	*/
+	static size_t getNumBatches(void)
+	{
+		return numBatches;
+	}
+
+	/**
+	Gets the number of billboards drawn by all renderers so far
+	@return billboards drawn since the program started
+	*/
+	static size_t getNumBillboards(void)
+	{
+		return numBillboards;
+	}
+
+private:
+	/** Billboards that share one texture and blend mode */
+	struct Batch
+	{
+		/** Material to bind for the batch */
+		const Material *material;
+
+		/** Vertex positions, four vertices to a billboard */
+		vector<float> vertices;
+
+		/** Texture coordinates for each vertex */
+		vector<float> texCoords;
+
+		/** RGBA color for each vertex */
+		vector<float> colors;
+
+		/** Constructor */
+		Batch(void) : material(0) {}
+
+		/** Discards the billboards, but keeps the storage */
+		void clear(void);
+	};
+
+	/** Blend mode (glow first) then texture name */
+	typedef pair<bool, unsigned int> Key;
+
+	/** Batches, ordered by blend mode and then texture */
+	map<Key, Batch> batches;
+
+	/** Sum of the camera's right and up axes: the offset to two opposite corners */
+	vec3 rightPlusUp;
+
+	/** Difference of the camera's right and up axes: the offset to the other two corners */
+	vec3 rightMinusUp;
+
+	/** Batches drawn by all renderers */
+	static size_t numBatches;
+
+	/** Billboards drawn by all renderers */
+	static size_t numBillboards;
+};
+
+} // namespace Engine
+
+#endif
@@ -0,0 +1,408 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+#include "Map.h"
+#include "ActorSet.h"
+#include "Trigger.h"
+#include "RegionManager.h"
+
+namespace Engine {
+
+RegionManager::RegionManager(void)
+{
+	clear();
+}
+
+void RegionManager::clear(void)
+{
+	regions.clear();
+	freeRegions.clear();
+	cells.clear();
+	cellStamps.clear();
+	occupants.clear();
+	activeRegions.clear();
+
+	columns = rows = 0;
+	cellMeters = 1.0f;
+	updateStamp = testStamp = 0;
+	sweepIndex = 0;
+	numOccupiedCells = numTests = numEvents = 0;
+}
+
+void RegionManager::create(const Map &map)
+{
+	create((map.getNumColumns() + CELL_TILES - 1) / CELL_TILES,
+	       (map.getNumRows() + CELL_TILES - 1) / CELL_TILES,
+	       map.getTileMetersX() * CELL_TILES);
+}
+
+void RegionManager::create(int numColumns, int numRows, float meters)
+{
+	columns = max(1, numColumns);
+	rows = max(1, numRows);
+	cellMeters = meters;
+
+	cells.clear();
+	cells.resize(columns * rows);
+	cellStamps.clear();
+	cellStamps.resize(columns * rows, 0);
+
+	// Re-bin the existing regions into the new grid
+	for(size_t i=0; i<regions.size(); ++i)
+	{
+		if(regions[i].owner != INVALID_ID)
+		{
+			Region &region = regions[i];
+			getCellRange(region.x, region.z, region.radius,
+			             region.minCellX, region.minCellZ,
+			             region.maxCellX, region.maxCellZ);
+			bin((int)i);
+		}
+	}
+}
+
+bool RegionManager::getCellRange(float x, float z, float radius, int &minX, int &minZ, int &maxX, int &maxZ) const
+{
+	minX = (int)floorf((x - radius) / cellMeters);
+	minZ = (int)floorf((z - radius) / cellMeters);
+	maxX = (int)floorf((x + radius) / cellMeters);
+	maxZ = (int)floorf((z + radius) / cellMeters);
+
+	if(maxX < 0 || maxZ < 0 || minX >= columns || minZ >= rows)
+	{
+		// an empty range
+		minX = minZ = 0;
+		maxX = maxZ = -1;
+		return false;
+	}
+
+	minX = max(minX, 0);
+	minZ = max(minZ, 0);
+	maxX = min(maxX, columns-1);
+	maxZ = min(maxZ, rows-1);
+
+	return true;
+}
+
+void RegionManager::bin(int index)
+{
+	const Region &region = regions[index];
+
+	for(int z=region.minCellZ; z<=region.maxCellZ; ++z)
+	{
+		for(int x=region.minCellX; x<=region.maxCellX; ++x)
+		{
+			cells[z*columns + x].push_back(index);
+		}
+	}
+}
+
+void RegionManager::unbin(int index)
+{
+	const Region &region = regions[index];
+
+	for(int z=region.minCellZ; z<=region.maxCellZ; ++z)
+	{
+		for(int x=region.minCellX; x<=region.maxCellX; ++x)
+		{
+			vector<int> &cell = cells[z*columns + x];
+			vector<int>::iterator iter = find(cell.begin(), cell.end(), index);
+
+			ASSERT(iter != cell.end(), "region was not binned into the cell");
+
+			if(iter != cell.end())
+			{
+				*iter = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+}
+
+RegionManager::HANDLE RegionManager::add(OBJECT_ID owner, const vec3 &center, float radius, unsigned int mask)
+{
+	ASSERT(owner!=INVALID_ID, "owner was invalid");
+
+	int index = 0;
+
+	if(freeRegions.empty())
+	{
+		index = (int)regions.size();
+		regions.push_back(Region());
+	}
+	else
+	{
+		index = freeRegions.back();
+		freeRegions.pop_back();
+	}
+
+	Region &region = regions[index];
+	region.owner = owner;
+	region.x = center.x;
+	region.z = center.z;
+	region.radius = radius;
+	region.mask = mask;
+	region.inside.clear();
+	region.current.clear();
+	region.testStamp = 0;
+	region.pending = false;
+
+	getCellRange(region.x, region.z, region.radius,
+	             region.minCellX, region.minCellZ,
+	             region.maxCellX, region.maxCellZ);
+	bin(index);
+
+	return index;
+}
+
+void RegionManager::remove(HANDLE handle, OBJECT_ID owner)
+{
+	// The handle may be stale if the regions were cleared since it was issued
+	if(isRegion(handle, owner))
+	{
+		release(handle);
+	}
+}
+
+void RegionManager::release(int index)
+{
+	unbin(index);
+
+	Region &region = regions[index];
+	region.owner = INVALID_ID;
+	region.inside.clear();
+	region.current.clear();
+
+	freeRegions.push_back(index);
+}
+
+void RegionManager::move(HANDLE handle, const vec3 &center, float radius)
+{
+	if(!isValid(handle))
+		return;
+
+	Region &region = regions[handle];
+
+	region.x = center.x;
+	region.z = center.z;
+	region.radius = radius;
+
+	int minX, minZ, maxX, maxZ;
+	getCellRange(region.x, region.z, region.radius, minX, minZ, maxX, maxZ);
+
+	// Only re-bin the region if it has crossed into other cells
+	if(minX != region.minCellX || minZ != region.minCellZ ||
+	   maxX != region.maxCellX || maxZ != region.maxCellZ)
+	{
+		unbin(handle);
+		region.minCellX = minX;
+		region.minCellZ = minZ;
+		region.maxCellX = maxX;
+		region.maxCellZ = maxZ;
+		bin(handle);
+	}
+}
+
+const vector<OBJECT_ID>& RegionManager::getOccupants(HANDLE handle) const
+{
+	static const vector<OBJECT_ID> none;
+	return isValid(handle) ? regions[handle].inside : none;
+}
+
+void RegionManager::addOccupant(OBJECT_ID id, REGION_OCCUPANT type)
+{
+	for(vector<Occupant>::iterator iter = occupants.begin(); iter != occupants.end(); ++iter)
+	{
+		if(iter->id == id)
+		{
+			iter->type = type;
+			return;
+		}
+	}
+
+	Occupant occupant;
+	occupant.id = id;
+	occupant.type = type;
+	occupants.push_back(occupant);
+}
+
+void RegionManager::update(ActorSet &objects)
+{
+	updateStamp++;
+	numOccupiedCells = numTests = numEvents = 0;
+
+	// Amortized sweep for regions whose owner has left the world unnoticed
+	if(!regions.empty())
+	{
+		sweepIndex = (sweepIndex + 1) % regions.size();
+
+		const OBJECT_ID owner = regions[sweepIndex].owner;
+
+		if(owner != INVALID_ID && !objects.getPtr(owner))
+		{
+			release((int)sweepIndex);
+		}
+	}
+
+	// Regions occupied at the last update must be visited to detect exits
+	vector<int> touched;
+	touched.swap(activeRegions);
+	for(vector<int>::const_iterator i = touched.begin(); i != touched.end(); ++i)
+	{
+		regions[*i].pending = true;
+	}
+
+	// Bin each occupant and test it against the regions in its cells
+	size_t i = 0;
+	while(i < occupants.size())
+	{
+		const Occupant occupant = occupants[i];
+		const Actor *actor = objects.getPtr(occupant.id);
+
+		// Forget occupants that have left the world
+		if(!actor)
+		{
+			occupants[i] = occupants.back();
+			occupants.pop_back();
+			continue;
+		}
+
+		++i;
+
+		if(actor->zombie)
+			continue;
+
+		const vec3 &pos = actor->getPos();
+		const float occupantRadius = actor->getCylinderRadius();
+
+		int minX, minZ, maxX, maxZ;
+		if(!getCellRange(pos.x, pos.z, occupantRadius, minX, minZ, maxX, maxZ))
+			continue;
+
+		testStamp++;
+
+		for(int z=minZ; z<=maxZ; ++z)
+		{
+			for(int x=minX; x<=maxX; ++x)
+			{
+				const int cellIndex = z*columns + x;
+
+				if(cellStamps[cellIndex] != updateStamp)
+				{
+					cellStamps[cellIndex] = updateStamp;
+					numOccupiedCells++;
+				}
+
+				const vector<int> &cell = cells[cellIndex];
+
+				for(vector<int>::const_iterator j = cell.begin(); j != cell.end(); ++j)
+				{
+					Region &region = regions[*j];
+
+					// A region may overlap several cells the occupant is in
+					if(region.testStamp == testStamp || !(region.mask & occupant.type))
+						continue;
+
+					region.testStamp = testStamp;
+					numTests++;
+
+					const float dx = region.x - pos.x;
+					const float dz = region.z - pos.z;
+					const float minDist = region.radius + occupantRadius;
+
+					if(dx*dx + dz*dz < minDist*minDist)
+					{
+						region.current.push_back(occupant.id);
+
+						if(!region.pending)
+						{
+							region.pending = true;
+							touched.push_back(*j);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	Determine the events for each region and update its occupants.
+	The owner's handlers may not add or remove regions.
+	*/
+	for(vector<int>::const_iterator j = touched.begin(); j != touched.end(); ++j)
+	{
+		Region &region = regions[*j];
+		region.pending = false;
+
+		if(region.owner == INVALID_ID)
+			continue; // removed since the last update
+
+		Actor *actor = objects.getPtr(region.owner);
+
+		// Free regions whose owner has left the world
+		if(!actor)
+		{
+			release(*j);
+			continue;
+		}
+
+		Trigger *owner = static_cast<Trigger*>(actor);
+
+		for(vector<OBJECT_ID>::const_iterator k = region.current.begin(); k != region.current.end(); ++k)
+		{
+			if(find(region.inside.begin(), region.inside.end(), *k) == region.inside.end())
+				owner->onRegionEnter(*k);
+			else
+				owner->onRegionStay(*k);
+
+			numEvents++;
+		}
+
+		for(vector<OBJECT_ID>::const_iterator k = region.inside.begin(); k != region.inside.end(); ++k)
+		{
+			if(find(region.current.begin(), region.current.end(), *k) == region.current.end())
+			{
+				owner->onRegionExit(*k);
+				numEvents++;
+			}
+		}
+
+		region.inside.swap(region.current);
+		region.current.clear();
+
+		if(!region.inside.empty())
+		{
+			activeRegions.push_back(*j);
+		}
+	}
+}
+
+} // namespace Engine
@@ -0,0 +1,292 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _REGION_MANAGER_H_
+#define _REGION_MANAGER_H_
+
+#include "vec4.h"
+#include "Factory.h"
+
+namespace Engine {
+
+class Trigger;
+class ActorSet;
+class Map;
+
+/** Kinds of actors that may occupy a region */
+enum REGION_OCCUPANT
+{
+	REGION_OCCUPANT_NONE     = 0,
+	REGION_OCCUPANT_PLAYER   = 1,
+	REGION_OCCUPANT_CREATURE = 2, // any creature that is not a player
+	REGION_OCCUPANT_ANY      = 3
+};
+
+/**
+Tracks which players and creatures occupy the regions of Triggers.
+Regions are binned into a coarse grid laid over the tile map. Once per
+tick, each occupant is binned into the cells that it overlaps and tested
+only against the regions in those cells. Regions that gained, kept, or
+lost occupants are then sent enter, stay, and exit events.  The cost of
+a tick grows with the number of occupied cells and not with the number
+of regions.
+*/
+class RegionManager
+{
+public:
+	/** Handle to a region */
+	typedef int HANDLE;
+
+	/** Number of tiles along each side of a grid cell */
+	static const int CELL_TILES = 4;
+
+	/** Constructor */
+	RegionManager(void);
+
+	/** Removes all regions and occupants */
+	void clear(void);
+
+	/**
+	Lays the grid over the map, keeping all regions
+	@param map The map
+	*/
+	void create(const Map &map);
+
+	/**
+	Lays a grid of the given size, keeping all regions
+	@param numColumns Width of the grid, in cells (clamped to at least one)
+	@param numRows Height of the grid, in cells (clamped to at least one)
+	@param meters Meters along each side of a cell
+	*/
+	void create(int numColumns, int numRows, float meters);
+
+	/**
+	Adds a circular region (in the XZ-plane)
+	@param owner The trigger that receives events from the region.
+	The region is freed once the owner is no longer in the world.
+	@param center The center of the region
+	@param radius The radius of the region
+	@param mask Kinds of actors that may occupy the region
+	@return Handle to the region
+	*/
+	HANDLE add(OBJECT_ID owner, const vec3 &center, float radius, unsigned int mask);
+
+	/**
+	Removes a region
+	@param handle Handle to the region
+	@param owner The trigger that had added the region
+	*/
+	void remove(HANDLE handle, OBJECT_ID owner);
+
+	/**
+	Determines whether a region is still held by the trigger that added it
+	@param handle Handle to the region
+	@param owner The trigger that had added the region
+	@return true if the region is valid
+	*/
+	inline bool isRegion(HANDLE handle, OBJECT_ID owner) const
+	{
+		return isValid(handle) && regions[handle].owner == owner;
+	}
+
+	/**
+	Moves a region
+	@param handle Handle to the region
+	@param center The new center of the region
+	@param radius The new radius of the region
+	*/
+	void move(HANDLE handle, const vec3 &center, float radius);
+
+	/**
+	Gets the actors that occupied the region during the last update
+	@param handle Handle to the region
+	@return occupants of the region
+	*/
+	const vector<OBJECT_ID>& getOccupants(HANDLE handle) const;
+
+	/**
+	Registers an actor that may occupy regions
+	@param id The actor
+	@param type Kind of occupant (REGION_OCCUPANT_PLAYER or REGION_OCCUPANT_CREATURE)
+	*/
+	void addOccupant(OBJECT_ID id, REGION_OCCUPANT type);
+
+	/**
+	Bins all occupants and sends events to the owners of regions
+	@param objects The actors of the world; regions and occupants that have been removed are forgotten
+	*/
+	void update(ActorSet &objects);
+
+	/** Gets the number of grid cells that were occupied during the last update */
+	inline size_t getNumOccupiedCells(void) const
+	{
+		return numOccupiedCells;
+	}
+
+	/** Gets the number of occupant-region tests made during the last update */
+	inline size_t getNumTests(void) const
+	{
+		return numTests;
+	}
+
+	/** Gets the number of events sent during the last update */
+	inline size_t getNumEvents(void) const
+	{
+		return numEvents;
+	}
+
+	/** Gets the number of regions */
+	inline size_t getNumRegions(void) const
+	{
+		return regions.size() - freeRegions.size();
+	}
+
+private:
+	/** A circular region in the XZ-plane */
+	struct Region
+	{
+		/** The trigger that receives events, or INVALID_ID if the region is free */
+		OBJECT_ID owner;
+
+		/** Center of the region */
+		float x, z;
+
+		/** Radius of the region */
+		float radius;
+
+		/** Kinds of actors that may occupy the region */
+		unsigned int mask;
+
+		/** Range of grid cells that the region is binned into */
+		int minCellX, minCellZ, maxCellX, maxCellZ;
+
+		/** Occupants as of the last update */
+		vector<OBJECT_ID> inside;
+
+		/** Occupants found during the current update */
+		vector<OBJECT_ID> current;
+
+		/** Stamp of the last occupant tested against the region */
+		unsigned int testStamp;
+
+		/** true while the region is listed for event processing */
+		bool pending;
+	};
+
+	/** A registered occupant */
+	struct Occupant
+	{
+		OBJECT_ID id;
+		REGION_OCCUPANT type;
+	};
+
+	/**
+	Frees a region
+	@param index Index of the region
+	*/
+	void release(int index);
+
+	/**
+	Adds a region to the cells in its range
+	@param index Index of the region
+	*/
+	void bin(int index);
+
+	/**
+	Removes a region from the cells in its range
+	@param index Index of the region
+	*/
+	void unbin(int index);
+
+	/**
+	Calculates the range of cells covered by a circle
+	@param x Center of the circle
+	@param z Center of the circle
+	@param radius Radius of the circle
+	@param minX Returns the first column
+	@param minZ Returns the first row
+	@param maxX Returns the last column
+	@param maxZ Returns the last row
+	@return false if the circle lies entirely off the grid
+	*/
+	bool getCellRange(float x, float z, float radius, int &minX, int &minZ, int &maxX, int &maxZ) const;
+
+	/**
+	Determines whether the handle names a region in use
+	@param handle Handle to the region
+	*/
+	inline bool isValid(HANDLE handle) const
+	{
+		return handle>=0 && (size_t)handle<regions.size() && regions[handle].owner!=INVALID_ID;
+	}
+
+	/** All regions, indexed by handle */
+	vector<Region> regions;
+
+	/** Handles of free regions */
+	vector<int> freeRegions;
+
+	/** Region handles binned into each cell of the grid */
+	vector< vector<int> > cells;
+
+	/** Stamp of the last update that occupied each cell */
+	vector<unsigned int> cellStamps;
+
+	/** Registered occupants */
+	vector<Occupant> occupants;
+
+	/** Regions that had occupants as of the last update */
+	vector<int> activeRegions;
+
+	/** Width of the grid, in cells */
+	int columns;
+
+	/** Height of the grid, in cells */
+	int rows;
+
+	/** Meters along each side of a cell */
+	float cellMeters;
+
+	/** Incremented for each update */
+	unsigned int updateStamp;
+
+	/** Incremented for each occupant tested */
+	unsigned int testStamp;
+
+	/** The region checked for a missing owner during the last update */
+	size_t sweepIndex;
+
+	/** Statistics for the last update */
+	size_t numOccupiedCells, numTests, numEvents;
+};
+
+} // namespace Engine
+
+#endif
@@ -0,0 +1,235 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "stdafx.h"
+#include "gl.h"
+#include "StateCache.h"
+#include "Application.h"
+#include "EffectManager.h"
+#include "material.h"
+#include "mesh.h"
+#include "LightManager.h"
+#include "profile.h"
+#include "RenderQueue.h"
+
+namespace Engine {
+
+size_t RenderQueue::numItems = 0;
+size_t RenderQueue::numMaterialBinds = 0;
+size_t RenderQueue::numSkippedBinds = 0;
+
+RenderQueue::RenderQueue(void)
+{
+	clear();
+}
+
+void RenderQueue::clear(void)
+{
+	for(int i=0; i<NUM_BUCKETS; ++i)
+	{
+		buckets[i].clear();
+	}
+
+	currentLightSet = LightManager::GLOBAL_LIGHT_SET;
+
+	invalidateState();
+}
+
+void RenderQueue::invalidateState(void)
+{
+	boundMaterial = 0;
+	colorKnown = false;
+	boundLightSet = (size_t)-1;
+}
+
+RenderQueue::Item& RenderQueue::push(BUCKET bucket, const vec3 &position)
+{
+	ASSERT(bucket>=0 && bucket<NUM_BUCKETS, "bucket is invalid: " + itoa((int)bucket));
+
+	bool empty = true;
+	for(int i=0; i<NUM_BUCKETS; ++i)
+	{
+		empty = empty && buckets[i].empty();
+	}
+
+	if(empty)
+	{
+		eye = g_Camera.getPosition();
+	}
+
+	buckets[bucket].push_back(Item());
+
+	Item &item = buckets[bucket].back();
+	item.key = 0;
+	item.depth = vec3(position - eye).getMagnitudeSqr();
+	item.lightSet = currentLightSet;
+	item.material = 0;
+	item.mesh = 0;
+	item.color = white;
+	item.lit = true;
+
+	return item;
+}
+
+void RenderQueue::add(BUCKET bucket, const Mesh &mesh, const mat4 &transform, const COLOR &color, bool lit)
+{
+	Item &item = push(bucket, transform.getPos());
+	item.material = &mesh.material;
+	item.key = (size_t)mesh.material.getTexture(0);
+	item.mesh = &mesh;
+	item.transform = transform;
+	item.color = color;
+	item.lit = lit;
+}
+
+void RenderQueue::add(BUCKET bucket, const Material *material, const vec3 &position, const Callback &geometry)
+{
+	Item &item = push(bucket, position);
+	item.material = material;
+	item.key = material ? (size_t)material->getTexture(0) : 0;
+	item.callback = geometry;
+	item.transform.identity();
+}
+
+void RenderQueue::addCustom(BUCKET bucket, const vec3 &position, const Callback &draw)
+{
+	Item &item = push(bucket, position);
+	item.callback = draw;
+}
+
+bool RenderQueue::compareOpaque(const Item &a, const Item &b)
+{
+	if(a.lightSet != b.lightSet) return a.lightSet < b.lightSet;
+	if(a.key != b.key) return a.key < b.key;
+	if(a.material != b.material) return a.material < b.material;
+	return a.depth < b.depth;
+}
+
+bool RenderQueue::compareTransparent(const Item &a, const Item &b)
+{
+	return a.depth > b.depth;
+}
+
+void RenderQueue::flush(const LightManager *lights)
+{
+	PROFILE
+
+	CHECK_GL_ERROR();
+
+	invalidateState();
+	passLighting = g_StateCache.isEnabled(GL_LIGHTING);
+
+	execute(buckets[OPAQUE_BUCKET], true, lights);
+
+	if(!buckets[TRANSPARENT_BUCKET].empty())
+	{
+		g_StateCache.push();
+		g_StateCache.enable(GL_BLEND);
+		execute(buckets[TRANSPARENT_BUCKET], false, lights);
+		g_StateCache.pop();
+	}
+
+	// Leave the pass as it was found
+	if(colorKnown)
+	{
+		glColor4fv(white);
+	}
+
+	g_StateCache.setEnabled(GL_LIGHTING, passLighting);
+
+	clear();
+
+	CHECK_GL_ERROR();
+}
+
+void RenderQueue::execute(vector<Item> &items, bool opaque, const LightManager *lights)
+{
+	Effect &effect = EffectManager::GetSingleton().getEffect();
+
+	stable_sort(items.begin(), items.end(), opaque ? &compareOpaque : &compareTransparent);
+
+	for(vector<Item>::const_iterator i=items.begin(); i!=items.end(); ++i)
+	{
+		const Item &item = *i;
+
+		numItems++;
+
+		// Items that set up their own state may leave any of it changed
+		if(item.material==0 && item.mesh==0)
+		{
+			item.callback();
+			invalidateState();
+			continue;
+		}
+
+		const bool lighting = passLighting && item.lit;
+		g_StateCache.setEnabled(GL_LIGHTING, lighting);
+
+		// Lights are bound while the camera is the modelview, as items expect
+		if(lights!=0 && lighting && item.lightSet != boundLightSet)
+		{
+			lights->bindLightSet(item.lightSet);
+			boundLightSet = item.lightSet;
+		}
+
+		if(!colorKnown || !(currentColor == item.color))
+		{
+			glColor4fv(item.color);
+			currentColor = item.color;
+			colorKnown = true;
+		}
+
+		if(boundMaterial!=0 && boundMaterial->isEquivalent(*item.material))
+		{
+			numSkippedBinds++;
+		}
+		else
+		{
+			item.material->bind();
+			boundMaterial = item.material;
+			numMaterialBinds++;
+		}
+
+		if(item.mesh)
+		{
+			glPushMatrix();
+			glMultMatrixf(item.transform);
+			item.mesh->drawGeometry(effect);
+			glPopMatrix();
+		}
+		else
+		{
+			item.callback();
+		}
+	}
+}
+
+} // namespace Engine
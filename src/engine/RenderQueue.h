@@ -0,0 +1,240 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _RENDER_QUEUE_H_
+#define _RENDER_QUEUE_H_
+
+#include <boost/function.hpp>
+
+#include "mat4.h"
+#include "COLOR.h"
+
+namespace Engine {
+
+class Mesh;
+class Material;
+class LightManager;
+
+/**
+Collects the draws of one pass of the scene and executes them in an order
+that minimizes state changes. Opaque items are sorted by light set, then
+by texture and then by material, front to back within each material, so
+that lights and materials are only bound when they actually differ from
+the ones before them. Transparent
+items are drawn afterwards, back to front, with blending enabled.
+
+The Effect is fixed for the whole pass by the caller, so it is fetched
+once per flush rather than once per mesh.
+*/
+class RenderQueue
+{
+public:
+	/** Selects the order in which an item is drawn */
+	enum BUCKET
+	{
+		OPAQUE_BUCKET,
+		TRANSPARENT_BUCKET,
+		NUM_BUCKETS
+	};
+
+	/** Draws geometry using state that has already been set by the queue */
+	typedef boost::function<void (void)> Callback;
+
+	/** Constructor */
+	RenderQueue(void);
+
+	/** Discards all queued items without drawing them */
+	void clear(void);
+
+	/**
+	Queues a mesh. The mesh must stay valid until the queue is flushed.
+	@param bucket Opaque or transparent bucket
+	@param mesh The mesh to draw with its own material
+	@param transform Transformation from model-space into world-space
+	@param color Color to draw the mesh with
+	@param lit false if the mesh is to be drawn without lighting
+	*/
+	void add(BUCKET bucket, const Mesh &mesh, const mat4 &transform, const COLOR &color, bool lit);
+
+	/**
+	Queues geometry that is already in world-space and uses a material
+	@param bucket Opaque or transparent bucket
+	@param material The material to bind before the geometry is drawn
+	@param position World-space position, used to sort by depth
+	@param geometry Issues the draw call for the geometry
+	*/
+	void add(BUCKET bucket, const Material *material, const vec3 &position, const Callback &geometry);
+
+	/**
+	Queues a draw that sets up its own state and may change any of it
+	@param bucket Opaque or transparent bucket
+	@param position World-space position, used to sort by depth
+	@param draw Draws the item
+	*/
+	void addCustom(BUCKET bucket, const vec3 &position, const Callback &draw);
+
+	/**
+	Sets the light set of the items queued from now on
+	@param lightSet Light set selected by the LightManager
+	*/
+	inline void setLightSet(size_t lightSet)
+	{
+		currentLightSet = lightSet;
+	}
+
+	/**
+	Sorts and draws all queued items, then empties the queue
+	@param lights When not null, each lit item is drawn with its own light
+	set from this manager. Otherwise the lights are left as the pass set them.
+	*/
+	void flush(const LightManager *lights = 0);
+
+	/**
+	Gets the number of items drawn by all queues so far
+	@return items drawn since the program started
+	*/
+	static size_t getNumItems(void)
+	{
+		return numItems;
+	}
+
+	/**
+	Gets the number of times that a material was bound by all queues so far
+	@return material binds since the program started
+	*/
+	static size_t getNumMaterialBinds(void)
+	{
+		return numMaterialBinds;
+	}
+
+	/**
+	Gets the number of material binds skipped because the material was already bound
+	@return skipped binds since the program started
+	*/
+	static size_t getNumSkippedBinds(void)
+	{
+		return numSkippedBinds;
+	}
+
+private:
+	/** A queued draw */
+	struct Item
+	{
+		/** Primary sort key: identifies the texture of the material */
+		size_t key;
+
+		/** Squared distance from the camera */
+		float depth;
+
+		/** Lights to draw with */
+		size_t lightSet;
+
+		/** Material to bind, or null when the item binds its own state */
+		const Material *material;
+
+		/** Mesh to draw, or null when a callback draws the item */
+		const Mesh *mesh;
+
+		/** Draws the item, when it is not a mesh */
+		Callback callback;
+
+		/** Transformation into world-space (meshes only) */
+		mat4 transform;
+
+		/** Color to draw with */
+		COLOR color;
+
+		/** false if the item is drawn without lighting */
+		bool lit;
+	};
+
+	/**
+	Begins a new item in a bucket
+	@param bucket The bucket
+	@param position World-space position of the item
+	@return The new item
+	*/
+	Item& push(BUCKET bucket, const vec3 &position);
+
+	/**
+	Sorts and draws one bucket
+	@param items The items in the bucket
+	@param opaque true if the items are to be sorted by state, false to sort back to front
+	@param lights Binds the light set of each lit item, or null
+	*/
+	void execute(vector<Item> &items, bool opaque, const LightManager *lights);
+
+	/** Forget all cached state, as after a custom item has run */
+	void invalidateState(void);
+
+	/** Orders opaque items by light set, then texture, then material, then front to back */
+	static bool compareOpaque(const Item &a, const Item &b);
+
+	/** Orders transparent items back to front */
+	static bool compareTransparent(const Item &a, const Item &b);
+
+	/** Items queued in each bucket */
+	vector<Item> buckets[NUM_BUCKETS];
+
+	/** Camera position, captured when the first item is queued */
+	vec3 eye;
+
+	/** Material that is currently bound, or null if unknown */
+	const Material *boundMaterial;
+
+	/** Color that is currently set */
+	COLOR currentColor;
+
+	/** Whether the current color is known */
+	bool colorKnown;
+
+	/** Lighting state of the pass, restored after the queue is flushed */
+	bool passLighting;
+
+	/** Light set given to newly queued items */
+	size_t currentLightSet;
+
+	/** Light set that is currently bound, or -1 if unknown */
+	size_t boundLightSet;
+
+	/** Items drawn by all queues */
+	static size_t numItems;
+
+	/** Materials bound by all queues */
+	static size_t numMaterialBinds;
+
+	/** Material binds skipped by all queues */
+	static size_t numSkippedBinds;
+};
+
+} // namespace Engine
+
+#endif
@@ -0,0 +1,330 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+#include "object.h"
+#include "ActorFactory.h"
+#include "Scheduler.h"
+
+namespace Engine {
+
+Scheduler::Scheduler(void)
+{
+	clear();
+}
+
+void Scheduler::clear(void)
+{
+	slots.clear();
+	freeSlots.clear();
+	deadlines.clear();
+	interpolations.clear();
+	pendingByOwner.clear();
+	clock = 0.0;
+	nextSequence = 0;
+}
+
+CallbackHandle Scheduler::schedule(float delay, const Callback &fn, OBJECT_ID owner)
+{
+	return getHandle(allocate(delay, fn, owner));
+}
+
+CallbackHandle Scheduler::scheduleInterpolation(float *value,
+                                                float startingValue,
+                                                float endingValue,
+                                                float timeLimit,
+                                                const Callback &fn,
+                                                OBJECT_ID owner)
+{
+	ASSERT(value!=0, "value was null");
+
+	size_t index = allocate(timeLimit, fn, owner);
+	Slot &slot = slots[index];
+
+	slot.value = value;
+	slot.startingValue = startingValue;
+	slot.endingValue = endingValue;
+	slot.startTime = clock;
+	slot.timeLimit = timeLimit;
+	slot.interpolationIndex = interpolations.size();
+	interpolations.push_back(index);
+
+	(*value) = startingValue;
+
+	return getHandle(index);
+}
+
+size_t Scheduler::allocate(float delay, const Callback &fn, OBJECT_ID owner)
+{
+	size_t index = 0;
+
+	if(freeSlots.empty())
+	{
+		index = slots.size();
+		slots.push_back(Slot());
+		slots[index].generation = 1;
+	}
+	else
+	{
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+
+	Slot &slot = slots[index];
+	slot.fn = fn;
+	slot.owner = owner;
+	slot.inUse = true;
+	slot.value = 0;
+
+	if(owner != INVALID_ID)
+	{
+		pendingByOwner[owner]++;
+		wakeOwner(owner);
+	}
+
+	Deadline deadline;
+	deadline.time = clock + max(delay, 0.0f);
+	deadline.sequence = nextSequence++;
+	deadline.slot = index;
+	deadline.generation = slot.generation;
+
+	deadlines.push_back(deadline);
+	push_heap(deadlines.begin(), deadlines.end(), later_deadline());
+
+	return index;
+}
+
+void Scheduler::release(size_t index)
+{
+	Slot &slot = slots[index];
+
+	ASSERT(slot.inUse, "slot is not in use");
+
+	// Remove from the running interpolations with a swap-and-pop
+	if(slot.value)
+	{
+		size_t last = interpolations.back();
+		interpolations[slot.interpolationIndex] = last;
+		slots[last].interpolationIndex = slot.interpolationIndex;
+		interpolations.pop_back();
+		slot.value = 0;
+	}
+
+	if(slot.owner != INVALID_ID)
+	{
+		map<OBJECT_ID, size_t>::iterator iter = pendingByOwner.find(slot.owner);
+
+		ASSERT(iter != pendingByOwner.end(), "owner has no pending callbacks");
+
+		if(--(iter->second) == 0)
+		{
+			pendingByOwner.erase(iter);
+		}
+	}
+
+	slot.fn.clear();
+	slot.inUse = false;
+	slot.generation++; // invalidates handles and stale heap entries
+
+	freeSlots.push_back(index);
+}
+
+CallbackHandle Scheduler::getHandle(size_t index) const
+{
+	CallbackHandle handle;
+	handle.slot = index;
+	handle.generation = slots[index].generation;
+	return handle;
+}
+
+bool Scheduler::isPending(CallbackHandle handle) const
+{
+	return handle.slot < slots.size() &&
+	       slots[handle.slot].inUse &&
+	       slots[handle.slot].generation == handle.generation;
+}
+
+bool Scheduler::hasPending(OBJECT_ID owner) const
+{
+	if(owner == INVALID_ID)
+		return false;
+
+	return pendingByOwner.find(owner) != pendingByOwner.end();
+}
+
+bool Scheduler::cancel(CallbackHandle handle)
+{
+	if(!isPending(handle))
+		return false;
+
+	release(handle.slot);
+	return true;
+}
+
+void Scheduler::cancelAll(OBJECT_ID owner)
+{
+	if(owner == INVALID_ID || !hasPending(owner))
+		return;
+
+	for(size_t i=0; i<slots.size() && hasPending(owner); ++i)
+	{
+		if(slots[i].inUse && slots[i].owner == owner)
+		{
+			release(i);
+		}
+	}
+}
+
+bool Scheduler::isOwnerAlive(OBJECT_ID owner)
+{
+	if(owner == INVALID_ID)
+		return true;
+
+	const ActorFactory::mapHandleToObject &objects = getActorFactory().objects;
+	ActorFactory::mapHandleToObject::const_iterator iter = objects.find(owner);
+
+	return iter != objects.end() && !iter->second->zombie;
+}
+
+void Scheduler::wakeOwner(OBJECT_ID owner)
+{
+	const ActorFactory::mapHandleToObject &objects = getActorFactory().objects;
+	ActorFactory::mapHandleToObject::const_iterator iter = objects.find(owner);
+
+	if(iter != objects.end())
+	{
+		iter->second->wake();
+	}
+}
+
+void Scheduler::update(float deltaTime)
+{
+	clock += deltaTime;
+
+	// Step running interpolations, dropping any whose owner has died
+	for(size_t i=0; i<interpolations.size(); )
+	{
+		const Slot &slot = slots[interpolations[i]];
+
+		if(!isOwnerAlive(slot.owner))
+		{
+			release(interpolations[i]); // swaps another entry into i
+			continue;
+		}
+
+		// An interpolation with no duration is already at its end
+		float bias = 1.0f;
+
+		if(slot.timeLimit > 0.0)
+		{
+			bias = (float)min((clock - slot.startTime) / slot.timeLimit, 1.0);
+		}
+
+		(*slot.value) = slot.startingValue + bias*(slot.endingValue - slot.startingValue);
+		++i;
+	}
+
+	/*
+	Execute callbacks that have come due.  Callbacks scheduled while this
+	runs are left for the next update, even when their delay is zero, so a
+	callback that reschedules itself cannot keep the loop running forever.
+	Entries of equal time are ordered by sequence, and new entries are never
+	due earlier than the clock, so the first new entry at the front of the
+	heap marks the end of the pass.
+	*/
+	const double now = clock;
+	const unsigned int endSequence = nextSequence;
+
+	while(!deadlines.empty() &&
+	      deadlines.front().time <= now &&
+	      deadlines.front().sequence < endSequence)
+	{
+		const Deadline deadline = deadlines.front();
+		pop_heap(deadlines.begin(), deadlines.end(), later_deadline());
+		deadlines.pop_back();
+
+		Slot &slot = slots[deadline.slot];
+
+		// Skip entries for callbacks that have been cancelled
+		if(!slot.inUse || slot.generation != deadline.generation)
+			continue;
+
+		Callback fn;
+		fn.swap(slot.fn);
+		const OBJECT_ID owner = slot.owner;
+		const bool alive = isOwnerAlive(owner);
+
+		if(slot.value && alive)
+		{
+			(*slot.value) = slot.endingValue;
+		}
+
+		/*
+		Release the slot before executing the callback, as the
+		callback may schedule further callbacks of its own.
+		*/
+		release(deadline.slot);
+
+		if(fn && alive)
+		{
+			fn();
+		}
+	}
+
+	compact();
+}
+
+void Scheduler::compact(void)
+{
+	// Each pending callback has exactly one live entry in the heap
+	const size_t live = getNumPending();
+	const size_t dead = deadlines.size() - live;
+
+	if(dead < MIN_COMPACT_ENTRIES || dead <= live)
+		return;
+
+	size_t j = 0;
+
+	for(size_t i=0; i<deadlines.size(); ++i)
+	{
+		const Deadline &deadline = deadlines[i];
+		const Slot &slot = slots[deadline.slot];
+
+		if(slot.inUse && slot.generation == deadline.generation)
+		{
+			deadlines[j++] = deadline;
+		}
+	}
+
+	deadlines.resize(j);
+	make_heap(deadlines.begin(), deadlines.end(), later_deadline());
+}
+
+} // namespace Engine
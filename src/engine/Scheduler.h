@@ -0,0 +1,289 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include <boost/function.hpp>
+
+#include "Factory.h"
+
+namespace Engine {
+
+/**
+Identifies a callback that was scheduled with the Scheduler.
+Handles remain safe to use after the callback has fired or been cancelled;
+such a handle is simply no longer pending.
+*/
+struct CallbackHandle
+{
+	CallbackHandle(void)
+	: slot(0), generation(0)
+	{}
+
+	/** Index of the callback's slot in the scheduler pool */
+	size_t slot;
+
+	/** Generation of the slot when the callback was scheduled (zero is never valid) */
+	unsigned int generation;
+};
+
+/**
+Executes callbacks after a delay.
+Pending callbacks are kept in a min-heap ordered by deadline, so each tick
+only has to look at the front of the heap; when nothing is due the cost is
+constant.  Callbacks are stored in a pool of reusable slots and may be
+bound to the lifetime of an actor so that they are never executed after
+that actor has been deleted.  Scheduling a callback for an actor wakes it,
+and it stays awake while any of its callbacks are pending, so that it sees
+the changes made by those callbacks and interpolations.
+
+Interpolations are a special case: they also write to their value every
+tick until their deadline is reached, and so cost one step per tick while
+they are running.
+
+Cancelled callbacks leave a stale entry in the heap, which is normally
+dropped when its deadline passes.  When stale entries come to outnumber
+the live ones, the heap is compacted so that cancelling many long delays
+does not let it grow without bound.
+*/
+class Scheduler
+{
+public:
+	/** Type-erased callback function */
+	typedef boost::function<void (void)> Callback;
+
+	/** Constructor */
+	Scheduler(void);
+
+	/** Destroys all pending callbacks without executing them */
+	void clear(void);
+
+	/**
+	Schedules a callback to be executed after a delay
+	@param delay After this delay, the callback function is called (milliseconds)
+	@param fn The callback function
+	@param owner If not INVALID_ID, the callback is dropped if this actor no longer exists
+	@return Handle to the scheduled callback
+	*/
+	CallbackHandle schedule(float delay, const Callback &fn, OBJECT_ID owner = INVALID_ID);
+
+	/**
+	Interpolates a value over time and executes a callback once complete.
+	While the interpolator is running, the value should be considered read
+	only.  Writes to the value will be overwritten on the next update.
+	@param value Points to the value to modify
+	@param startingValue The starting value
+	@param endingValue The ending value
+	@param timeLimit The value will reach the end value at this time (milliseconds)
+	@param fn The callback function
+	@param owner If not INVALID_ID, the interpolation is dropped if this actor no longer exists
+	@return Handle to the scheduled callback
+	*/
+	CallbackHandle scheduleInterpolation(float *value,
+	                                     float startingValue,
+	                                     float endingValue,
+	                                     float timeLimit,
+	                                     const Callback &fn,
+	                                     OBJECT_ID owner = INVALID_ID);
+
+	/**
+	Cancels a pending callback
+	@param handle Handle to the callback
+	@return true if the callback was pending and has now been cancelled
+	*/
+	bool cancel(CallbackHandle handle);
+
+	/**
+	Cancels all pending callbacks bound to the lifetime of an actor
+	@param owner The actor
+	*/
+	void cancelAll(OBJECT_ID owner);
+
+	/**
+	Determines whether the callback is still waiting to be executed
+	@param handle Handle to the callback
+	@return true if the callback is pending
+	*/
+	bool isPending(CallbackHandle handle) const;
+
+	/**
+	Determines whether any callback bound to the lifetime of an actor is still waiting to be executed.
+	This is a lookup in the per-actor pending count, not a scan of the pool.
+	@param owner The actor
+	@return true if a callback is pending
+	*/
+	bool hasPending(OBJECT_ID owner) const;
+
+	/**
+	Advances the clock and executes all callbacks that have become due.
+	Callbacks scheduled by those callbacks are not executed until the next update.
+	@param deltaTime The milliseconds since the last tick
+	*/
+	void update(float deltaTime);
+
+	/**
+	Gets the number of callbacks waiting to be executed
+	@return number of pending callbacks
+	*/
+	inline size_t getNumPending(void) const
+	{
+		return slots.size() - freeSlots.size();
+	}
+
+private:
+	/** Stale heap entries are tolerated below this count, however few entries are live */
+	static const size_t MIN_COMPACT_ENTRIES = 64;
+
+	/** A pooled callback */
+	struct Slot
+	{
+		/** The callback function */
+		Callback fn;
+
+		/** Actor that the callback is bound to, or INVALID_ID */
+		OBJECT_ID owner;
+
+		/** Incremented each time the slot is released */
+		unsigned int generation;
+
+		/** true while the slot holds a pending callback */
+		bool inUse;
+
+		/** Interpolated value, or NULL if this is not an interpolation */
+		float *value;
+
+		/** Interpolation starting value */
+		float startingValue;
+
+		/** Interpolation ending value */
+		float endingValue;
+
+		/** Time when the interpolation began (milliseconds) */
+		double startTime;
+
+		/** Duration of the interpolation (milliseconds) */
+		double timeLimit;
+
+		/** Index into the list of running interpolations */
+		size_t interpolationIndex;
+	};
+
+	/** Entry in the deadline heap */
+	struct Deadline
+	{
+		/** The time at which the callback is due (milliseconds) */
+		double time;
+
+		/** Breaks ties so that callbacks due at the same time run in the order they were scheduled */
+		unsigned int sequence;
+
+		/** Slot holding the callback */
+		size_t slot;
+
+		/** Generation of the slot; the entry is stale if this does not match */
+		unsigned int generation;
+	};
+
+	/** Orders the heap so that the earliest deadline is at the front */
+	struct later_deadline
+	{
+		bool operator()(const Deadline &left, const Deadline &right) const
+		{
+			if(left.time == right.time)
+				return left.sequence > right.sequence;
+
+			return left.time > right.time;
+		}
+	};
+
+	/**
+	Places a callback in a free slot and records its deadline
+	@param delay Delay before the callback is due (milliseconds)
+	@param fn The callback function
+	@param owner The owning actor, or INVALID_ID
+	@return Index of the slot
+	*/
+	size_t allocate(float delay, const Callback &fn, OBJECT_ID owner);
+
+	/** Removes stale entries from the deadline heap once they outnumber the live entries */
+	void compact(void);
+
+	/**
+	Returns a slot to the pool, invalidating all handles to it
+	@param index Index of the slot
+	*/
+	void release(size_t index);
+
+	/**
+	Determines whether the owning actor of a callback is still alive
+	@param owner The actor
+	@return true if the callback may still be executed
+	*/
+	static bool isOwnerAlive(OBJECT_ID owner);
+
+	/**
+	Wakes the owning actor of a callback, if it exists
+	@param owner The actor
+	*/
+	static void wakeOwner(OBJECT_ID owner);
+
+	/**
+	Gets a handle to the callback in the slot
+	@param index Index of the slot
+	@return handle
+	*/
+	CallbackHandle getHandle(size_t index) const;
+
+	/** Pool of callback slots */
+	vector<Slot> slots;
+
+	/** Indices of free slots */
+	vector<size_t> freeSlots;
+
+	/** Min-heap of deadlines */
+	vector<Deadline> deadlines;
+
+	/** Slots of interpolations that are currently running */
+	vector<size_t> interpolations;
+
+	/** Number of pending callbacks bound to each actor */
+	map<OBJECT_ID, size_t> pendingByOwner;
+
+	/** Milliseconds since the scheduler was created */
+	double clock;
+
+	/** Sequence number of the next scheduled callback */
+	unsigned int nextSequence;
+};
+
+} // namespace Engine
+
+#endif
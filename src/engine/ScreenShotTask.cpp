@@ -29,14 +29,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h"
-
-/*
-Include the DevIL headers
-*/
-#define ILUT_USE_OPENGL
-#include <IL/il.h>
-#include <IL/ilut.h>
-
+#include <zlib.h>
+#include "gl.h"
+#include "SDLwindow.h"
 #include "ScreenShotTask.h"
 #include "searchfile.h"
 
@@ -44,11 +39,200 @@ namespace Engine {
 
 int stoi(const string &s); // stdafx.cpp
 
-ScreenShotTask::ScreenShotTask(void) : screenShotDebounce(false)
-{ /* do nothing */ }
+int ScreenShotTask::burstInterval = 10;
+
+/**
+Appends a big-endian 32-bit integer
+@param out Receives the bytes
+@param value The integer
+*/
+static void putInt(vector<unsigned char> &out, unsigned long value)
+{
+	out.push_back((unsigned char)((value >> 24) & 0xff));
+	out.push_back((unsigned char)((value >> 16) & 0xff));
+	out.push_back((unsigned char)((value >> 8) & 0xff));
+	out.push_back((unsigned char)(value & 0xff));
+}
+
+/**
+Writes a PNG chunk to file
+@param file The file
+@param type Four letter chunk type
+@param data Chunk data
+@return true if successful
+*/
+static bool writeChunk(FILE *file, const char *type, const vector<unsigned char> &data)
+{
+	vector<unsigned char> header;
+	putInt(header, (unsigned long)data.size());
+	header.insert(header.end(), type, type + 4);
+
+	uLong crc = crc32(0L, &header[4], 4);
+	if(!data.empty())
+	{
+		crc = crc32(crc, &data[0], (uInt)data.size());
+	}
+
+	vector<unsigned char> footer;
+	putInt(footer, crc);
+
+	return fwrite(&header[0], 1, header.size(), file) == header.size() &&
+	       (data.empty() || fwrite(&data[0], 1, data.size(), file) == data.size()) &&
+	       fwrite(&footer[0], 1, footer.size(), file) == footer.size();
+}
+
+/**
+Writes an RGB image as a PNG file.
+This is called on the worker thread, so it compresses with zlib directly
+rather than through DevIL, which the main thread uses to load textures.
+@param fileName File to write
+@param width Width of the image
+@param height Height of the image
+@param pixels Rows of RGB pixels, bottom row first
+@return true if successful
+*/
+static bool writePNG(const string &fileName, int width, int height, const vector<unsigned char> &pixels)
+{
+	static const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+	const size_t rowLength = (size_t)width * 3;
+
+	// Scanlines, top row first, each with a leading filter type of "none"
+	vector<unsigned char> raw;
+	raw.reserve((rowLength + 1) * height);
+	for(int row=height-1; row>=0; --row)
+	{
+		raw.push_back(0);
+		raw.insert(raw.end(), pixels.begin() + row*rowLength, pixels.begin() + (row+1)*rowLength);
+	}
+
+	// The image data is a single zlib stream
+	uLongf compressedLength = compressBound((uLong)raw.size());
+	vector<unsigned char> idat(compressedLength);
+
+	if(compress2(&idat[0], &compressedLength, &raw[0], (uLong)raw.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+		return false;
+
+	idat.resize(compressedLength);
+
+	vector<unsigned char> ihdr;
+	putInt(ihdr, (unsigned long)width);
+	putInt(ihdr, (unsigned long)height);
+	ihdr.push_back(8); // bit depth
+	ihdr.push_back(2); // truecolor
+	ihdr.push_back(0); // deflate
+	ihdr.push_back(0); // adaptive filtering
+	ihdr.push_back(0); // no interlace
+
+	FILE *file = fopen(fileName.c_str(), "wb");
+	if(!file)
+		return false;
+
+	const bool ok = fwrite(signature, 1, sizeof(signature), file) == sizeof(signature) &&
+	                writeChunk(file, "IHDR", ihdr) &&
+	                writeChunk(file, "IDAT", idat) &&
+	                writeChunk(file, "IEND", vector<unsigned char>());
+
+	return (fclose(file) == 0) && ok;
+}
+
+ScreenShotTask::ScreenShotTask(void)
+: usePixelBuffers(false),
+  nextNumber(1),
+  directoryCreated(false),
+  burst(false),
+  burstFrame(0),
+  numDropped(0),
+  numFailed(0),
+  numFailedReported(0),
+  jobLock(0),
+  jobReady(0),
+  quit(false),
+  encoder(0),
+  screenShotDebounce(false),
+  burstDebounce(false)
+{
+	// Find the number to continue from, once, rather than for every screen shot
+	const string screen = string("screen");
+	const string ext = string(".png");
+
+	vector<string> files = SearchFile("sshots/", ext);
+
+	for(vector<string>::const_iterator iter = files.begin();
+	    iter != files.end(); ++iter)
+	{
+		const string &fileName = (*iter);
+		const string strNum = fileName.substr(screen.length(),
+		fileName.length() - screen.length() - ext.length());
+		const int number = stoi(strNum);
+
+		if(number>=nextNumber) {
+			nextNumber = number+1;
+		}
+	}
+
+	usePixelBuffers = g_bUseVertexBufferObjects &&
+	                  glewIsExtensionSupported("GL_ARB_pixel_buffer_object")==GL_TRUE;
+
+	for(int i=0; i<NUM_READBACKS; ++i)
+	{
+		readbacks[i].buffer = 0;
+		readbacks[i].inUse = false;
+		readbacks[i].framesLeft = 0;
+		readbacks[i].job = 0;
+
+		if(usePixelBuffers)
+		{
+			glGenBuffersARB(1, &readbacks[i].buffer);
+		}
+	}
+
+	jobLock = SDL_CreateMutex();
+	jobReady = SDL_CreateCond();
+	encoder = SDL_CreateThread(&ScreenShotTask::encoderThread, this);
+
+	if(!encoder)
+	{
+		TRACE("Failed to start the screen shot thread, screen shots will be written as they are taken");
+	}
+}
+
+ScreenShotTask::~ScreenShotTask(void)
+{
+	collectReadbacks(true);
+
+	if(usePixelBuffers)
+	{
+		for(int i=0; i<NUM_READBACKS; ++i)
+		{
+			glDeleteBuffersARB(1, &readbacks[i].buffer);
+		}
+	}
+
+	// Let the worker thread finish the queue
+	SDL_LockMutex(jobLock);
+	quit = true;
+	SDL_CondSignal(jobReady);
+	SDL_UnlockMutex(jobLock);
+
+	if(encoder)
+	{
+		SDL_WaitThread(encoder, 0);
+	}
+
+	SDL_DestroyCond(jobReady);
+	SDL_DestroyMutex(jobLock);
+}
+
+void ScreenShotTask::setBurstInterval(int frames)
+{
+	burstInterval = max(frames, 1);
+}
 
 void ScreenShotTask::update(float)
 {
+	collectReadbacks(false);
+
 	// Take a screen shot and save it to file
 	if(g_Keys.isKeyDown(KEY_SCREENSHOT)) {
 		if(screenShotDebounce == false) {
@@ -58,67 +242,192 @@ void ScreenShotTask::update(float)
 	} else {
 		screenShotDebounce = false;
 	}
+
+	// Toggle capturing every Nth frame
+	if(g_Keys.isKeyDown(KEY_SCREENSHOT_BURST)) {
+		if(burstDebounce == false) {
+			burstDebounce = true;
+			burst = !burst;
+			burstFrame = 0;
+			TRACE(burst ? "Screen shot burst started" : "Screen shot burst stopped");
+		}
+	} else {
+		burstDebounce = false;
+	}
+
+	if(burst && (burstFrame++ % burstInterval) == 0) {
+		takeScreenShot();
+	}
+
+	// Failures are found on the worker thread, but reported here
+	SDL_LockMutex(jobLock);
+	const size_t failed = numFailed;
+	SDL_UnlockMutex(jobLock);
+
+	if(failed != numFailedReported) {
+		TRACE("Failed to write " + itoa((int)(failed - numFailedReported)) + " screen shot(s)");
+		numFailedReported = failed;
+	}
 }
 
 void ScreenShotTask::takeScreenShot(void)
 {
-	ILuint ViewPort[4] = { 0 };
-	ILuint handle = 0;
-	ILubyte * data = NULL;
+	Readback *readback = 0;
 
-	ilGenImages(1, &handle);
-	ilBindImage(handle);
+	for(int i=0; i<NUM_READBACKS && !readback; ++i)
+	{
+		if(!readbacks[i].inUse)
+		{
+			readback = &readbacks[i];
+		}
+	}
 
-	glGetIntegerv(GL_VIEWPORT, (GLint*)ViewPort);
+	SDL_LockMutex(jobLock);
+	const size_t pending = jobs.size();
+	SDL_UnlockMutex(jobLock);
 
-	if(!ilTexImage(ViewPort[2], ViewPort[3], 1, 3,
-		IL_RGB, IL_UNSIGNED_BYTE, NULL)) {
+	// Rather than stall, drop the screen shot when the pipeline is full
+	if(!readback || pending >= MAX_PENDING_JOBS)
+	{
+		numDropped++;
+		TRACE("Dropped a screen shot, " + itoa((int)numDropped) + " dropped so far");
 		return;
 	}
 
-	ilSetInteger(IL_ORIGIN_MODE, IL_ORIGIN_LOWER_LEFT);
+	if(!directoryCreated)
+	{
+		createDirectory("sshots/");
+		directoryCreated = true;
+	}
+
+	// The scene is always drawn to the whole window
+	Job *job = new Job;
+	job->fileName = getScreenShotFileName();
+	job->width = (int)SDLWindow::GetSingleton().GetWidth();
+	job->height = (int)SDLWindow::GetSingleton().GetHeight();
 
-	data = ilGetData(); // direct RW pointer to the IL image buffer
+	const size_t size = (size_t)job->width * job->height * 3;
 
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
-	glReadPixels(0, 0, ViewPort[2], ViewPort[3], GL_RGB, GL_UNSIGNED_BYTE,
-	             data);
 
-	createDirectory("sshots/");
+	if(usePixelBuffers)
+	{
+		// Start the transfer and come back for it once it has completed
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readback->buffer);
+		glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, (GLsizeiptrARB)size, 0, GL_STREAM_READ_ARB);
+		glReadPixels(0, 0, job->width, job->height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
 
-	// Save the image to file
+		readback->inUse = true;
+		readback->framesLeft = READBACK_LATENCY;
+		readback->job = job;
+	}
+	else
 	{
-		char * pszScreenShotFileName = strdup(getScreenShotFileName());
-		ilSaveImage(pszScreenShotFileName);
-		delete [] pszScreenShotFileName;
+		job->pixels.resize(size);
+		glReadPixels(0, 0, job->width, job->height, GL_RGB, GL_UNSIGNED_BYTE, &job->pixels[0]);
+		queueJob(job);
 	}
 
-	ilDeleteImages(1, &handle);
+	CHECK_GL_ERROR();
 }
 
-string ScreenShotTask::getScreenShotFileName(void)
+void ScreenShotTask::collectReadbacks(bool all)
 {
-	int highestNumber = 0;
+	for(int i=0; i<NUM_READBACKS; ++i)
+	{
+		Readback &readback = readbacks[i];
 
-	const string screen = string("screen");
-	const string ext = string(".jpg");
+		if(!readback.inUse || (!all && --readback.framesLeft > 0))
+			continue;
 
-	vector<string> files = SearchFile("sshots/", ext);
+		Job *job = readback.job;
+		const size_t size = (size_t)job->width * job->height * 3;
 
-	for(vector<string>::const_iterator iter = files.begin();
-	    iter != files.end(); ++iter)
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readback.buffer);
+
+		const unsigned char *pixels = (const unsigned char*)glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+
+		if(pixels)
+		{
+			job->pixels.assign(pixels, pixels + size);
+			glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+			queueJob(job);
+		}
+		else
+		{
+			TRACE("Failed to map the screen shot buffer for " + job->fileName);
+			delete job;
+		}
+
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+		readback.inUse = false;
+		readback.job = 0;
+	}
+}
+
+void ScreenShotTask::queueJob(Job *job)
+{
+	if(!encoder)
 	{
-		const string &fileName = (*iter);
-		const string strNum = fileName.substr(screen.length(),
-		fileName.length() - screen.length() - ext.length());
-		const int number = stoi(strNum);
+		if(!writePNG(job->fileName, job->width, job->height, job->pixels))
+		{
+			TRACE("Failed to write screen shot " + job->fileName);
+		}
 
-		if(number>highestNumber) {
-			highestNumber = number;
+		delete job;
+		return;
+	}
+
+	SDL_LockMutex(jobLock);
+	jobs.push(job);
+	SDL_CondSignal(jobReady);
+	SDL_UnlockMutex(jobLock);
+}
+
+int ScreenShotTask::encoderThread(void *data)
+{
+	ScreenShotTask &task = *reinterpret_cast<ScreenShotTask*>(data);
+
+	while(true)
+	{
+		SDL_LockMutex(task.jobLock);
+
+		while(task.jobs.empty() && !task.quit)
+		{
+			SDL_CondWait(task.jobReady, task.jobLock);
+		}
+
+		if(task.jobs.empty())
+		{
+			SDL_UnlockMutex(task.jobLock);
+			break;
+		}
+
+		Job *job = task.jobs.front();
+		task.jobs.pop();
+
+		SDL_UnlockMutex(task.jobLock);
+
+		// The logger belongs to the main thread, so only count failures here
+		const bool ok = writePNG(job->fileName, job->width, job->height, job->pixels);
+		delete job;
+
+		if(!ok)
+		{
+			SDL_LockMutex(task.jobLock);
+			task.numFailed++;
+			SDL_UnlockMutex(task.jobLock);
 		}
 	}
 
-	return string("sshots/screen") + itoa(++highestNumber) + ext;
+	return 0;
+}
+
+string ScreenShotTask::getScreenShotFileName(void)
+{
+	return string("sshots/screen") + itoa(nextNumber++) + ".png";
 }
 
 } //namespace Engine
@@ -31,35 +31,168 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _SCREENSHOT_TASK_H_
 #define _SCREENSHOT_TASK_H_
 
+#include <SDL/SDL_thread.h>
+#include "gl.h"
 #include "task.h"
 
 namespace Engine {
 
-/** Listens for and handles screen shot events */
+/**
+Listens for and handles screen shot events.
+Capturing never stalls the frame: the back buffer is read into a pixel
+buffer object and collected a couple of frames later, and the PNG file
+is written by a worker thread. In burst mode, every Nth frame is saved.
+*/
 class ScreenShotTask : public Task
 {
 public:
 	/** Constructor */
 	ScreenShotTask(void);
 
+	/** Destructor. Saves any screen shots still in flight */
+	~ScreenShotTask(void);
+
 	/**
 	Polls for screen shot events
 	@param deltaTime The milliseconds since the last update
 	*/
 	void update(float deltaTime);
 
+	/**
+	Sets the number of frames between captures in burst mode
+	@param frames Frames between captures, at least one
+	*/
+	static void setBurstInterval(int frames);
+
+	/**
+	Gets the number of frames between captures in burst mode
+	@return Frames between captures
+	*/
+	static int getBurstInterval(void)
+	{
+		return burstInterval;
+	}
+
 private:
+	/** Number of readbacks that may be in flight at once */
+	enum { NUM_READBACKS = 3 };
+
+	/** Frames to wait before collecting a readback */
+	enum { READBACK_LATENCY = 2 };
+
+	/** Number of screen shots that may wait to be written */
+	enum { MAX_PENDING_JOBS = 16 };
+
+	/** A screen shot waiting to be written to file */
+	struct Job
+	{
+		/** File to write */
+		string fileName;
+
+		/** Width of the image */
+		int width;
+
+		/** Height of the image */
+		int height;
+
+		/** Rows of RGB pixels, bottom row first */
+		vector<unsigned char> pixels;
+	};
+
+	/** A capture waiting for its pixels to arrive from the GPU */
+	struct Readback
+	{
+		/** Pixel buffer object, or zero if not supported */
+		GLuint buffer;
+
+		/** Whether a capture is in flight */
+		bool inUse;
+
+		/** Frames left until the pixels are collected */
+		int framesLeft;
+
+		/** The screen shot, pixels not yet filled in when using a pixel buffer object */
+		Job *job;
+	};
+
 	/**
 	Gets the filename of the next screen shot
 	@return filename
 	*/
-	static string getScreenShotFileName(void);
+	string getScreenShotFileName(void);
+
+	/** Starts capturing the current frame */
+	void takeScreenShot(void);
+
+	/**
+	Collects the readbacks that are due
+	@param all Collect every readback in flight, whether due or not
+	*/
+	void collectReadbacks(bool all);
+
+	/**
+	Hands a screen shot to the worker thread
+	@param job The screen shot, which the worker thread deletes
+	*/
+	void queueJob(Job *job);
+
+	/**
+	Writes screen shots to file until told to quit
+	@param data The ScreenShotTask
+	@return zero
+	*/
+	static int encoderThread(void *data);
+
+	/** Frames between captures in burst mode */
+	static int burstInterval;
+
+	/** Readbacks in flight */
+	Readback readbacks[NUM_READBACKS];
+
+	/** Whether pixel buffer objects are used for readback */
+	bool usePixelBuffers;
+
+	/** Number of the next screen shot file */
+	int nextNumber;
 
-	/** takes a screen shot */
-	static void takeScreenShot(void);
+	/** Whether the screen shot directory has been created */
+	bool directoryCreated;
+
+	/** Whether burst mode is on */
+	bool burst;
+
+	/** Frames counted since burst mode started */
+	int burstFrame;
+
+	/** Screen shots dropped because the pipeline was full */
+	size_t numDropped;
+
+	/** Screen shots the worker thread failed to write */
+	size_t numFailed;
+
+	/** Failed writes reported so far */
+	size_t numFailedReported;
+
+	/** Screen shots waiting for the worker thread */
+	queue<Job*> jobs;
+
+	/** Guards jobs, numFailed, and quit */
+	SDL_mutex *jobLock;
+
+	/** Signalled when a job is queued or the worker thread must quit */
+	SDL_cond *jobReady;
+
+	/** Tells the worker thread to quit once the queue is empty */
+	bool quit;
+
+	/** The worker thread */
+	SDL_Thread *encoder;
 
 	/** Keeps the screenshot key from bouncing */
 	bool screenShotDebounce;
+
+	/** Keeps the burst key from bouncing */
+	bool burstDebounce;
 };
 
 } // namespace Engine
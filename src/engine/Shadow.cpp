@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "frustum.h"
 #include "world.h"
 #include "Shadow.h"
@@ -45,87 +46,94 @@ void Shadow::clear(void)
 	lightViewMatrix.identity();
 	textureMatrix.identity();
 	shadowMapSize = 0;
-	shadowMapTexture = 0;
+	atlas = 0;
+	tile = 0;
 	actorID = INVALID_ID;
 	light = 0;
 	periodicTimer = 0.0f;
 	receivers.clear();
+	needsUpdate = true;
+	casterChanged = false;
+	timeSinceUpdate = 0.0f;
 }
 
 void Shadow::destroy(void)
 {
-	release();
 	clear();
 }
 
-void Shadow::create(void)
+void Shadow::create(const ShadowAtlas *atlas, size_t tile)
 {
-	shadowMapSize = 128;
+	ASSERT(atlas!=0, "atlas was null");
+	ASSERT(tile < atlas->getNumTiles(), "tile is invalid: " + itoa((int)tile));
 
-	reaquire();
+	this->atlas = atlas;
+	this->tile = tile;
+	shadowMapSize = atlas->getTileSize();
+	needsUpdate = true;
 }
 
-void Shadow::release(void)
+void Shadow::update(const ActorSet &zoneActors, float deltaTime)
 {
-	GLuint t = shadowMapTexture;
-	glDeleteTextures(1, &t);
-	shadowMapTexture = 0;
+	if(atlas!=0 && light!=0 && zoneActors.isMember(actorID))
+	{
+		const Actor &actor = zoneActors.get(actorID);
+
+		// The shadow map is out of date when the caster has changed
+		casterChanged |= (actor.hasAnimated || actor.hasMoved);
+
+		timeSinceUpdate += deltaTime;
+
+		// Periodically take some time to determine the actors that be receiving this shadow
+		periodicTimer-=deltaTime;
+		if(periodicTimer<0)
+		{
+			periodicTimer = 250.0f + FRAND_RANGE(100.0f, 250.0f); // stagger
+			receivers = calculateReceivers(zoneActors, lightProjectionMatrix, lightViewMatrix);
+		}
+	}
 }
 
-void Shadow::reaquire(void)
+bool Shadow::render(const ActorSet &zoneActors)
 {
-	GLuint t = shadowMapTexture;
-	glGenTextures(1, &t);
-	glBindTexture(GL_TEXTURE_2D, t);
+	if(atlas==0 || light==0 || !zoneActors.isMember(actorID))
+		return false;
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowMapSize, shadowMapSize,
-	             0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, 0);
+	const Actor &actor = zoneActors.get(actorID);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	float lx=0, ly=0;
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-}
+	calculateAngularSpread(actor, lightViewMatrix, lx, ly);
 
-void Shadow::update(const ActorSet &zoneActors, float deltaTime)
-{
-	if(light!=0 && zoneActors.isMember(actorID))
-	{
-		const Actor &actor = zoneActors.get(actorID);
+	calculateMatrices(*light, actor, shadowMapSize, lightProjectionMatrix, lightViewMatrix, textureMatrix, atlas->getTileMatrix(tile), lx, ly);
 
-		// Update the shadow when something has changed
-		needsUpdate |= (actor.hasAnimated || actor.hasMoved);
+	frustum = calculateFrustum(lightProjectionMatrix, lightViewMatrix);
 
-		// Update when necessary or requested
-		if(needsUpdate)
-		{
-			float lx=0, ly=0;
+	if(g_Application.displayDebugData)
+	{
+		calculateFrustumVertices(*light, actor, lx, ly, ntl, ntr, nbl, nbr, ftl, ftr, fbl, fbr);
+	}
 
-			calculateAngularSpread(actor, lightViewMatrix, lx, ly);
+	renderToShadow(*atlas, tile, actor, lightProjectionMatrix, lightViewMatrix);
 
-			calculateMatrices(*light, actor, shadowMapSize, lightProjectionMatrix, lightViewMatrix, textureMatrix, lx, ly);
+	needsUpdate = false;
+	casterChanged = false;
+	timeSinceUpdate = 0.0f;
 
-			frustum = calculateFrustum(lightProjectionMatrix, lightViewMatrix);
+	return true;
+}
 
-			if(g_Application.displayDebugData)
-			{
-				calculateFrustumVertices(*light, actor, lx, ly, ntl, ntr, nbl, nbr, ftl, ftr, fbl, fbr);
-			}
+float Shadow::calculateScreenImpact(const ActorSet &zoneActors, const vec3 &eye, float tanHalfFovy) const
+{
+	if(!zoneActors.isMember(actorID))
+		return 0.0f;
 
-			renderToShadow(shadowMapTexture, shadowMapSize, actor, lightProjectionMatrix, lightViewMatrix);
+	const Actor &actor = zoneActors.get(actorID);
 
-			needsUpdate=false;
-		}
+	const vec3 delta = actor.getPos() - eye;
+	const float distance = max(sqrtf(delta.x*delta.x + delta.y*delta.y + delta.z*delta.z), 0.01f);
 
-		// Periodically take some time to determine the actors that be receiving this shadow
-		periodicTimer-=deltaTime;
-		if(periodicTimer<0)
-		{
-			periodicTimer = 250.0f + FRAND_RANGE(100.0f, 250.0f); // stagger
-			receivers = calculateReceivers(zoneActors, lightProjectionMatrix, lightViewMatrix);
-		}
-	}
+	return actor.getSphereRadius() / (distance * tanHalfFovy);
 }
 
 ActorSet Shadow::calculateReceivers(const ActorSet &zoneActors, const mat4& lightProjectionMatrix, const mat4& lightViewMatrix)
@@ -156,22 +164,14 @@ void Shadow::setLight(const Light *light)
 	}
 }
 
-void Shadow::calculateMatrices(const Light &light, const Actor &actor, int shadowMapSize, mat4& lightProjectionMatrix, mat4& lightViewMatrix, mat4& textureMatrix, float lx, float ly)
+void Shadow::calculateMatrices(const Light &light, const Actor &actor, int shadowMapSize, mat4& lightProjectionMatrix, mat4& lightViewMatrix, mat4& textureMatrix, const mat4& tileMatrix, float lx, float ly)
 {
 	const vec3 &lightPosition = light.getPosition();
 	const vec3 &lightCenter = actor.getPos();
 	const vec3 lightUp(0.0f, 1.0f, 0.0f);
 
 // Calculate the model-view matrix
-	glMatrixMode(GL_MODELVIEW);
-	glPushMatrix();
-	glLoadIdentity();
-	gluLookAt(	lightPosition.x,	lightPosition.y,	lightPosition.z,
-				lightCenter.x,		lightCenter.y,		lightCenter.z,
-				lightUp.x,			lightUp.y,			lightUp.z);
-	lightViewMatrix.zero();
-	glGetFloatv(GL_MODELVIEW_MATRIX, lightViewMatrix);
-	glPopMatrix();
+	lightViewMatrix.lookAt(lightPosition, lightCenter, lightUp);
 
 // Calculate the projection matrix
 	// row 1
@@ -204,8 +204,8 @@ void Shadow::calculateMatrices(const Light &light, const Actor &actor, int shado
 						0.5f, 0.5f, 0.5f, 1.0f};	//bias from [-1, 1] to [0, 1]
 	mat4 biasMatrix = biasMatrixf;
 
-	// Calculate the texture matrix
-	textureMatrix = biasMatrix * lightProjectionMatrix * lightViewMatrix;
+	// Calculate the texture matrix, landing in the shadow's tile of the atlas
+	textureMatrix = tileMatrix * biasMatrix * lightProjectionMatrix * lightViewMatrix;
 }
 
 Frustum Shadow::calculateFrustum(const mat4& lightProjectionMatrix, const mat4& lightViewMatrix)
@@ -252,58 +252,55 @@ void Shadow::calculateFrustumVertices(const Light &light, const Actor &actor, fl
 	fbr = fc - Y * fh + X * fw;
 }
 
-void Shadow::renderToShadow(unsigned int shadowMapTexture, int shadowMapSize, const Actor &actor, const mat4& lightProjectionMatrix, const mat4& lightViewMatrix)
+void Shadow::renderToShadow(const ShadowAtlas &atlas, size_t tile, const Actor &actor, const mat4& lightProjectionMatrix, const mat4& lightViewMatrix)
 {
 CHECK_GL_ERROR();
 
-	glClear(GL_DEPTH_BUFFER_BIT);
-
 	effect_Begin(effect_CLASS_PROJECT_SHADOWS);
 
-			glMatrixMode(GL_PROJECTION);
+			g_StateCache.matrixMode(GL_PROJECTION);
 			glPushMatrix();
 			glLoadMatrixf(lightProjectionMatrix);
 
-			glMatrixMode(GL_MODELVIEW);
+			g_StateCache.matrixMode(GL_MODELVIEW);
 			glPushMatrix();
 			glLoadMatrixf(lightViewMatrix);
 
-			//Use viewport the same size as the shadow map
-			glViewport(0, 0, shadowMapSize, shadowMapSize);
+			//Restrict rendering to the shadow's tile
+			atlas.beginTile(tile);
 
 			//Draw the scene
 			actor.drawObjectToDepthBuffer();
 
-			//Read the depth buffer into the shadow map texture
-			glBindTexture(GL_TEXTURE_2D, shadowMapTexture);
-			glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, shadowMapSize, shadowMapSize);
+			//Resolve the tile (copies the depth buffer when there is no FBO)
+			atlas.endTile(tile);
 
 			// Pop the modelview matrix we set up
 			glPopMatrix();
 
 			// pop the projection matrix we set up
-			glMatrixMode(GL_PROJECTION);
+			g_StateCache.matrixMode(GL_PROJECTION);
 			glPopMatrix();
 
 			// go back to modelview mode
-			glMatrixMode(GL_MODELVIEW);
+			g_StateCache.matrixMode(GL_MODELVIEW);
 
 	effect_End();
 
 CHECK_GL_ERROR();
 }
 
-void Shadow::bind(const ActorSet &zoneActors, unsigned int textureUnit) const
+bool Shadow::bind(const ActorSet &zoneActors, unsigned int textureUnit) const
 {
-	if(light!=0 && zoneActors.isMember(actorID))
+	if(atlas!=0 && light!=0 && zoneActors.isMember(actorID))
 	{
 		CHECK_GL_ERROR();
 
 		// Bind shadow texture
-		glActiveTextureARB(textureStages[textureUnit]);
-		glClientActiveTextureARB(textureStages[textureUnit]);
-		glBindTexture(GL_TEXTURE_2D, shadowMapTexture);
-		glEnable(GL_TEXTURE_2D);
+		g_StateCache.activeTexture(textureStages[textureUnit]);
+		g_StateCache.clientActiveTexture(textureStages[textureUnit]);
+		g_StateCache.bindTexture(atlas->getTexture());
+		g_StateCache.enable(GL_TEXTURE_2D);
 
 		// Define the matrix
 		const float row1[4] = {textureMatrix.m[0], textureMatrix.m[4], textureMatrix.m[8], textureMatrix.m[12]};
@@ -312,10 +309,10 @@ void Shadow::bind(const ActorSet &zoneActors, unsigned int textureUnit) const
 		const float row4[4] = {textureMatrix.m[3], textureMatrix.m[7], textureMatrix.m[11], textureMatrix.m[15]};
 
 		// Enable tex coord generation
-		glEnable(GL_TEXTURE_GEN_S);
-		glEnable(GL_TEXTURE_GEN_T);
-		glEnable(GL_TEXTURE_GEN_R);
-		glEnable(GL_TEXTURE_GEN_Q);
+		g_StateCache.enable(GL_TEXTURE_GEN_S);
+		g_StateCache.enable(GL_TEXTURE_GEN_T);
+		g_StateCache.enable(GL_TEXTURE_GEN_R);
+		g_StateCache.enable(GL_TEXTURE_GEN_Q);
 
 		// Define the parameters of the generation
 		glTexGeni(GL_S, GL_TEXTURE_GEN_MODE, GL_EYE_LINEAR);
@@ -335,24 +332,28 @@ void Shadow::bind(const ActorSet &zoneActors, unsigned int textureUnit) const
 		glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_TEXTURE_MODE_ARB, GL_INTENSITY);
 
 		CHECK_GL_ERROR();
+
+		return true;
 	}
+
+	return false;
 }
 
 void Shadow::testDepthTexture(void) const
 {
-	glPushAttrib(GL_ENABLE_BIT);
+	g_StateCache.push();
 
 	// Get ready for 2D
 	glColor4fv(white);
-	glDisable(GL_LIGHTING);
-	glDisable(GL_COLOR_MATERIAL);
-	glDisable(GL_FOG);
-	glDisable(GL_BLEND);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_CULL_FACE);
+	g_StateCache.disable(GL_LIGHTING);
+	g_StateCache.disable(GL_COLOR_MATERIAL);
+	g_StateCache.disable(GL_FOG);
+	g_StateCache.disable(GL_BLEND);
+	g_StateCache.disable(GL_DEPTH_TEST);
+	g_StateCache.disable(GL_CULL_FACE);
 
 	// Save the projection matrix
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPushMatrix();
 
 	// Set up the projection matrix for 2D
@@ -360,7 +361,7 @@ void Shadow::testDepthTexture(void) const
 	glOrtho(0.0f, 1024, 0.0f, 768, -1.0f, 1.0f);
 
 	// Save the model view matrix
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glPushMatrix();
 
 	// Set up the model view matrix
@@ -368,8 +369,8 @@ void Shadow::testDepthTexture(void) const
 	glTranslatef(0.0f, 0.0f, -0.2f);
 
 	// Bind the texture
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, shadowMapTexture);
+	g_StateCache.enable(GL_TEXTURE_2D);
+	g_StateCache.bindTexture(atlas!=0 ? atlas->getTexture() : 0);
 
 	//Disable shadow comparison
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE_ARB, GL_NONE);
@@ -384,26 +385,26 @@ void Shadow::testDepthTexture(void) const
 	glEnd();
 
 	// Restore the model view matrix
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glPopMatrix();
 
 	// Restore the projection matrix
-	glMatrixMode(GL_PROJECTION);
+	g_StateCache.matrixMode(GL_PROJECTION);
 	glPopMatrix();
 
 	// Use modelview mode
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 
 	// Restore settings
-	glPopAttrib();
+	g_StateCache.pop();
 }
 
 void Shadow::drawFrustum(void) const
 {
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
-	glDisable(GL_LIGHTING);
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_DEPTH_TEST);
+	g_StateCache.push();
+	g_StateCache.disable(GL_LIGHTING);
+	g_StateCache.disable(GL_CULL_FACE);
+	g_StateCache.disable(GL_DEPTH_TEST);
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 	glColor4fv(red);
 
@@ -446,7 +447,10 @@ void Shadow::drawFrustum(void) const
 
 	glEnd();
 
-	glPopAttrib();
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	glColor4fv(white);
+
+	g_StateCache.pop();
 }
 
 void Shadow::calculateAngularSpread(const Actor &actor, const mat4& lightViewMatrix, float &lx, float &ly)
@@ -34,6 +34,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "object.h"
 #include "ActorSet.h"
 #include "Light.h"
+#include "ShadowAtlas.h"
 
 namespace Engine {
 
@@ -57,22 +58,65 @@ public:
 	/** Cleanly destroys and clears the shadow */
 	void destroy(void);
 
-	/** Reconstructs the Shadow */
-	void create(void);
-
-	/** Release assets */
-	void release(void);
-
-	/** Reaquire assets */
-	void reaquire(void);
+	/**
+	Reconstructs the Shadow
+	@param atlas Atlas that holds the shadow map
+	@param tile Tile of the atlas that is reserved for this shadow
+	*/
+	void create(const ShadowAtlas *atlas, size_t tile);
 
 	/**
-	Update the shadows in the world
+	Tracks changes to the caster. The shadow map itself is only
+	re-rendered when the ShadowManager schedules it with render.
 	@param zoneActors Set of actors to draw the shadowed creature out of
 	@param deltaTime Time elapsed since the last update
 	*/
 	void update(const ActorSet &zoneActors, float deltaTime);
 
+	/**
+	Re-renders the shadow map
+	@param zoneActors Set of actors to draw the shadowed creature out of
+	@return true if the shadow map was rendered
+	*/
+	bool render(const ActorSet &zoneActors);
+
+	/**
+	Determines whether the shadow map must be rendered before it may be
+	used at all, as when the shadow was assigned to a new actor or light
+	@return true if the shadow map is invalid
+	*/
+	bool requiresUpdate(void) const
+	{
+		return isInUse() && needsUpdate;
+	}
+
+	/**
+	Determines whether the shadow map no longer matches the caster
+	@return true if the caster has moved or changed pose since the last render
+	*/
+	bool isOutOfDate(void) const
+	{
+		return isInUse() && (needsUpdate || casterChanged);
+	}
+
+	/**
+	Gets the time since the shadow map was last rendered
+	@return milliseconds
+	*/
+	float getTimeSinceUpdate(void) const
+	{
+		return timeSinceUpdate;
+	}
+
+	/**
+	Estimates how much of the screen the caster covers
+	@param zoneActors Set of actors to draw the shadowed creature out of
+	@param eye Position of the camera
+	@param tanHalfFovy Tangent of half the vertical field of view
+	@return projected radius of the caster as a fraction of half the screen height
+	*/
+	float calculateScreenImpact(const ActorSet &zoneActors, const vec3 &eye, float tanHalfFovy) const;
+
 	/**
 	Binds the shadow to a specific actor
 	@param actorID The id of an actor which generates the shadow
@@ -106,15 +150,16 @@ public:
 		needsUpdate=true;
 	}
 
-	/** renders the shadow texture onto the screen to test it */
+	/** renders the shadow atlas onto the screen to test it */
 	void testDepthTexture(void) const;
 
 	/**
 	Binds the shadow map
 	@param zoneActors Set of actors to draw the shadowed creature out of
 	@param textureUnit Texture stage of the shadow
+	@return true if the shadow was bound
 	*/
-	void bind(const ActorSet &zoneActors, unsigned int textureUnit) const;
+	bool bind(const ActorSet &zoneActors, unsigned int textureUnit) const;
 
 	/**
 	Gets the shadow receivers
@@ -159,18 +204,27 @@ private:
 	/** Model-View matrix from the light's perspective */
 	mat4 lightViewMatrix;
 
-	/** texture projection matrix */
+	/** texture projection matrix (into the shadow's tile of the atlas) */
 	mat4 textureMatrix;
 
-	/** Size of the shadow map texture */
+	/** Size of the shadow map */
 	int shadowMapSize;
 
-	/** Handle to the shadow map texture */
-	unsigned int shadowMapTexture;
+	/** Atlas that holds the shadow map */
+	const ShadowAtlas *atlas;
+
+	/** Tile of the atlas that holds the shadow map */
+	size_t tile;
 
 	/** Indicates that an update is required on the next tick */
 	bool needsUpdate;
 
+	/** Indicates that the caster has moved or changed pose since the last render */
+	bool casterChanged;
+
+	/** Milliseconds since the shadow map was last rendered */
+	float timeSinceUpdate;
+
 	/** Vertices of the shadow frustum */
 	vec3 ntl, ntr, nbl, nbr, ftl, ftr, fbl, fbr;
 
@@ -182,10 +236,11 @@ private:
 	@param lightProjectionMatrix Projection matrix from the light's perspective
 	@param lightViewMatrix Model-View matrix from the light's perspective
 	@param textureMatrix texture projection matrix
+	@param tileMatrix Maps the shadow map into its tile of the atlas
 	@param lx Angle of the frustum in the x direction
 	@param ly Angle of the frustum in the y direction
 	*/
-	static void calculateMatrices(const Light &light, const Actor &actor, int shadowMapSize, mat4& lightProjectionMatrix, mat4& lightViewMatrix, mat4& textureMatrix, float lx, float ly);
+	static void calculateMatrices(const Light &light, const Actor &actor, int shadowMapSize, mat4& lightProjectionMatrix, mat4& lightViewMatrix, mat4& textureMatrix, const mat4& tileMatrix, float lx, float ly);
 
 	/**
 	Calculate the objects that should receive the shadow
@@ -222,15 +277,15 @@ private:
 	static Frustum calculateFrustum(const mat4& lightProjectionMatrix, const mat4& lightViewMatrix);
 
 	/**
-	Renders the shadow into the specified texture
-	@param shadowMapTexture Handle to the shadow map texture
-	@param shadowMapSize Size of the shadow map that we will be projecting onto
+	Renders the shadow into its tile of the shadow atlas
+	@param atlas Atlas that holds the shadow map
+	@param tile Tile of the atlas that holds the shadow map
 	@param actor Actor that will be casting the shadow
 	@param lightProjectionMatrix Projection matrix from the light's perspective
 	@param lightViewMatrix Model-View matrix from the light's perspective
 	Actually re-renders the shadow map
 	*/
-	static void renderToShadow(unsigned int shadowMapTexture, int shadowMapSize, const Actor &actor, const mat4& lightProjectionMatrix, const mat4& lightViewMatrix);
+	static void renderToShadow(const ShadowAtlas &atlas, size_t tile, const Actor &actor, const mat4& lightProjectionMatrix, const mat4& lightViewMatrix);
 
 	/**
 
@@ -0,0 +1,232 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "stdafx.h"
+#include "gl.h"
+#include "StateCache.h"
+#include "opengl.h"
+#include "SDLwindow.h"
+#include "ShadowAtlas.h"
+
+namespace Engine {
+
+void ShadowAtlas::clear(void)
+{
+	tileSize = 0;
+	numTiles = 0;
+	tilesPerRow = 0;
+	atlasSize = 0;
+	texture = 0;
+	framebuffer = 0;
+}
+
+void ShadowAtlas::destroy(void)
+{
+	release();
+	clear();
+}
+
+void ShadowAtlas::create(int tileSize, size_t numTiles)
+{
+	ASSERT(tileSize > 0, "tileSize must be positive");
+
+	destroy();
+
+	this->tileSize = tileSize;
+	this->numTiles = numTiles;
+
+	// Pack the tiles into the smallest square that will hold them all
+	tilesPerRow = 1;
+	while(tilesPerRow*tilesPerRow < numTiles)
+	{
+		tilesPerRow++;
+	}
+
+	// Keep the texture dimensions a power of two for older hardware
+	atlasSize = 1;
+	while(atlasSize < (int)tilesPerRow * tileSize)
+	{
+		atlasSize <<= 1;
+	}
+
+	reaquire();
+}
+
+void ShadowAtlas::release(void)
+{
+	if(framebuffer != 0)
+	{
+		GLuint f = framebuffer;
+		glDeleteFramebuffersEXT(1, &f);
+		framebuffer = 0;
+	}
+
+	if(texture != 0)
+	{
+		GLuint t = texture;
+		StateCache::forgetTexture(t);
+		glDeleteTextures(1, &t);
+		texture = 0;
+	}
+}
+
+void ShadowAtlas::reaquire(void)
+{
+	if(atlasSize == 0)
+		return;
+
+	GLuint t = 0;
+	glGenTextures(1, &t);
+	g_StateCache.bindTexture(t);
+	texture = t;
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, atlasSize, atlasSize,
+	             0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 0);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+	if(g_bUseFramebufferObjects)
+	{
+		GLuint f = 0;
+		glGenFramebuffersEXT(1, &f);
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, f);
+
+		// Depth only, there is no color buffer attached at all
+		glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT, GL_TEXTURE_2D, t, 0);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+
+		const GLenum status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
+
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+
+		if(status == GL_FRAMEBUFFER_COMPLETE_EXT)
+		{
+			framebuffer = f;
+		}
+		else
+		{
+			TRACE("Shadow atlas framebuffer is incomplete, falling back to copying from the back buffer");
+			glDeleteFramebuffersEXT(1, &f);
+		}
+	}
+
+	TRACE("Shadow atlas is " + itoa(atlasSize) + "x" + itoa(atlasSize) +
+	      " with " + itoa((int)numTiles) + " tiles" +
+	      (usesFramebufferObject() ? " (FBO)" : " (copy)"));
+
+	CHECK_GL_ERROR();
+}
+
+void ShadowAtlas::begin(void) const
+{
+	if(usesFramebufferObject())
+	{
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, framebuffer);
+	}
+
+	g_StateCache.push();
+	g_StateCache.enable(GL_SCISSOR_TEST);
+}
+
+void ShadowAtlas::end(void) const
+{
+	if(usesFramebufferObject())
+	{
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+	}
+
+	g_StateCache.pop();
+
+	// The scene is always drawn to the whole window
+	const int width = SDLWindow::GetSingleton().GetWidth();
+	const int height = SDLWindow::GetSingleton().GetHeight();
+
+	glViewport(0, 0, width, height);
+	glScissor(0, 0, width, height);
+}
+
+void ShadowAtlas::beginTile(size_t tile) const
+{
+	ASSERT(tile < numTiles, "tile is invalid: " + itoa((int)tile));
+
+	int x=0, y=0;
+
+	if(usesFramebufferObject())
+	{
+		getTileOrigin(tile, x, y);
+	}
+
+	// Only touch the tile (or the corner of the back buffer)
+	glViewport(x, y, tileSize, tileSize);
+	glScissor(x, y, tileSize, tileSize);
+	glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void ShadowAtlas::endTile(size_t tile) const
+{
+	if(!usesFramebufferObject())
+	{
+		int x=0, y=0;
+		getTileOrigin(tile, x, y);
+
+		g_StateCache.bindTexture(texture);
+		glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, tileSize, tileSize);
+	}
+}
+
+mat4 ShadowAtlas::getTileMatrix(size_t tile) const
+{
+	int x=0, y=0;
+	getTileOrigin(tile, x, y);
+
+	const float scale = (float)tileSize / atlasSize;
+
+	mat4 m;
+	m.m[0]  = scale;
+	m.m[5]  = scale;
+	m.m[12] = (float)x / atlasSize;
+	m.m[13] = (float)y / atlasSize;
+
+	return m;
+}
+
+void ShadowAtlas::getTileOrigin(size_t tile, int &x, int &y) const
+{
+	x = (int)(tile % tilesPerRow) * tileSize;
+	y = (int)(tile / tilesPerRow) * tileSize;
+}
+
+} // namespace Engine
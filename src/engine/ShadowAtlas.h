@@ -0,0 +1,169 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _SHADOW_ATLAS_H_
+#define _SHADOW_ATLAS_H_
+
+#include "mat4.h"
+
+namespace Engine {
+
+/**
+A single depth texture that holds the shadow maps of all shadows as square
+tiles. When framebuffer objects are available, shadows are rendered straight
+into their tile. Otherwise, each shadow is rendered into the corner of the
+back buffer and copied into its tile.
+*/
+class ShadowAtlas
+{
+public:
+	ShadowAtlas(void)
+	{
+		clear();
+	}
+
+	~ShadowAtlas(void)
+	{
+		destroy();
+	}
+
+	/** Clears the atlas to a just-constructed state */
+	void clear(void);
+
+	/** Cleanly destroys and clears the atlas */
+	void destroy(void);
+
+	/**
+	Creates the atlas
+	@param tileSize Width and height of a single shadow map
+	@param numTiles Number of shadow maps that the atlas must hold
+	*/
+	void create(int tileSize, size_t numTiles);
+
+	/** Release assets */
+	void release(void);
+
+	/** Reaquire assets */
+	void reaquire(void);
+
+	/** Prepares to render shadow maps into the atlas */
+	void begin(void) const;
+
+	/** Finishes rendering shadow maps and restores the main framebuffer and the window viewport */
+	void end(void) const;
+
+	/**
+	Prepares to render a shadow map into a tile.
+	Must be called between begin and end.
+	@param tile Index of the tile
+	*/
+	void beginTile(size_t tile) const;
+
+	/**
+	Finishes rendering a shadow map into a tile
+	@param tile Index of the tile
+	*/
+	void endTile(size_t tile) const;
+
+	/**
+	Gets the matrix that maps texture coordinates in [0,1] into a tile
+	@param tile Index of the tile
+	@return tile matrix
+	*/
+	mat4 getTileMatrix(size_t tile) const;
+
+	/**
+	Gets the atlas texture
+	@return texture handle
+	*/
+	unsigned int getTexture(void) const
+	{
+		return texture;
+	}
+
+	/**
+	Gets the width and height of a single shadow map
+	@return tile size
+	*/
+	int getTileSize(void) const
+	{
+		return tileSize;
+	}
+
+	/**
+	Gets the number of shadow maps that the atlas holds
+	@return number of tiles
+	*/
+	size_t getNumTiles(void) const
+	{
+		return numTiles;
+	}
+
+	/**
+	Determines whether shadow maps are rendered through a framebuffer object
+	@return true if the framebuffer object is used, false if shadows are copied from the back buffer
+	*/
+	bool usesFramebufferObject(void) const
+	{
+		return framebuffer != 0;
+	}
+
+private:
+	/** Width and height of a single shadow map */
+	int tileSize;
+
+	/** Number of shadow maps that the atlas holds */
+	size_t numTiles;
+
+	/** Number of tiles along each side of the atlas */
+	size_t tilesPerRow;
+
+	/** Width and height of the atlas texture */
+	int atlasSize;
+
+	/** Handle to the atlas depth texture */
+	unsigned int texture;
+
+	/** Handle to the framebuffer object, or zero to copy from the back buffer */
+	unsigned int framebuffer;
+
+	/**
+	Gets the position of a tile within the atlas
+	@param tile Index of the tile
+	@param x Returns the left edge of the tile, in texels
+	@param y Returns the bottom edge of the tile, in texels
+	*/
+	void getTileOrigin(size_t tile, int &x, int &y) const;
+};
+
+} // namespace Engine
+
+#endif
@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h"
+#include <SDL/SDL.h> // SDL_GetTicks
 #include "gl.h"
 #include "SDLwindow.h"
 #include "ActorSet.h"
@@ -38,6 +39,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Engine {
 
+/** Casters at least this large on screen get their shadow re-rendered every frame */
+const float FULL_RATE_IMPACT = 0.25f;
+
+/** Minimum time between renders of the shadows of the smallest casters (milliseconds) */
+const float LOW_PRIORITY_INTERVAL = 200.0f;
+
+size_t ShadowManager::maxUpdatesPerFrame = 2;
+float ShadowManager::updateTimeBudget = 4.0f;
+size_t ShadowManager::numUpdates = 0;
+size_t ShadowManager::numDeferredUpdates = 0;
+
 void ShadowManager::clear(void)
 {
 	zone=0;
@@ -57,10 +69,12 @@ void ShadowManager::create(void)
 {
 	destroy();
 
+	atlas.create(SHADOW_MAP_SIZE, getMaxShadows());
+
 	for(size_t i=0; i<getMaxShadows(); ++i)
 	{
 		Shadow *s = new Shadow();
-		s->create();
+		s->create(&atlas, i);
 		shadows.push_back(s);
 	}
 }
@@ -76,6 +90,8 @@ void ShadowManager::release(void)
 		delete shadow;
 	}*/
 	shadows.clear();
+
+	atlas.release();
 }
 
 void ShadowManager::reaquire(void)
@@ -84,15 +100,14 @@ void ShadowManager::reaquire(void)
 
 	shadows.clear();
 
+	atlas.create(SHADOW_MAP_SIZE, getMaxShadows());
+
 	for(size_t i=0; i<getMaxShadows(); ++i)
 	{
 		Shadow *s = new Shadow();
-		s->create();
+		s->create(&atlas, i);
 		shadows.push_back(s);
 	}
-
-	/*for(size_t i=0; i<getMaxShadows(); ++i)
-		shadows[i]->reaquire();*/
 }
 
 void ShadowManager::setZone(World *zone)
@@ -116,11 +131,81 @@ void ShadowManager::update(const ActorSet &zoneActors, float deltaTime)
 		shadows[i]->update(zoneActors, deltaTime);
 	}
 
+	renderShadows(zoneActors);
+
 	glViewport(0, 0, SDLWindow::GetSingleton().GetWidth(), SDLWindow::GetSingleton().GetHeight());
 
 	CHECK_GL_ERROR();
 }
 
+void ShadowManager::renderShadows(const ActorSet &zoneActors)
+{
+	const unsigned int startTime = (unsigned int)SDL_GetTicks();
+
+	// Matches the field of view set up by OpenGL::SetClippingPlanes
+	const float tanHalfFovy = tanf(45.0f * 0.5f * (float)M_PI / 180.0f);
+
+	const vec3 &eye = g_Camera.getPosition();
+
+	size_t updates = 0;
+
+	vector< pair<float, Shadow*> > candidates;
+
+	atlas.begin();
+
+	for(size_t i=0; i<getMaxShadows(); ++i)
+	{
+		Shadow *shadow = shadows[i];
+
+		if(shadow->requiresUpdate())
+		{
+			// The old shadow map belongs to something else, so it cannot wait
+			if(shadow->render(zoneActors))
+				updates++;
+		}
+		else if(shadow->isOutOfDate())
+		{
+			const float impact = shadow->calculateScreenImpact(zoneActors, eye, tanHalfFovy);
+
+			// Small and distant casters refresh at a reduced rate
+			if(shadow->getTimeSinceUpdate() >= getUpdateInterval(impact))
+			{
+				// Large casters first, and the longer a shadow waits the more urgent it becomes
+				candidates.push_back(make_pair(impact * (1.0f + shadow->getTimeSinceUpdate()), shadow));
+			}
+			else
+			{
+				numDeferredUpdates++;
+			}
+		}
+	}
+
+	sort(candidates.begin(), candidates.end(), greater< pair<float, Shadow*> >());
+
+	for(size_t i=0; i<candidates.size(); ++i)
+	{
+		const float elapsed = (float)((unsigned int)SDL_GetTicks() - startTime);
+
+		if(updates >= maxUpdatesPerFrame || elapsed >= updateTimeBudget)
+		{
+			numDeferredUpdates += candidates.size() - i;
+			break;
+		}
+
+		if(candidates[i].second->render(zoneActors))
+			updates++;
+	}
+
+	atlas.end();
+
+	numUpdates += updates;
+}
+
+float ShadowManager::getUpdateInterval(float impact)
+{
+	return LOW_PRIORITY_INTERVAL * (1.0f - min(impact / FULL_RATE_IMPACT, 1.0f));
+}
+
 void ShadowManager::reassignShadows(void)
 {
 	ASSERT(zone!=0, "zone was null!  Make sure to call setZone before using the shadow manager.");
@@ -161,7 +246,7 @@ void ShadowManager::reassignShadows(void)
 
 #if 1
 		// Get the objects
-		ActorSet s = zone->getObjects().getClosestSeveral<Actor>(light->getPosition(), MAX_SHADOWS, 20);
+		ActorSet s = zone->getObjects().getClosestSeveral<Actor>(light->getPosition(), getMaxShadows(), 20);
 
 		// assign shadows to all shadow casters
 		size_t shadowIdx=1;
@@ -189,9 +274,8 @@ void ShadowManager::reassignShadows(void)
 
 size_t ShadowManager::getMaxShadows(void) const
 {
-	GLint max_shadows;
-	max_shadows = max((GLint)(g_MultitextureUnits-2), (GLint)0);
-	return (size_t)max_shadows;
+	const size_t tilesPerRow = SHADOW_ATLAS_SIZE / SHADOW_MAP_SIZE;
+	return tilesPerRow * tilesPerRow;
 }
 
 const Shadow& ShadowManager::getShadow(size_t idx) const
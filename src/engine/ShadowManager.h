@@ -32,12 +32,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define _SHADOW_MANAGER_H_
 
 #include "Shadow.h"
+#include "ShadowAtlas.h"
 
 namespace Engine {
 
 class World;
 
-const size_t MAX_SHADOWS = 6;
+/** Width and height of a single shadow map in the atlas */
+const int SHADOW_MAP_SIZE = 128;
+
+/**
+Width and height of the shadow atlas texture.  The number of shadows is the
+number of shadow maps that fit in it.
+*/
+const int SHADOW_ATLAS_SIZE = 512;
 
 class ShadowManager
 {
@@ -81,7 +89,10 @@ public:
 	void update(const ActorSet &zoneActors, float deltaTime);
 
 	/**
-	Gets the maximum number of shadows possible
+	Gets the maximum number of shadows possible.
+	All shadows share one atlas texture and are applied one at a time, so
+	this is not limited by the number of texture units, but by the number
+	of SHADOW_MAP_SIZE tiles that fit in a SHADOW_ATLAS_SIZE atlas.
 	@return the maximum number of shadows
 	*/
 	size_t getMaxShadows(void) const;
@@ -93,18 +104,95 @@ public:
 	*/
 	const Shadow& getShadow(size_t idx) const;
 
+	/**
+	Sets the maximum number of shadow maps that are rendered in one frame.
+	Shadows assigned to a new actor or light are always rendered.
+	@param maps Number of shadow maps
+	*/
+	static void setMaxUpdatesPerFrame(size_t maps)
+	{
+		maxUpdatesPerFrame = maps;
+	}
+
+	/** Gets the maximum number of shadow maps rendered in one frame */
+	static size_t getMaxUpdatesPerFrame(void)
+	{
+		return maxUpdatesPerFrame;
+	}
+
+	/**
+	Sets the time that may be spent rendering shadow maps in one frame
+	@param milliseconds Time budget
+	*/
+	static void setUpdateTimeBudget(float milliseconds)
+	{
+		updateTimeBudget = max(0.0f, milliseconds);
+	}
+
+	/** Gets the time that may be spent rendering shadow maps in one frame (milliseconds) */
+	static float getUpdateTimeBudget(void)
+	{
+		return updateTimeBudget;
+	}
+
+	/**
+	Gets the number of shadow maps rendered so far
+	@return number of shadow map renders
+	*/
+	static size_t getNumUpdates(void)
+	{
+		return numUpdates;
+	}
+
+	/**
+	Gets the number of times an out of date shadow map was left for a later frame
+	@return number of deferred shadow map renders
+	*/
+	static size_t getNumDeferredUpdates(void)
+	{
+		return numDeferredUpdates;
+	}
+
 private:
 	/** All shadows */
 	vector<Shadow*> shadows;
 
+	/** Holds the shadow maps of all shadows */
+	ShadowAtlas atlas;
+
 	/** The scene */
 	World *zone;
 
 	/** times milliseconds until our periodic calculations */
 	float periodicTimer;
 
+	/** Maximum number of shadow maps rendered in one frame */
+	static size_t maxUpdatesPerFrame;
+
+	/** Time that may be spent rendering shadow maps in one frame (milliseconds) */
+	static float updateTimeBudget;
+
+	/** Number of shadow maps rendered so far */
+	static size_t numUpdates;
+
+	/** Number of times an out of date shadow map was left for a later frame */
+	static size_t numDeferredUpdates;
+
 	/** Reassign the shadow's objects */
 	void reassignShadows(void);
+
+	/**
+	Re-renders the out of date shadow maps that are most important, within the budget
+	@param zoneActors Actors may be drawn out of this source
+	*/
+	void renderShadows(const ActorSet &zoneActors);
+
+	/**
+	Gets the minimum time between renders of a shadow
+	@param impact Screen impact of the shadow's caster
+	@return milliseconds
+	*/
+	static float getUpdateInterval(float impact);
 };
 
 } // namespace Engine
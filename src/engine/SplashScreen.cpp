@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include <SDL/SDL.h> // SDL_GetTicks
 
 #include "SDLwindow.h"
@@ -59,11 +60,11 @@ void SplashScreen::draw(float intensity)
 
 	// reset for the following frame
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 
 	effect_Begin(effect_GUI);
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
 	// Set up the model view matrix
 	glLoadIdentity();
@@ -71,9 +72,9 @@ void SplashScreen::draw(float intensity)
 
 	// Render a textured quad over the screen
 	splash.getTexture().bind();
-	glDisable(GL_ALPHA_TEST);
+	g_StateCache.disable(GL_ALPHA_TEST);
 	glColor4fv(COLOR(intensity, intensity, intensity, 1.0f));
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.enable(GL_TEXTURE_2D);
 	glBegin(GL_QUADS);
 		glTexCoord2f(1.0f, 0.0f); glVertex3f(1024.0f,   0.0f, 0.0f);
 		glTexCoord2f(1.0f, 1.0f); glVertex3f(1024.0f, 768.0f, 0.0f);
@@ -81,7 +82,9 @@ void SplashScreen::draw(float intensity)
 		glTexCoord2f(0.0f, 0.0f); glVertex3f(   0.0f,   0.0f, 0.0f);
 	glEnd();
 
-	glPopAttrib();
+	glColor4fv(white);
+
+	g_StateCache.pop();
 	effect_End();
 
 	// Swap buffers
@@ -0,0 +1,528 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include "stdafx.h"
+#include "gl.h"
+#include "StateCache.h"
+
+namespace Engine {
+
+/** Capabilities read back from OpenGL up front, the rest are learned on first use */
+static const GLenum commonCaps[] =
+{
+	GL_ALPHA_TEST,
+	GL_BLEND,
+	GL_COLOR_MATERIAL,
+	GL_CULL_FACE,
+	GL_DEPTH_TEST,
+	GL_FOG,
+	GL_LIGHTING,
+	GL_NORMALIZE,
+	GL_POLYGON_OFFSET_FILL,
+	GL_SCISSOR_TEST,
+	GL_STENCIL_TEST
+};
+
+/** Client arrays read back from OpenGL up front */
+static const GLenum commonClientStates[] =
+{
+	GL_VERTEX_ARRAY,
+	GL_NORMAL_ARRAY,
+	GL_COLOR_ARRAY
+};
+
+/** Capabilities of each texture unit read back from OpenGL up front */
+static const GLenum textureCaps[] =
+{
+	GL_TEXTURE_2D,
+	GL_TEXTURE_GEN_S,
+	GL_TEXTURE_GEN_T,
+	GL_TEXTURE_GEN_R,
+	GL_TEXTURE_GEN_Q
+};
+
+size_t StateCache::numIssued = 0;
+size_t StateCache::numElided = 0;
+
+/**
+Determines whether a capability belongs to the active texture unit
+@param cap The capability
+@return true if the capability is tracked per texture unit
+*/
+static bool isTextureCap(GLenum cap)
+{
+	return cap == GL_TEXTURE_1D ||
+	       cap == GL_TEXTURE_2D ||
+	       cap == GL_TEXTURE_GEN_S ||
+	       cap == GL_TEXTURE_GEN_T ||
+	       cap == GL_TEXTURE_GEN_R ||
+	       cap == GL_TEXTURE_GEN_Q;
+}
+
+/**
+Packs a color mask into bits
+@return color mask bits
+*/
+static int packColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)
+{
+	return (r ? 1 : 0) | (g ? 2 : 0) | (b ? 4 : 0) | (a ? 8 : 0);
+}
+
+StateCache::StateCache(void)
+{
+	// Nothing is known until invalidate is called with a context current
+	for(int i=0; i<MAX_TEXTURE_UNITS; ++i)
+	{
+		current.textures[i] = 0;
+	}
+
+	current.activeUnit = 0;
+	current.clientActiveUnit = 0;
+	current.blendSrc = GL_ONE;
+	current.blendDst = GL_ZERO;
+	current.alphaTestFunc = GL_ALWAYS;
+	current.alphaTestRef = 0.0f;
+	current.depthTestFunc = GL_LESS;
+	current.depthWrites = GL_TRUE;
+	current.colorWrites = packColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	current.culledFaces = GL_BACK;
+	current.matrix = GL_MODELVIEW;
+}
+
+void StateCache::invalidate(void)
+{
+	GLint value = 0;
+	GLfloat ref = 0.0f;
+	GLboolean mask[4];
+
+	stack.clear();
+	textureFilters.clear();
+	current.enables.clear();
+	current.clientStates.clear();
+
+	const int units = g_bUseMultitexture ? min((int)g_MultitextureUnits, (int)MAX_TEXTURE_UNITS) : 1;
+
+	GLint activeUnit = GL_TEXTURE0_ARB, clientActiveUnit = GL_TEXTURE0_ARB;
+	if(g_bUseMultitexture)
+	{
+		glGetIntegerv(GL_ACTIVE_TEXTURE_ARB, &activeUnit);
+		glGetIntegerv(GL_CLIENT_ACTIVE_TEXTURE_ARB, &clientActiveUnit);
+	}
+
+	for(int i=0; i<MAX_TEXTURE_UNITS; ++i)
+	{
+		current.textures[i] = 0;
+	}
+
+	for(int i=0; i<units; ++i)
+	{
+		if(g_bUseMultitexture)
+		{
+			glActiveTextureARB(textureStages[i]);
+			glClientActiveTextureARB(textureStages[i]);
+		}
+
+		for(size_t j=0; j<sizeof(textureCaps)/sizeof(textureCaps[0]); ++j)
+		{
+			current.enables[CapKey(textureCaps[j], i)] = glIsEnabled(textureCaps[j])==GL_TRUE;
+		}
+
+		current.clientStates[CapKey(GL_TEXTURE_COORD_ARRAY, i)] = glIsEnabled(GL_TEXTURE_COORD_ARRAY)==GL_TRUE;
+
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &value);
+		current.textures[i] = (GLuint)value;
+	}
+
+	if(g_bUseMultitexture)
+	{
+		glActiveTextureARB(activeUnit);
+		glClientActiveTextureARB(clientActiveUnit);
+	}
+
+	current.activeUnit = activeUnit - GL_TEXTURE0_ARB;
+	current.clientActiveUnit = clientActiveUnit - GL_TEXTURE0_ARB;
+
+	for(size_t i=0; i<sizeof(commonCaps)/sizeof(commonCaps[0]); ++i)
+	{
+		current.enables[CapKey(commonCaps[i], -1)] = glIsEnabled(commonCaps[i])==GL_TRUE;
+	}
+
+	for(size_t i=0; i<sizeof(commonClientStates)/sizeof(commonClientStates[0]); ++i)
+	{
+		current.clientStates[CapKey(commonClientStates[i], -1)] = glIsEnabled(commonClientStates[i])==GL_TRUE;
+	}
+
+	glGetIntegerv(GL_BLEND_SRC, &value);
+	current.blendSrc = (GLenum)value;
+
+	glGetIntegerv(GL_BLEND_DST, &value);
+	current.blendDst = (GLenum)value;
+
+	glGetIntegerv(GL_ALPHA_TEST_FUNC, &value);
+	current.alphaTestFunc = (GLenum)value;
+
+	glGetFloatv(GL_ALPHA_TEST_REF, &ref);
+	current.alphaTestRef = ref;
+
+	glGetIntegerv(GL_DEPTH_FUNC, &value);
+	current.depthTestFunc = (GLenum)value;
+
+	glGetBooleanv(GL_DEPTH_WRITEMASK, mask);
+	current.depthWrites = mask[0];
+
+	glGetBooleanv(GL_COLOR_WRITEMASK, mask);
+	current.colorWrites = packColorMask(mask[0], mask[1], mask[2], mask[3]);
+
+	glGetIntegerv(GL_CULL_FACE_MODE, &value);
+	current.culledFaces = (GLenum)value;
+
+	glGetIntegerv(GL_MATRIX_MODE, &value);
+	current.matrix = (GLenum)value;
+
+	CHECK_GL_ERROR();
+}
+
+StateCache::CapKey StateCache::getCapKey(GLenum cap) const
+{
+	return CapKey(cap, isTextureCap(cap) ? current.activeUnit : -1);
+}
+
+StateCache::CapKey StateCache::getClientKey(GLenum array) const
+{
+	return CapKey(array, array==GL_TEXTURE_COORD_ARRAY ? current.clientActiveUnit : -1);
+}
+
+bool StateCache::learnEnable(const CapKey &key)
+{
+	map<CapKey, bool>::const_iterator i = current.enables.find(key);
+
+	if(i != current.enables.end())
+		return i->second;
+
+	// Per-unit capabilities are only ever looked up for the active unit
+	const bool enabled = glIsEnabled(key.first)==GL_TRUE;
+
+	current.enables[key] = enabled;
+
+	// Saved states predate any change to this capability, so they share its value
+	for(vector<State>::iterator j = stack.begin(); j != stack.end(); ++j)
+	{
+		j->enables.insert(make_pair(key, enabled));
+	}
+
+	return enabled;
+}
+
+bool StateCache::learnClientState(const CapKey &key)
+{
+	map<CapKey, bool>::const_iterator i = current.clientStates.find(key);
+
+	if(i != current.clientStates.end())
+		return i->second;
+
+	const bool enabled = glIsEnabled(key.first)==GL_TRUE;
+
+	current.clientStates[key] = enabled;
+
+	for(vector<State>::iterator j = stack.begin(); j != stack.end(); ++j)
+	{
+		j->clientStates.insert(make_pair(key, enabled));
+	}
+
+	return enabled;
+}
+
+void StateCache::setEnabled(GLenum cap, bool enabled)
+{
+	const CapKey key = getCapKey(cap);
+
+	if(count(learnEnable(key) != enabled))
+	{
+		if(enabled)
+			glEnable(cap);
+		else
+			glDisable(cap);
+
+		current.enables[key] = enabled;
+	}
+}
+
+bool StateCache::isEnabled(GLenum cap)
+{
+	return learnEnable(getCapKey(cap));
+}
+
+void StateCache::setClientState(GLenum array, bool enabled)
+{
+	const CapKey key = getClientKey(array);
+
+	if(count(learnClientState(key) != enabled))
+	{
+		if(enabled)
+			glEnableClientState(array);
+		else
+			glDisableClientState(array);
+
+		current.clientStates[key] = enabled;
+	}
+}
+
+void StateCache::activeTexture(GLenum unit)
+{
+	const int index = unit - GL_TEXTURE0_ARB;
+
+	ASSERT(index>=0 && index<MAX_TEXTURE_UNITS, "StateCache::activeTexture  ->  invalid texture unit");
+
+	if(!g_bUseMultitexture)
+		return;
+
+	if(count(current.activeUnit != index))
+	{
+		glActiveTextureARB(unit);
+		current.activeUnit = index;
+	}
+}
+
+void StateCache::clientActiveTexture(GLenum unit)
+{
+	const int index = unit - GL_TEXTURE0_ARB;
+
+	ASSERT(index>=0 && index<MAX_TEXTURE_UNITS, "StateCache::clientActiveTexture  ->  invalid texture unit");
+
+	if(!g_bUseMultitexture)
+		return;
+
+	if(count(current.clientActiveUnit != index))
+	{
+		glClientActiveTextureARB(unit);
+		current.clientActiveUnit = index;
+	}
+}
+
+void StateCache::bindTexture(GLuint texture)
+{
+	if(count(current.textures[current.activeUnit] != texture))
+	{
+		glBindTexture(GL_TEXTURE_2D, texture);
+		current.textures[current.activeUnit] = texture;
+	}
+}
+
+void StateCache::forgetTexture(GLuint texture)
+{
+	if(GetSingletonPtr())
+	{
+		GetSingleton().forget(texture);
+	}
+}
+
+void StateCache::forget(GLuint texture)
+{
+	// OpenGL reverts a unit to the default texture when its texture is deleted
+	for(int i=0; i<MAX_TEXTURE_UNITS; ++i)
+	{
+		if(current.textures[i] == texture)
+		{
+			current.textures[i] = 0;
+		}
+	}
+
+	textureFilters.erase(texture);
+}
+
+void StateCache::applyTextureFilters(void)
+{
+	const GLuint texture = current.textures[current.activeUnit];
+	const pair<int, float> filters(g_Application.textureFilter, g_Application.aniostropy);
+
+	map<GLuint, pair<int, float> >::iterator i = textureFilters.find(texture);
+
+	if(i != textureFilters.end() && i->second == filters)
+	{
+		count(false);
+		return;
+	}
+
+	count(true);
+	textureFilters[texture] = filters;
+
+	switch(filters.first)
+	{
+	case 2: // aniostropic
+		if(supportsAniostropy)
+		{
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, filters.second);
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		break;
+
+	case 1: // trilinear
+		if(supportsAniostropy)
+		{
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, 1.0f); // disables aniostropic filtering
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		break;
+
+	default: // bilinear
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		break;
+	};
+}
+
+void StateCache::blendFunc(GLenum src, GLenum dst)
+{
+	if(count(current.blendSrc != src || current.blendDst != dst))
+	{
+		glBlendFunc(src, dst);
+		current.blendSrc = src;
+		current.blendDst = dst;
+	}
+}
+
+void StateCache::alphaFunc(GLenum func, GLclampf ref)
+{
+	if(count(current.alphaTestFunc != func || current.alphaTestRef != ref))
+	{
+		glAlphaFunc(func, ref);
+		current.alphaTestFunc = func;
+		current.alphaTestRef = ref;
+	}
+}
+
+void StateCache::depthFunc(GLenum func)
+{
+	if(count(current.depthTestFunc != func))
+	{
+		glDepthFunc(func);
+		current.depthTestFunc = func;
+	}
+}
+
+void StateCache::depthMask(GLboolean flag)
+{
+	if(count(current.depthWrites != flag))
+	{
+		glDepthMask(flag);
+		current.depthWrites = flag;
+	}
+}
+
+void StateCache::colorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)
+{
+	const int bits = packColorMask(r, g, b, a);
+
+	if(count(current.colorWrites != bits))
+	{
+		glColorMask(r, g, b, a);
+		current.colorWrites = bits;
+	}
+}
+
+void StateCache::cullFace(GLenum mode)
+{
+	if(count(current.culledFaces != mode))
+	{
+		glCullFace(mode);
+		current.culledFaces = mode;
+	}
+}
+
+void StateCache::matrixMode(GLenum mode)
+{
+	if(count(current.matrix != mode))
+	{
+		glMatrixMode(mode);
+		current.matrix = mode;
+	}
+}
+
+void StateCache::push(void)
+{
+	stack.push_back(current);
+}
+
+void StateCache::pop(void)
+{
+	ASSERT(!stack.empty(), "StateCache::pop  ->  stack underflow");
+
+	const State saved = stack.back();
+	stack.pop_back();
+
+	// Put back per-unit state, switching units as needed
+	for(map<CapKey, bool>::const_iterator i = saved.enables.begin(); i != saved.enables.end(); ++i)
+	{
+		if(i->first.second >= 0)
+		{
+			activeTexture(textureStages[i->first.second]);
+		}
+		setEnabled(i->first.first, i->second);
+	}
+
+	for(map<CapKey, bool>::const_iterator i = saved.clientStates.begin(); i != saved.clientStates.end(); ++i)
+	{
+		if(i->first.second >= 0)
+		{
+			clientActiveTexture(textureStages[i->first.second]);
+		}
+		setClientState(i->first.first, i->second);
+	}
+
+	for(int i=0; i<MAX_TEXTURE_UNITS; ++i)
+	{
+		if(saved.textures[i] != current.textures[i])
+		{
+			activeTexture(textureStages[i]);
+			bindTexture(saved.textures[i]);
+		}
+	}
+
+	blendFunc(saved.blendSrc, saved.blendDst);
+	alphaFunc(saved.alphaTestFunc, saved.alphaTestRef);
+	depthFunc(saved.depthTestFunc);
+	depthMask(saved.depthWrites);
+	colorMask((saved.colorWrites & 1) ? GL_TRUE : GL_FALSE,
+	          (saved.colorWrites & 2) ? GL_TRUE : GL_FALSE,
+	          (saved.colorWrites & 4) ? GL_TRUE : GL_FALSE,
+	          (saved.colorWrites & 8) ? GL_TRUE : GL_FALSE);
+	cullFace(saved.culledFaces);
+	matrixMode(saved.matrix);
+
+	// Put back the selected units last, since the loops above change them
+	activeTexture(textureStages[saved.activeUnit]);
+	clientActiveTexture(textureStages[saved.clientActiveUnit]);
+}
+
+} // namespace Engine
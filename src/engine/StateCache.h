@@ -0,0 +1,344 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#ifndef _STATE_CACHE_H_
+#define _STATE_CACHE_H_
+
+#include "gl.h"
+#include "singleton.h"
+
+namespace Engine {
+
+/**
+Shadows the OpenGL state that the engine changes most often, so that a
+call that would not change anything is never issued. Engine code sets
+these states through the cache rather than through OpenGL directly, or
+else the shadow no longer matches OpenGL.
+
+push and pop stand in for glPushAttrib and glPopAttrib: pop only issues
+the calls needed to put back the cached states that changed since push.
+Any state that is not cached here must be put back by the code that
+changed it.
+*/
+class StateCache : public Singleton<StateCache>
+{
+public:
+	/** Number of texture units tracked, matching textureStages */
+	static const int MAX_TEXTURE_UNITS = 32;
+
+	/** Constructor */
+	StateCache(void);
+
+	/**
+	Reads back the whole cached state from OpenGL.
+	Call whenever a new OpenGL context has been created.
+	*/
+	void invalidate(void);
+
+	/**
+	Enables an OpenGL capability. Texturing and texture coordinate
+	generation are tracked separately for each texture unit.
+	@param cap The capability
+	*/
+	inline void enable(GLenum cap)
+	{
+		setEnabled(cap, true);
+	}
+
+	/**
+	Disables an OpenGL capability
+	@param cap The capability
+	*/
+	inline void disable(GLenum cap)
+	{
+		setEnabled(cap, false);
+	}
+
+	/**
+	Enables or disables an OpenGL capability
+	@param cap The capability
+	@param enabled true to enable the capability
+	*/
+	void setEnabled(GLenum cap, bool enabled);
+
+	/**
+	Determines whether a capability is enabled, without asking OpenGL
+	@param cap The capability
+	@return true if the capability is enabled
+	*/
+	bool isEnabled(GLenum cap);
+
+	/**
+	Enables a client-side vertex array. The texture coordinate array is
+	tracked separately for each client texture unit.
+	@param array The array
+	*/
+	inline void enableClientState(GLenum array)
+	{
+		setClientState(array, true);
+	}
+
+	/**
+	Disables a client-side vertex array
+	@param array The array
+	*/
+	inline void disableClientState(GLenum array)
+	{
+		setClientState(array, false);
+	}
+
+	/**
+	Enables or disables a client-side vertex array
+	@param array The array
+	@param enabled true to enable the array
+	*/
+	void setClientState(GLenum array, bool enabled);
+
+	/**
+	Selects the texture unit that texture state applies to
+	@param unit GL_TEXTURE0_ARB and so on
+	*/
+	void activeTexture(GLenum unit);
+
+	/**
+	Selects the texture unit that the texture coordinate array applies to
+	@param unit GL_TEXTURE0_ARB and so on
+	*/
+	void clientActiveTexture(GLenum unit);
+
+	/**
+	Binds a 2D texture to the active texture unit
+	@param texture The texture name
+	*/
+	void bindTexture(GLuint texture);
+
+	/**
+	Forgets a texture that is about to be deleted, since OpenGL may
+	reuse its name for another texture. Textures may outlive the
+	cache, so this does nothing once the cache has been destroyed.
+	@param texture The texture name
+	*/
+	static void forgetTexture(GLuint texture);
+
+	/**
+	Applies the filtering of the global performance settings to the
+	bound texture, unless that texture already uses them
+	*/
+	void applyTextureFilters(void);
+
+	/**
+	Sets the blending function
+	@param src Source factor
+	@param dst Destination factor
+	*/
+	void blendFunc(GLenum src, GLenum dst);
+
+	/**
+	Sets the alpha test
+	@param func Comparison function
+	@param ref Reference value
+	*/
+	void alphaFunc(GLenum func, GLclampf ref);
+
+	/**
+	Sets the depth test
+	@param func Comparison function
+	*/
+	void depthFunc(GLenum func);
+
+	/**
+	Enables or disables writes to the depth buffer
+	@param flag GL_TRUE to write depth
+	*/
+	void depthMask(GLboolean flag);
+
+	/**
+	Enables or disables writes to the color channels
+	@param r GL_TRUE to write red
+	@param g GL_TRUE to write green
+	@param b GL_TRUE to write blue
+	@param a GL_TRUE to write alpha
+	*/
+	void colorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a);
+
+	/**
+	Selects the faces that are culled
+	@param mode GL_FRONT or GL_BACK
+	*/
+	void cullFace(GLenum mode);
+
+	/**
+	Selects the matrix stack that matrix operations apply to
+	@param mode The matrix stack
+	*/
+	void matrixMode(GLenum mode);
+
+	/** Saves the cached state, to be put back by a matching call to pop */
+	void push(void);
+
+	/** Puts back the cached state saved by the matching call to push */
+	void pop(void);
+
+	/**
+	Gets the number of state changes issued to OpenGL so far
+	@return state calls issued since the program started
+	*/
+	static size_t getNumIssued(void)
+	{
+		return numIssued;
+	}
+
+	/**
+	Gets the number of state changes skipped because they would have changed nothing
+	@return state calls elided since the program started
+	*/
+	static size_t getNumElided(void)
+	{
+		return numElided;
+	}
+
+private:
+	/** Key of a capability: the capability, and its texture unit or -1 */
+	typedef pair<GLenum, int> CapKey;
+
+	/** A copy of all cached state */
+	struct State
+	{
+		/** Capabilities that have been learned */
+		map<CapKey, bool> enables;
+
+		/** Client arrays that have been learned */
+		map<CapKey, bool> clientStates;
+
+		/** Texture bound to each texture unit */
+		GLuint textures[MAX_TEXTURE_UNITS];
+
+		/** Active texture unit, as an index */
+		int activeUnit;
+
+		/** Active client texture unit, as an index */
+		int clientActiveUnit;
+
+		/** Blend source factor */
+		GLenum blendSrc;
+
+		/** Blend destination factor */
+		GLenum blendDst;
+
+		/** Alpha test function */
+		GLenum alphaTestFunc;
+
+		/** Alpha test reference value */
+		GLclampf alphaTestRef;
+
+		/** Depth test function */
+		GLenum depthTestFunc;
+
+		/** Depth writes */
+		GLboolean depthWrites;
+
+		/** Color writes, one bit per channel */
+		int colorWrites;
+
+		/** Culled faces */
+		GLenum culledFaces;
+
+		/** Matrix stack */
+		GLenum matrix;
+	};
+
+	/**
+	Gets the key of a capability, given the active texture unit
+	@param cap The capability
+	@return key
+	*/
+	CapKey getCapKey(GLenum cap) const;
+
+	/**
+	Gets the key of a client array, given the active client texture unit
+	@param array The array
+	@return key
+	*/
+	CapKey getClientKey(GLenum array) const;
+
+	/**
+	Looks up a capability, asking OpenGL the first time it is seen
+	@param key The capability
+	@return true if the capability is enabled
+	*/
+	bool learnEnable(const CapKey &key);
+
+	/**
+	Looks up a client array, asking OpenGL the first time it is seen
+	@param key The array
+	@return true if the array is enabled
+	*/
+	bool learnClientState(const CapKey &key);
+
+	/**
+	Counts a state call as issued or elided
+	@param issue true if the call was issued
+	@return issue
+	*/
+	static inline bool count(bool issue)
+	{
+		if(issue) numIssued++; else numElided++;
+		return issue;
+	}
+
+	/**
+	Forgets a texture that is about to be deleted
+	@param texture The texture name
+	*/
+	void forget(GLuint texture);
+
+	/** The cached state */
+	State current;
+
+	/** States saved by push */
+	vector<State> stack;
+
+	/** Filter settings last applied to each texture */
+	map<GLuint, pair<int, float> > textureFilters;
+
+	/** State calls issued */
+	static size_t numIssued;
+
+	/** State calls elided */
+	static size_t numElided;
+};
+
+} // namespace Engine
+
+#define g_StateCache (::Engine::StateCache::GetSingleton())
+
+#endif
@@ -28,7 +28,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "stdafx.h"
 #include "world.h"
 #include "player.h"
-#include "CallbackTask.h"
 #include "GameStateRun.h"
 #include "Switch.h"
 
@@ -95,6 +94,11 @@ bool Switch::pollConditions(void) const
 	return false;
 }
 
+bool Switch::canSleep(void) const
+{
+	return fadeTimer <= 0 && Trigger::canSleep();
+}
+
 void Switch::update(float deltaTime)
 {
 	TriggerPrompt &prompt = GameStateRun::GetSingleton().getPrompt();
@@ -94,6 +94,12 @@ protected:
 	/** Called in the event of the Trigger activating */
 	virtual void onTrigger(void);
 
+	/**
+	The switch stays awake until its prompt has faded
+	@return true if the switch is idle
+	*/
+	virtual bool canSleep(void) const;
+
 	/**
 	Called when the switch is triggered and actually used
 	@param a The actor that uses the switch
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "Effect.h"
 #include "TextureHandle.h"
 
@@ -57,6 +58,7 @@ TextureHandle::TextureHandle(const string &fileName, int width, int height, bool
 
 void TextureHandle::release(void)
 {
+	StateCache::forgetTexture(id);
 	glDeleteTextures(1, &id);
 	id=0;
 }
@@ -72,7 +74,7 @@ void TextureHandle::reaquire(void)
 	glGenTextures(1, &id);
 
 	// and bind it as the present texture
-	glBindTexture(GL_TEXTURE_2D, id);
+	g_StateCache.bindTexture(id);
 
 	// Set the texture filtering according to global performance settings
 	Effect::setTextureFilters();
@@ -29,6 +29,7 @@ E-Mail: mailto:foxostro@gmail.com
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "WaitScreen.h"
 #include "Effect.h"
 #include "TextureManager.h"
@@ -56,7 +57,6 @@ bool CheckStr(TextureHandle &tex, string chkstr)
 TextureManager::TextureManager()
 {
 	tlist.clear();
-	prestex=0U;
 }
 
 TextureManager::~TextureManager()
@@ -109,7 +109,7 @@ TextureHandle* TextureManager::Create(Image &img)
 
 	CHECK_GL_ERROR();
 	glGenTextures(1, &id);
-	glBindTexture(GL_TEXTURE_2D, id);
+	g_StateCache.bindTexture(id);
 	Effect::setTextureFilters();
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -147,18 +147,11 @@ TextureHandle* TextureManager::Create(Image &img)
 
 void TextureManager::Set(GLuint texID)
 {
-	// do we need to change the texture
-	if(texID != prestex)
-	{
-		// set to the id
-		glBindTexture(GL_TEXTURE_2D, texID);
-
-		// Set the texture filtering according to global performance settings
-		Effect::setTextureFilters();
+	// The state cache skips the bind when the texture is already bound
+	g_StateCache.bindTexture(texID);
 
-		// and set as present texture
-		prestex=texID;
-	}
+	// Set the texture filtering according to global performance settings
+	Effect::setTextureFilters();
 }
 
 TextureHandle* TextureManager::getHandle(GLuint texid)
@@ -44,9 +44,6 @@ private:
 	/** the texture list */
 	TListType tlist;
 
-	/** present texture */
-	unsigned int prestex;
-
 public:
 	/** Constructor */
 	TextureManager();
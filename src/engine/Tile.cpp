@@ -29,23 +29,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h"
-#include "gl.h"
 #include "file.h"
 #include "Tile.h"
 #include "Map.h"
+#include "MapChunk.h"
 
 namespace Engine {
 
-void texCoord(float u, float v)
-{
-	glTexCoord2f(u, v);
-
-	if(g_bUseMultitexture)
-	{
-		glMultiTexCoord2fARB(textureStages[0], u, v);
-	}
-}
-
 Tile::Tile(void)
 :type(TILE_BLOCK),
 propertiesBitmap(0),
@@ -125,77 +115,49 @@ void Tile::setupNeighbors(Map &owner, int x, int z)
 	if(x-1 > 0)						west = &owner.getTile(x-1,z);
 }
 
-void Tile::drawWalls(const Tile *north, const Tile *south, const Tile *east, const Tile *west) const
+void Tile::bakeWalls(const vec3 &origin, const vec3 &scale, MapChunk &chunk) const
 {
 	if(fabsf(getTileHeight()) < FLT_EPSILON)
 	{
 		return;
 	}
 
-	float minV = 1.0f - getTileHeight() / 2.4f;
-
-	// Set the material of the Tile
-	if(wallMat) wallMat->bind();
-
-	// Draw the cube
-	glBegin(GL_QUADS);
-
-		if(SHOULD_DRAW_WALL(north))
-		{
-			glNormal3f( 0.0f, 0.0f, 1.0f);
-			texCoord(0.0f, minV); glVertex3f(0.0f, 0.0f, 1.0f);
-			texCoord(1.0f, minV); glVertex3f(1.0f, 0.0f, 1.0f);
-			texCoord(1.0f, 1.0f); glVertex3f(1.0f, 1.0f, 1.0f);
-			texCoord(0.0f, 1.0f); glVertex3f(0.0f, 1.0f, 1.0f);
-		}
-
-		if(SHOULD_DRAW_WALL(south))
-		{
-			glNormal3f( 0.0f, 0.0f, -1.0f);
-			texCoord(1.0f, minV); glVertex3f(0.0f, 0.0f, 0.0f);
-			texCoord(1.0f, 1.0f); glVertex3f(0.0f, 1.0f, 0.0f);
-			texCoord(0.0f, 1.0f); glVertex3f(1.0f, 1.0f, 0.0f);
-			texCoord(0.0f, minV); glVertex3f(1.0f, 0.0f, 0.0f);
-		}
-
-		if(SHOULD_DRAW_WALL(east))
-		{
-			glNormal3f( 1.0f, 0.0f, 0.0f);
-			texCoord(1.0f, minV); glVertex3f(1.0f, 0.0f, 0.0f);
-			texCoord(1.0f, 1.0f); glVertex3f(1.0f, 1.0f, 0.0f);
-			texCoord(0.0f, 1.0f); glVertex3f(1.0f, 1.0f, 1.0f);
-			texCoord(0.0f, minV); glVertex3f(1.0f, 0.0f, 1.0f);
-		}
-
-		if(SHOULD_DRAW_WALL(west))
-		{
-			glNormal3f(-1.0f, 0.0f, 0.0f);
-			texCoord(0.0f, minV); glVertex3f(0.0f, 0.0f, 0.0f);
-			texCoord(1.0f, minV); glVertex3f(0.0f, 0.0f, 1.0f);
-			texCoord(1.0f, 1.0f); glVertex3f(0.0f, 1.0f, 1.0f);
-			texCoord(0.0f, 1.0f); glVertex3f(0.0f, 1.0f, 0.0f);
-		}
-	glEnd();
-}
+	const float minV = 1.0f - getTileHeight() / 2.4f;
 
-void Tile::drawFloor(const Tile *, const Tile *, const Tile *, const Tile *) const
-{
-	// Set the material of the floor
-	if(floorMat) floorMat->bind();
-
-	glBegin(GL_QUADS);
-		glNormal3f( 0.0f, 1.0f, 0.0f);
-		texCoord(0.0f, 1.0f); glVertex3f(0.0f, 1.0f, 1.0f);
-		texCoord(1.0f, 1.0f); glVertex3f(1.0f, 1.0f, 1.0f);
-		texCoord(1.0f, 0.0f); glVertex3f(1.0f, 1.0f, 0.0f);
-		texCoord(0.0f, 0.0f); glVertex3f(0.0f, 1.0f, 0.0f);
-	glEnd();
+	if(SHOULD_DRAW_WALL(north))
+	{
+		const vec3 positions[] = { vec3(0,0,1), vec3(1,0,1), vec3(1,1,1), vec3(0,1,1) };
+		const float texCoords[] = { 0,minV,  1,minV,  1,1,  0,1 };
+		chunk.addQuad(wallMat, vec3(0,0,1), origin, scale, positions, texCoords);
+	}
+
+	if(SHOULD_DRAW_WALL(south))
+	{
+		const vec3 positions[] = { vec3(0,0,0), vec3(0,1,0), vec3(1,1,0), vec3(1,0,0) };
+		const float texCoords[] = { 1,minV,  1,1,  0,1,  0,minV };
+		chunk.addQuad(wallMat, vec3(0,0,-1), origin, scale, positions, texCoords);
+	}
+
+	if(SHOULD_DRAW_WALL(east))
+	{
+		const vec3 positions[] = { vec3(1,0,0), vec3(1,1,0), vec3(1,1,1), vec3(1,0,1) };
+		const float texCoords[] = { 1,minV,  1,1,  0,1,  0,minV };
+		chunk.addQuad(wallMat, vec3(1,0,0), origin, scale, positions, texCoords);
+	}
+
+	if(SHOULD_DRAW_WALL(west))
+	{
+		const vec3 positions[] = { vec3(0,0,0), vec3(0,0,1), vec3(0,1,1), vec3(0,1,0) };
+		const float texCoords[] = { 0,minV,  1,minV,  1,1,  0,1 };
+		chunk.addQuad(wallMat, vec3(-1,0,0), origin, scale, positions, texCoords);
+	}
 }
 
-void Tile::drawBlockTypeTile(const Tile *north, const Tile *south, const Tile *east, const Tile *west) const
+void Tile::bakeFloor(const vec3 &origin, const vec3 &scale, MapChunk &chunk) const
 {
-	drawFloor(north, south, east, west);
-	drawWalls(north, south, east, west);
+	const vec3 positions[] = { vec3(0,1,1), vec3(1,1,1), vec3(1,1,0), vec3(0,1,0) };
+	const float texCoords[] = { 0,1,  1,1,  1,0,  0,0 };
+	chunk.addQuad(floorMat, vec3(0,1,0), origin, scale, positions, texCoords);
 }
 
 void Tile::setupBoundingBox(float width, float height)
@@ -205,28 +167,19 @@ void Tile::setupBoundingBox(float width, float height)
 	boundingBox.m_Pos = vec3(0,0,0); // we don't know where in the map we are
 }
 
-void Tile::draw(float x, float z) const
+void Tile::bake(const vec3 &origin, MapChunk &chunk) const
 {
-	if(type == TILE_EMPTY)
+	if(type != TILE_BLOCK)
 	{
 		return;
 	}
 
-	float width = boundingBox.m_Max.x-boundingBox.m_Min.x;
-	float height = boundingBox.m_Max.y-boundingBox.m_Min.y;
-	float depth = boundingBox.m_Max.z-boundingBox.m_Min.z;
-
-	glPushMatrix();
-	glTranslatef(x - width/2, 0.0f, z - depth/2);
-	glScalef(width, height, depth);
-
-	switch(type)
-	{
-	case TILE_BLOCK: drawBlockTypeTile(north, south, east, west); break;
-	default: break;
-	};
+	const vec3 scale(boundingBox.m_Max.x-boundingBox.m_Min.x,
+	                 boundingBox.m_Max.y-boundingBox.m_Min.y,
+	                 boundingBox.m_Max.z-boundingBox.m_Min.z);
 
-	glPopMatrix();
+	bakeFloor(origin, scale, chunk);
+	bakeWalls(origin, scale, chunk);
 }
 
 bool Tile::setPassable(bool passable)
@@ -38,6 +38,7 @@ namespace Engine {
 
 // prototype
 class Map;
+class MapChunk;
 
 
 
@@ -79,11 +80,11 @@ public:
 	Tile(void);
 
 	/**
-	Draws the Tile.
-	@param x		The world space x coordinate of the Tile
-	@param y		The world space y coordinate of the Tile
+	Adds the world-space geometry of the Tile to a map chunk
+	@param origin	The world space position of the Tile's south-west corner
+	@param chunk	The chunk being rebuilt
 	*/
-	void draw(float x, float z) const;
+	void bake(const vec3 &origin, MapChunk &chunk) const;
 
 	/**
 	Determines whether the Tile is passable or unpassable.
@@ -228,31 +229,20 @@ private:
 	void setupNeighbors(Map &owner, int x, int z);
 
 	/**
-	Draws the walls of a block-type tile
-	@param north	The northern tile.
-	@param south	The southern tile.
-	@param east		The eastern tile.
-	@param west		The western tile.
+	Adds the walls of a block-type tile to a map chunk
+	@param origin	The world space position of the Tile's south-west corner
+	@param scale	The dimensions of the Tile
+	@param chunk	The chunk being rebuilt
 	*/
-	void drawWalls(const Tile *north, const Tile *south, const Tile *east, const Tile *west) const;
+	void bakeWalls(const vec3 &origin, const vec3 &scale, MapChunk &chunk) const;
 
 	/**
-	Draws the floor of a block-type tile
-	@param north	The northern tile.
-	@param south	The southern tile.
-	@param east		The eastern tile.
-	@param west		The western tile.
+	Adds the floor of a block-type tile to a map chunk
+	@param origin	The world space position of the Tile's south-west corner
+	@param scale	The dimensions of the Tile
+	@param chunk	The chunk being rebuilt
 	*/
-	void drawFloor(const Tile *north, const Tile *south, const Tile *east, const Tile *west) const;
-
-	/**
-	Draws the walls of a block-type tile
-	@param north	The northern tile.
-	@param south	The southern tile.
-	@param east		The eastern tile.
-	@param west		The western tile.
-	*/
-	void drawBlockTypeTile(const Tile *north, const Tile *south, const Tile *east, const Tile *west) const;
+	void bakeFloor(const vec3 &origin, const vec3 &scale, MapChunk &chunk) const;
 
 	/**
 	Should we draw a wall between the border to the tile here?
@@ -46,11 +46,17 @@ GEN_ACTOR_RTTI_CPP(Trigger, "class Engine::Trigger")
 
 
 Trigger::Trigger(OBJECT_ID ID)
-: Actor(ID)
+: Actor(ID),
+  region(-1)
 {}
 
 void Trigger::destroy(void)
 {
+	if(region != -1)
+	{
+		getZone().getRegions().remove(region, m_ID);
+	}
+
 	Actor::destroy();
 }
 
@@ -59,20 +65,103 @@ void Trigger::clear(void)
 	Actor::clear();
 	sounds.clear();
 	triggerRadius=2.0f;
+	region=-1;
 }
 
 void Trigger::update(float deltaTime)
 {
 	Actor::update(deltaTime);
 
-	if(pollConditions())
+	updateRegion();
+
+	// Only the occupants of the region can satisfy the conditions
+	if(getRegionMask() != REGION_OCCUPANT_NONE && getRegionOccupants().empty())
+		onDoesntTrigger();
+	else if(pollConditions())
 		onTrigger();
 	else
 		onDoesntTrigger();
 }
 
+bool Trigger::canSleep(void) const
+{
+	if(getRegionMask() == REGION_OCCUPANT_NONE)
+		return false;
+
+	return getRegionOccupants().empty() && Actor::canSleep();
+}
+
+void Trigger::onRegionEnter(OBJECT_ID)
+{
+	wake();
+}
+
+void Trigger::onRegionStay(OBJECT_ID)
+{
+	wake();
+}
+
+void Trigger::onRegionExit(OBJECT_ID)
+{
+	wake();
+}
+
+void Trigger::updateRegion(void)
+{
+	RegionManager &regions = getZone().getRegions();
+
+	const unsigned int mask = getRegionMask();
+
+	if(mask == REGION_OCCUPANT_NONE)
+	{
+		regions.remove(region, m_ID);
+		region = -1;
+	}
+	else if(regions.isRegion(region, m_ID))
+	{
+		regions.move(region, getPos(), getRegionRadius());
+	}
+	else
+	{
+		// Not yet added, or the zone's regions were reset since then
+		region = regions.add(m_ID, getPos(), getRegionRadius(), mask);
+	}
+}
+
+const vector<OBJECT_ID>& Trigger::getRegionOccupants(void) const
+{
+	static const vector<OBJECT_ID> none;
+
+	const RegionManager &regions = getZone().getRegions();
+
+	return regions.isRegion(region, m_ID) ? regions.getOccupants(region) : none;
+}
+
 bool Trigger::playerIsInProximity(OBJECT_ID &player) const
 {
+	if(zombie)
+		return false;
+
+	// Only players near the trigger at the last tick need to be considered
+	if(region != -1)
+	{
+		const ActorSet &s = getZone().getObjects();
+		const vector<OBJECT_ID> &occupants = getRegionOccupants();
+
+		for(vector<OBJECT_ID>::const_iterator i = occupants.begin(); i != occupants.end(); ++i)
+		{
+			const Actor *a = s.getPtr(*i);
+
+			if(a && !a->zombie && instanceof(*a, Player) && isInProximity(*i, triggerRadius))
+			{
+				player = *i;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	for(size_t i=0; i<getZone().getNumOfPlayers(); ++i)
 	{
 		const Actor &a = getZone().getPlayer(i);
@@ -73,6 +73,26 @@ public:
 	*/
 	virtual void createToolBar(ListPaneWidget *pane);
 
+	/**
+	Called when an actor first occupies the trigger's region.
+	Wakes the trigger so that it tests its conditions from the next tick on.
+	@param actor The actor
+	*/
+	virtual void onRegionEnter(OBJECT_ID actor);
+
+	/**
+	Called for each tick that an actor remains in the trigger's region
+	@param actor The actor
+	*/
+	virtual void onRegionStay(OBJECT_ID actor);
+
+	/**
+	Called when an actor leaves the trigger's region.
+	Wakes the trigger so that it sees the region empty before going to sleep.
+	@param actor The actor
+	*/
+	virtual void onRegionExit(OBJECT_ID actor);
+
 protected:
 	/**
 	Determine whether the proper conditions have been attained for trigger activation.
@@ -81,10 +101,18 @@ protected:
 	*/
 	virtual bool pollConditions(void) const;
 
+	/**
+	A trigger with a region sleeps while its region is empty, as only an
+	occupant can satisfy its conditions and the region wakes it on entry.
+	Triggers without a region must poll their conditions each tick.
+	@return true if the trigger is idle
+	*/
+	virtual bool canSleep(void) const;
+
 	/** Called in the event of the Trigger activating */
 	virtual void onTrigger(void);
 
-	/** Called every frame the trigger doesn's activate */
+	/** Called every tick that the trigger is awake and doesn't activate */
 	virtual void onDoesntTrigger(void) {}
 
 	/**
@@ -94,6 +122,36 @@ protected:
 	*/
 	bool playerIsInProximity(OBJECT_ID &player) const;
 
+	/**
+	Gets the kinds of actors that may occupy the trigger's region
+	@return REGION_OCCUPANT flags, or REGION_OCCUPANT_NONE for no region
+	*/
+	virtual unsigned int getRegionMask(void) const
+	{
+		return REGION_OCCUPANT_PLAYER;
+	}
+
+	/**
+	Gets the radius of the trigger's region
+	@return radius of the region
+	*/
+	virtual float getRegionRadius(void) const
+	{
+		return triggerRadius;
+	}
+
+	/**
+	Adds, moves, or removes the trigger's region to follow the trigger.
+	Occupants of the region are as of the previous tick of the zone.
+	*/
+	void updateRegion(void);
+
+	/**
+	Gets the actors that occupied the trigger's region at the last tick
+	@return occupants of the region
+	*/
+	const vector<OBJECT_ID>& getRegionOccupants(void) const;
+
 	/**
 	Saves the object state to an XML data source, but only if it differs from the default value
 	@param xml The XML data source returned
@@ -113,6 +171,9 @@ protected:
 
 	/** Radius of the trigger */
 	float triggerRadius;
+
+	/** Handle to the region of the trigger in the zone */
+	RegionManager::HANDLE region;
 };
 
 } // namespace Engine
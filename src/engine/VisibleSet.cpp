@@ -0,0 +1,170 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "stdafx.h"
+#include <boost/bind.hpp>
+#include "Application.h"
+#include "frustum.h"
+#include "MapChunk.h"
+#include "Map.h"
+#include "ActorSet.h"
+#include "RenderQueue.h"
+#include "LightManager.h"
+#include "profile.h"
+#include "VisibleSet.h"
+
+namespace Engine {
+
+VisibleSet::VisibleSet(void)
+{
+	clear();
+}
+
+void VisibleSet::clear(void)
+{
+	chunks.clear();
+	chunkBounds.clear();
+	chunkLights.clear();
+	actors.clear();
+	actorLights.clear();
+	actorBounds.clear();
+	numCullingTests = 0;
+}
+
+void VisibleSet::addChunk(MapChunk *chunk, const vec3 &boxMin, const vec3 &boxMax)
+{
+	chunks.push_back(chunk);
+	chunkBounds.add(boxMin, boxMax);
+}
+
+void VisibleSet::gather(const Frustum &frustum, const Map &map, const ActorSet &objects, const LightManager &lights)
+{
+	PROFILE
+
+	clear();
+
+	map.gatherVisible(frustum, *this);
+	numCullingTests += map.getNumChunks();
+
+	// Cull all the actors at once, as one batch of bounding spheres
+	candidateBounds.clear();
+
+	for(ActorSet::const_iterator i=objects.begin(); i!=objects.end(); ++i)
+	{
+		const Actor *p = i->second;
+		candidateBounds.add(p->getPos(), p->getSphereRadius()*2);
+	}
+
+	frustum.cull(candidateBounds);
+	numCullingTests += candidateBounds.size();
+
+	size_t index = 0;
+	for(ActorSet::const_iterator i=objects.begin(); i!=objects.end(); ++i, ++index)
+	{
+		Actor *p = i->second;
+
+		if(p->zombie || !candidateBounds.isVisible(index))
+			continue;
+
+		const vec3 &pos = p->getPos();
+		const float radius = p->getSphereRadius()*2;
+
+		actors.push_back(p);
+		actorBounds.add(pos, radius);
+		actorLights.push_back(lights.selectLights(pos, radius));
+	}
+
+	// Select lights once here, rather than in every pass that replays the set
+	for(size_t i=0; i<chunks.size(); ++i)
+	{
+		const vec3 center = chunkBounds.getCenter(i);
+		const float radius = vec3(chunkBounds.getMax(i) - center).getMagnitude();
+		chunkLights.push_back(lights.selectLights(center, radius));
+	}
+}
+
+void VisibleSet::submit(RenderQueue &queue) const
+{
+	for(size_t i=0; i<chunks.size(); ++i)
+	{
+		queue.setLightSet(chunkLights[i]);
+		chunks[i]->submit(queue, chunkBounds.getCenter(i));
+	}
+
+	for(size_t i=0; i<actors.size(); ++i)
+	{
+		queue.setLightSet(actorLights[i]);
+		submitActor(queue, actors[i]);
+	}
+
+	queue.setLightSet(LightManager::GLOBAL_LIGHT_SET);
+}
+
+void VisibleSet::submit(RenderQueue &queue, const Frustum &frustum) const
+{
+	frustum.cull(chunkBounds);
+	frustum.cull(actorBounds);
+	numCullingTests += chunkBounds.size() + actorBounds.size();
+
+	for(size_t i=0; i<chunks.size(); ++i)
+	{
+		if(chunkBounds.isVisible(i))
+		{
+			queue.setLightSet(chunkLights[i]);
+			chunks[i]->submit(queue, chunkBounds.getCenter(i));
+		}
+	}
+
+	for(size_t i=0; i<actors.size(); ++i)
+	{
+		if(actorBounds.isVisible(i))
+		{
+			queue.setLightSet(actorLights[i]);
+			submitActor(queue, actors[i]);
+		}
+	}
+
+	queue.setLightSet(LightManager::GLOBAL_LIGHT_SET);
+}
+
+void VisibleSet::submitActor(RenderQueue &queue, const Actor *actor)
+{
+	actor->submit(queue);
+
+	if(g_Application.displayDebugData)
+	{
+		queue.addCustom(RenderQueue::TRANSPARENT_BUCKET,
+		                actor->getPos(),
+		                boost::bind(&Actor::drawObjectDebugData, actor));
+	}
+}
+
+} // namespace Engine
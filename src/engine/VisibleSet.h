@@ -0,0 +1,159 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _VISIBLE_SET_H_
+#define _VISIBLE_SET_H_
+
+#include "vec4.h"
+#include "CullingBatch.h"
+
+namespace Engine {
+
+class Frustum;
+class MapChunk;
+class Actor;
+class ActorSet;
+class Map;
+class RenderQueue;
+class LightManager;
+
+/**
+The map chunks and actors that lie within the camera frustum.
+The set is gathered once per frame, and then every pass of the scene
+replays it instead of culling the map and the actors all over again.
+Passes that only touch part of the view, such as the stencil pass of a
+shadow, further intersect the set with their own frustum.
+*/
+class VisibleSet
+{
+public:
+	/** Constructor */
+	VisibleSet(void);
+
+	/** Empties the set and resets the culling counter */
+	void clear(void);
+
+	/**
+	Rebuilds the set from the map and the actors in the World
+	@param frustum The camera frustum
+	@param map The tile map
+	@param objects The actors
+	@param lights Selects the lights for each chunk and actor
+	*/
+	void gather(const Frustum &frustum, const Map &map, const ActorSet &objects, const LightManager &lights);
+
+	/**
+	Adds a map chunk to the set
+	@param chunk The chunk
+	@param boxMin Minimum corner of the chunk's bounding box
+	@param boxMax Maximum corner of the chunk's bounding box
+	*/
+	void addChunk(MapChunk *chunk, const vec3 &boxMin, const vec3 &boxMax);
+
+	/**
+	Queues everything in the set to be drawn
+	@param queue The render queue
+	*/
+	void submit(RenderQueue &queue) const;
+
+	/**
+	Queues the part of the set that lies within another frustum
+	@param queue The render queue
+	@param frustum The frustum to intersect with the set
+	*/
+	void submit(RenderQueue &queue, const Frustum &frustum) const;
+
+	/**
+	Gets the number of map chunks in the set
+	@return number of visible chunks
+	*/
+	inline size_t getNumChunks(void) const
+	{
+		return chunks.size();
+	}
+
+	/**
+	Gets the number of actors in the set
+	@return number of visible actors
+	*/
+	inline size_t getNumActors(void) const
+	{
+		return actors.size();
+	}
+
+	/**
+	Gets the number of frustum tests made since the set was last gathered
+	@return culling tests this frame
+	*/
+	inline size_t getNumCullingTests(void) const
+	{
+		return numCullingTests;
+	}
+
+private:
+	/**
+	Queues an actor to be drawn, along with its debug text
+	@param queue The render queue
+	@param actor The actor
+	*/
+	static void submitActor(RenderQueue &queue, const Actor *actor);
+
+	/** Visible map chunks */
+	vector<MapChunk*> chunks;
+
+	/** Bounding boxes of the visible map chunks */
+	mutable BoxBatch chunkBounds;
+
+	/** Light set of each visible map chunk */
+	vector<size_t> chunkLights;
+
+	/** Visible actors */
+	vector<Actor*> actors;
+
+	/** Bounding spheres of the visible actors */
+	mutable SphereBatch actorBounds;
+
+	/** Light set of each visible actor */
+	vector<size_t> actorLights;
+
+	/**
+	Bounding spheres of every actor in the World, kept between frames so
+	that each actor's last rejecting plane is tried first next time
+	*/
+	SphereBatch candidateBounds;
+
+	/** Frustum tests made since the set was last gathered */
+	mutable size_t numCullingTests;
+};
+
+} // namespace Engine
+
+#endif
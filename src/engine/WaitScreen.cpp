@@ -7,6 +7,7 @@ E-Mail: mailto:tcauchoi@andrew.cmu.edu
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "SDLwindow.h"
 #include "image.h"
 #include "TextureHandle.h"
@@ -34,13 +35,13 @@ void WaitScreen::Render(void)
 
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 
 
 
 	effect_Begin(effect_GUI);
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
 	CHECK_GL_ERROR();
 
@@ -52,8 +53,8 @@ void WaitScreen::Render(void)
 	backDrop.getTexture().bind();
 
 	// Render a textured quad over the screen
-	glDisable(GL_ALPHA_TEST);
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.disable(GL_ALPHA_TEST);
+	g_StateCache.enable(GL_TEXTURE_2D);
 	glBegin(GL_QUADS);
 		glTexCoord2f(1.0f, 0.0f); glVertex3f(1024.0f,   0.0f, 0.0f);
 		glTexCoord2f(1.0f, 1.0f); glVertex3f(1024.0f, 768.0f, 0.0f);
@@ -63,7 +64,7 @@ void WaitScreen::Render(void)
 
 	CHECK_GL_ERROR();
 
-	glPopAttrib();
+	g_StateCache.pop();
 	effect_End();
 
 
@@ -33,6 +33,94 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Engine {
 
+unsigned int AnimationSequence::SharedData::currentFrame = 0;
+float AnimationSequence::timeStep = 10.0f;
+size_t AnimationSequence::numFrameRequests = 0;
+size_t AnimationSequence::numFrameCacheHits = 0;
+
+AnimationSequence::SharedData::SharedData(void)
+: priority(0.0f),
+  looping(false),
+  fps(0.0f),
+  sameTopology(true),
+  numFrameBuffersUsed(0),
+  bufferFrame(currentFrame)
+{}
+
+AnimationSequence::SharedData::~SharedData(void)
+{
+	for(size_t i=0; i<frameBuffers.size(); ++i)
+	{
+		for_each(frameBuffers[i].begin(), frameBuffers[i].end(), bind(delete_ptr(), _1));
+	}
+}
+
+void AnimationSequence::SharedData::createWorkingSetOfMeshes(Model &model) const
+{
+	const Model &meshes = keyFrames[0].getMeshes();
+
+	for_each(meshes.begin(), meshes.end(),
+				bind(&vector<Mesh*>::push_back,
+						&model,
+						bind(new_ptr<Mesh>(), _1)
+					)
+			);
+}
+
+Model& AnimationSequence::SharedData::acquireFrameBuffer(float time, bool &cached) const
+{
+	if(bufferFrame != currentFrame)
+	{
+		bufferFrame = currentFrame;
+		numFrameBuffersUsed = 0;
+		frameBuffersByTime.clear();
+	}
+
+	map<float, size_t>::const_iterator i = frameBuffersByTime.find(time);
+
+	if(i != frameBuffersByTime.end())
+	{
+		cached = true;
+		return frameBuffers[i->second];
+	}
+
+	if(numFrameBuffersUsed == frameBuffers.size())
+	{
+		frameBuffers.push_back(Model());
+		createWorkingSetOfMeshes(frameBuffers.back());
+	}
+
+	cached = false;
+	frameBuffersByTime.insert(make_pair(time, numFrameBuffersUsed));
+
+	return frameBuffers[numFrameBuffersUsed++];
+}
+
+size_t AnimationSequence::SharedData::getMemoryUsage(void) const
+{
+	size_t bytes = sizeof(SharedData);
+
+	for(size_t i=0; i<keyFrames.size(); ++i)
+	{
+		const Model &meshes = keyFrames[i].getMeshes();
+
+		for(size_t j=0; j<meshes.size(); ++j)
+		{
+			bytes += meshes[j]->getMemoryUsage();
+		}
+	}
+
+	for(size_t i=0; i<frameBuffers.size(); ++i)
+	{
+		for(size_t j=0; j<frameBuffers[i].size(); ++j)
+		{
+			bytes += frameBuffers[i][j]->getMemoryUsage();
+		}
+	}
+
+	return bytes;
+}
+
 AnimationSequence::AnimationSequence
 (
 	vector<KeyFrame> keyFrames,
@@ -43,52 +131,47 @@ AnimationSequence::AnimationSequence
 	size_t length,
 	float fps
 )
-: m_strName(name),
-  m_Priority(priority),
+: data(new SharedData),
   m_Time(0.0f),
   m_TimeScalar(1.0f),
-  m_bLooping(looping),
-  fps(fps),
   m_bFinished(false)
 {
 	for(size_t i=0; i<length; ++i)
 	{
-		this->keyFrames.push_back(keyFrames[start+i]);
+		data->keyFrames.push_back(keyFrames[start+i]);
 	}
 
-	createWorkingSetOfMeshes(keyFrames[start].getMeshes());
-}
+	// Vertices may be paired up by index when all keyframes share topology
+	for(size_t i=1; i<data->keyFrames.size(); ++i)
+	{
+		const Model &a = data->keyFrames[0].getMeshes();
+		const Model &b = data->keyFrames[i].getMeshes();
 
-AnimationSequence::AnimationSequence(const AnimationSequence &animation)
-: keyFrames(animation.keyFrames),
-  m_strName(animation.m_strName),
-  m_Priority(animation.m_Priority),
-  m_Time(animation.m_Time),
-  m_TimeScalar(animation.m_TimeScalar),
-  m_bLooping(animation.m_bLooping),
-  fps(animation.fps),
-  m_bFinished(animation.m_bFinished)
-{
-	createWorkingSetOfMeshes(animation.meshes);
+		ASSERT(a.size() == b.size(), "keyframes of \"" + name + "\" have different numbers of meshes");
+
+		for(size_t j=0; j<a.size(); ++j)
+		{
+			data->sameTopology = data->sameTopology && a[j]->hasSameTopology(*b[j]);
+		}
+	}
+
+	data->name = name;
+	data->priority = priority;
+	data->looping = looping;
+	data->fps = fps;
 }
 
-AnimationSequence::~AnimationSequence(void)
+size_t AnimationSequence::getSharedMemoryUsage(void) const
 {
-	for(size_t i=0; i<meshes.size(); ++i) delete meshes[i];
-	meshes.clear();
+	return data->getMemoryUsage();
 }
 
-void AnimationSequence::createWorkingSetOfMeshes(const Model &model)
+void AnimationSequence::beginFrame(void)
 {
-	for_each(model.begin(), model.end(),
-				bind(&vector<Mesh*>::push_back,
-						&meshes,
-						bind(new_ptr<Mesh>(), _1)
-					)
-			);
+	SharedData::currentFrame++;
 }
 
-void AnimationSequence::draw(void)
+void AnimationSequence::draw(void) const
 {
 	const vector<Mesh*> & meshes = getFrame();
 	for_each(meshes.begin(), meshes.end(), bind(&Mesh::draw, _1));
@@ -101,7 +184,7 @@ void AnimationSequence::update(float millisecondsDelta)
 	// Loop the animation if it goes past the end
 	if(m_Time > getLength())
 	{
-		if(m_bLooping == true)
+		if(data->looping == true)
 		{
 			while(m_Time > getLength()) m_Time -= getLength();
 			m_bFinished = false;
@@ -122,94 +205,79 @@ void AnimationSequence::SetTime(float Time)
 
 float AnimationSequence::CalculateCylindricalRadius(float Time)
 {
-	vector<Mesh*> meshes = getFrame(Time);
+	size_t lowerFrame=0, upperFrame=0;
+	float bias=0.0f;
 
-	if(meshes.empty())
-	{
-		return 0.0f;
-	}
-	else
-	{
-		vector<float> radii;
-		transform(meshes.begin(), meshes.end(), back_inserter(radii), bind(&Mesh::calculateCylindricalRadius, _1));
-		sort(radii.begin(), radii.end(), greater<float>());
+	findKeyFrames(Time, lowerFrame, upperFrame, bias);
 
-		return radii[0];
-	}
+	return max(data->keyFrames[lowerFrame].getCylindricalRadius(),
+	           data->keyFrames[upperFrame].getCylindricalRadius());
 }
 
-static float getTop(BoundingBox b) { return b.m_Max.y; }
-static float getBtm(BoundingBox b) { return b.m_Min.y; }
-
 float AnimationSequence::CalculateHeight(float Time)
 {
-	vector<Mesh*> meshes = getFrame(Time);
+	size_t lowerFrame=0, upperFrame=0;
+	float bias=0.0f;
 
-	if(meshes.empty())
-	{
-		return 0.0f;
-	}
-	else
-	{
-		vector<float> top, btm;
-
-		transform(meshes.begin(), meshes.end(), back_inserter(top), bind(&getTop, bind(&Mesh::calculateBoundingBox, _1)));
-		transform(meshes.begin(), meshes.end(), back_inserter(btm), bind(&getBtm, bind(&Mesh::calculateBoundingBox, _1)));
+	findKeyFrames(Time, lowerFrame, upperFrame, bias);
 
-		sort(top.begin(), top.end(), greater<float>());
-		sort(btm.begin(), btm.end(), less<float>());
+	const KeyFrame &a = data->keyFrames[lowerFrame];
+	const KeyFrame &b = data->keyFrames[upperFrame];
 
-		return(top[0] - btm[0]);
-	}
+	return max(a.getMaxCorner().y, b.getMaxCorner().y) - min(a.getMinCorner().y, b.getMinCorner().y);
 }
 
 float AnimationSequence::CalculateRadius(float Time)
 {
-	vector<Mesh*> meshes = getFrame(Time);
+	size_t lowerFrame=0, upperFrame=0;
+	float bias=0.0f;
 
-	if(meshes.empty())
-	{
-		return 0.0f;
-	}
-	else
-	{
-		vector<float> radii;
+	findKeyFrames(Time, lowerFrame, upperFrame, bias);
 
-		transform(meshes.begin(), meshes.end(), back_inserter(radii), bind(&Mesh::calculateRadius, _1));
-		sort(radii.begin(), radii.end(), greater<float>());
-
-		return radii[0];
-	}
+	return max(data->keyFrames[lowerFrame].getRadius(),
+	           data->keyFrames[upperFrame].getRadius());
 }
 
 void AnimationSequence::calculateFOV(mat4 &mat, float &lxMax, float &lyMax) const
 {
-	vec3 vert1, vert2;
+	size_t lowerFrame=0, upperFrame=0;
+	float bias=0.0f;
+
+	findKeyFrames(getTime(), lowerFrame, upperFrame, bias);
 
-	vector<Mesh*> s = getFrame();
+	const KeyFrame &a = data->keyFrames[lowerFrame];
+	const KeyFrame &b = data->keyFrames[upperFrame];
 
-	// for each mesh
-	for(vector<Mesh*>::iterator i=s.begin(); i!=s.end(); ++i)
+	// The interpolated frame lies within the union of the keyframes' boxes
+	const vec3 lo(min(a.getMinCorner().x, b.getMinCorner().x),
+	              min(a.getMinCorner().y, b.getMinCorner().y),
+	              min(a.getMinCorner().z, b.getMinCorner().z));
+
+	const vec3 hi(max(a.getMaxCorner().x, b.getMaxCorner().x),
+	              max(a.getMaxCorner().y, b.getMaxCorner().y),
+	              max(a.getMaxCorner().z, b.getMaxCorner().z));
+
+	// For each corner of the box
+	for(int i=0; i<8; ++i)
 	{
-		const Mesh *mesh = (*i);
+		// Transform the corner by the matrix
+		vec3 vert1((i&1) ? hi.x : lo.x,
+		           (i&2) ? hi.y : lo.y,
+		           (i&4) ? hi.z : lo.z);
+		vert1.w = 1.0f;
 
-		// For each vertex
-		for(int i=0; i<mesh->m_numOfVerts; ++i)
-		{
-			// Transform the vertex by the matrix
-			vert1 = mesh->m_pVerts[i];
-			vert1.w = 1.0f;
-			vert2 = mat.transformVector(vert1);
-
-			// Calculate the spread, keep the max
-			lxMax = max(lxMax, fabsf(vert2.x / vert2.z));
-			lyMax = max(lyMax, fabsf(vert2.y / vert2.z));
-		}
+		const vec3 vert2 = mat.transformVector(vert1);
+
+		// Calculate the spread, keep the max
+		lxMax = max(lxMax, fabsf(vert2.x / vert2.z));
+		lyMax = max(lyMax, fabsf(vert2.y / vert2.z));
 	}
 }
 
-const Model& AnimationSequence::getFrame(float milliseconds) const
+void AnimationSequence::findKeyFrames(float milliseconds, size_t &lowerFrame, size_t &upperFrame, float &bias) const
 {
+	const vector<KeyFrame> &keyFrames = data->keyFrames;
+
 	ASSERT(!keyFrames.empty(), "no keyframes in the animation sequence");
 	ASSERT(milliseconds>=0.0f, "Given time is before the beginning of the animation");
 
@@ -221,38 +289,88 @@ const Model& AnimationSequence::getFrame(float milliseconds) const
 
 	*/
 
-
 	if(keyFrames.size() == 1)
-		return(keyFrames[0].getMeshes());
+	{
+		lowerFrame = upperFrame = 0;
+		bias = 0.0f;
+		return;
+	}
 
 	if(milliseconds > getLength())
 		milliseconds = getLength();
 
 	const float frameOfAnimation = (milliseconds / getLength()) * (keyFrames.size() - 1);
-	const size_t lowerFrame = (size_t)floor(frameOfAnimation);
-	const size_t upperFrame = (size_t)ceil(frameOfAnimation);
-	const float bias = frameOfAnimation - lowerFrame;
+	lowerFrame = (size_t)floor(frameOfAnimation);
+	upperFrame = (size_t)ceil(frameOfAnimation);
+	bias = frameOfAnimation - lowerFrame;
 
-	return getFrame(lowerFrame, upperFrame, bias);
+	ASSERT(lowerFrame < keyFrames.size(), "lower keyframe out of range:" + itoa((int)lowerFrame));
+	ASSERT(upperFrame < keyFrames.size(), "upper keyframe out of range: "+ itoa((int)upperFrame));
 }
 
-const Model& AnimationSequence::getFrame(size_t lowerFrame, size_t upperFrame, float bias) const
+float AnimationSequence::quantizeTime(float milliseconds)
 {
-	ASSERT(!keyFrames.empty(), "no keyframes in the animation sequence");
-	ASSERT(lowerFrame < keyFrames.size(), "lower keyframe out of range:" + itoa((int)lowerFrame));
-	ASSERT(upperFrame < keyFrames.size(), "upper keyframe out of range: "+ itoa((int)upperFrame));
-	ASSERT(bias >= 0.0f && bias <= 1.0f, "bias is out of range: " + ftoa(bias));
+	if(timeStep > 0.0f)
+		milliseconds = floorf(milliseconds / timeStep + 0.5f) * timeStep;
+
+	return milliseconds;
+}
+
+float AnimationSequence::getPoseTime(void) const
+{
+	// A single keyframe is the same pose at every time
+	if(data->keyFrames.size() < 2)
+		return 0.0f;
+
+	return quantizeTime(m_Time);
+}
+
+const Model& AnimationSequence::getFrame(float milliseconds) const
+{
+	milliseconds = quantizeTime(milliseconds);
+
+	size_t lowerFrame=0, upperFrame=0;
+	float bias=0.0f;
+
+	findKeyFrames(milliseconds, lowerFrame, upperFrame, bias);
 
 	if(lowerFrame == upperFrame)
-		return(keyFrames[lowerFrame].getMeshes());
+		return(data->keyFrames[lowerFrame].getMeshes());
+
+	numFrameRequests++;
 
-	const Model &a = keyFrames[lowerFrame].getMeshes();
-	const Model &b = keyFrames[upperFrame].getMeshes();
+	bool cached = false;
+	Model &meshes = data->acquireFrameBuffer(milliseconds, cached);
 
-	for(size_t i=0; i<meshes.size(); ++i)
-		meshes[i]->interpolate(bias, a[i], b[i]);
+	if(cached)
+	{
+		numFrameCacheHits++;
+	}
+	else
+	{
+		interpolate(meshes, lowerFrame, upperFrame, bias);
+	}
 
 	return(meshes);
 }
 
+void AnimationSequence::interpolate(Model &meshes, size_t lowerFrame, size_t upperFrame, float bias) const
+{
+	ASSERT(bias >= 0.0f && bias <= 1.0f, "bias is out of range: " + ftoa(bias));
+
+	const Model &a = data->keyFrames[lowerFrame].getMeshes();
+	const Model &b = data->keyFrames[upperFrame].getMeshes();
+
+	if(data->sameTopology)
+	{
+		for(size_t i=0; i<meshes.size(); ++i)
+			meshes[i]->interpolate(bias, a[i], b[i]);
+	}
+	else
+	{
+		for(size_t i=0; i<meshes.size(); ++i)
+			meshes[i]->interpolateFaces(bias, a[i], b[i]);
+	}
+}
+
 }; // namespace
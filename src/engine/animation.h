@@ -31,19 +31,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _ANIMATION_H_
 #define _ANIMATION_H_
 
+#include <boost/shared_ptr.hpp>
+
 #include "mat4.h"
 #include "mesh.h"
 #include "keyframe.h"
 
 namespace Engine {
 
-/** Records keyframe timing and arrangement for ana animation */
+/**
+Records keyframe timing and arrangement for ana animation.
+The keyframes and the rest of the loaded animation are immutable and are
+shared by every copy of the sequence, so that copying a sequence (as when
+a model is instantiated from the model cache) only copies the playback
+state: the time into the animation and its speed.
+*/
 class AnimationSequence
 {
 public:
-	/** Destructor */
-	~AnimationSequence(void);
-
 	/**
 	Loads the AnimationSequence from an XML source
 	@param keyFrames All keyframes in the mesh
@@ -65,22 +70,16 @@ public:
 		float fps
 	);
 
-	/**
-	Copy constructor
-	@param animation The animation to copy
-	*/
-	AnimationSequence(const AnimationSequence &animation);
-
 	/** Gets the name of the animation */
 	const string& getName(void) const
 	{
-		return m_strName;
+		return data->name;
 	}
 
 	/** Gets the animation's priority */
 	float getPriority(void) const
 	{
-		return m_Priority;
+		return data->priority;
 	}
 
 	/** Gets the current time into the animation */
@@ -89,13 +88,20 @@ public:
 		return m_Time;
 	}
 
+	/**
+	Gets the time of the pose that is drawn at the current time.
+	The drawn pose only changes when this does.
+	@return time into the animation, rounded to the time step
+	*/
+	float getPoseTime(void) const;
+
 	/**
 	Gets the length of the animation in milliseconds
 	@return milliseconds
 	*/
 	float getLength(void) const
 	{
-		return keyFrames.size() * 1000.0f / fps;
+		return data->keyFrames.size() * 1000.0f / data->fps;
 	}
 
 	/**
@@ -105,7 +111,7 @@ public:
 	*/
 	bool isHighPriority(void) const
 	{
-		return(m_Priority>1.0f);
+		return(data->priority>1.0f);
 	}
 
 	/**
@@ -114,7 +120,7 @@ public:
 	*/
 	float getFPS(void) const
 	{
-		return fps;
+		return data->fps;
 	}
 
 	/** Gets the time scalar of the animation */
@@ -132,7 +138,7 @@ public:
 	/** Indicates whether or not the animation is looping */
 	bool isLooping(void) const
 	{
-		return m_bLooping;
+		return data->looping;
 	}
 
 	/**
@@ -141,11 +147,59 @@ public:
 	*/
 	size_t getNumKeyFrames(void) const
 	{
-		return keyFrames.size();
+		return data->keyFrames.size();
 	}
 
-	/** Draws the animation at the current time */
-	void draw(void);
+	/**
+	Gets the memory used by the data shared between all copies of the sequence
+	@return bytes used by the keyframes and the interpolation buffers
+	*/
+	size_t getSharedMemoryUsage(void) const;
+
+	/**
+	Recycles the interpolation buffers of all animations.
+	Frames returned by getFrame are valid until this is next called, so it
+	must be called once per frame, before anything is drawn.
+	*/
+	static void beginFrame(void);
+
+	/**
+	Sets the step that animation time is rounded to before a frame is
+	interpolated. Instances of a model that are drawn at times that round
+	to the same step share one interpolated frame for the whole frame.
+	@param milliseconds Time step, or zero to share only identical times
+	*/
+	static void setTimeStep(float milliseconds)
+	{
+		timeStep = max(0.0f, milliseconds);
+	}
+
+	/** Gets the step that animation time is rounded to (milliseconds) */
+	static float getTimeStep(void)
+	{
+		return timeStep;
+	}
+
+	/**
+	Gets the number of interpolated frames requested so far
+	@return frame requests since the program started
+	*/
+	static size_t getNumFrameRequests(void)
+	{
+		return numFrameRequests;
+	}
+
+	/**
+	Gets the number of frame requests that were served from the frame cache
+	@return cache hits since the program started
+	*/
+	static size_t getNumFrameCacheHits(void)
+	{
+		return numFrameCacheHits;
+	}
+
+	/** Draws the animation at the current time, sharing the frame with other instances */
+	void draw(void) const;
 
 	/**
 	Updates the animation
@@ -195,13 +249,85 @@ public:
 	*/
 	void calculateFOV(mat4 &mat, float &lxMax, float &lyMax) const;
 
-private:
 	/**
-	Copy the meshes to create a working set.
-	We assume all keyframes have the same number of meshes and each corresponding mesh is identical except in vertex placement
-	@param model keyframes meshes
+	Gets the frame of animation for the current time.
+	The frame remains valid until the end of the frame (see beginFrame) so
+	that it may be queued for drawing.
+	@return The frame of animation
 	*/
-	void createWorkingSetOfMeshes(const Model &model);
+	const Model& getFrame(void) const
+	{
+		return getFrame(getTime());
+	}
+
+private:
+	/** Loaded animation data, shared by all copies of the sequence */
+	class SharedData
+	{
+	public:
+		/** Constructor */
+		SharedData(void);
+
+		/** Destructor */
+		~SharedData(void);
+
+		/** The key frames of the animation */
+		vector<KeyFrame> keyFrames;
+
+		/** The name of the animation */
+		string name;
+
+		/** Used for determing the animation of choice during animation selection */
+		float priority;
+
+		/** Whether or not the animation loops at the end of the sequence. */
+		bool looping;
+
+		/** base animation FPS */
+		float fps;
+
+		/** true if every keyframe orders its vertices and faces the same way */
+		bool sameTopology;
+
+		/**
+		Gets the interpolation buffer for a time into the animation.
+		The buffer stays valid until the end of the frame and is shared by
+		all requests for the same time during the frame.
+		@param time Time into the animation (milliseconds)
+		@param cached Returns true if the buffer already holds the frame
+		@return Meshes to interpolate into
+		*/
+		Model& acquireFrameBuffer(float time, bool &cached) const;
+
+		/**
+		Gets the memory used by the keyframes and the interpolation buffers
+		@return bytes
+		*/
+		size_t getMemoryUsage(void) const;
+
+		/** Incremented at the start of each frame */
+		static unsigned int currentFrame;
+
+	private:
+		/**
+		Copy the meshes of the first keyframe to create a working set.
+		We assume all keyframes have the same number of meshes and each corresponding mesh is identical except in vertex placement
+		@param model Receives the working set
+		*/
+		void createWorkingSetOfMeshes(Model &model) const;
+
+		/** Interpolation buffers handed out for use within one frame */
+		mutable vector<Model> frameBuffers;
+
+		/** Number of frameBuffers handed out during bufferFrame */
+		mutable size_t numFrameBuffersUsed;
+
+		/** Time into the animation -> index of the frame buffer holding it */
+		mutable map<float, size_t> frameBuffersByTime;
+
+		/** Frame in which the frameBuffers were handed out */
+		mutable unsigned int bufferFrame;
+	};
 
 	/**
 	Gets the frame of animation for the specified time
@@ -211,34 +337,41 @@ private:
 	const Model& getFrame(float millisecondsIntoAnimation) const;
 
 	/**
-	Gets the frame of animation by interploating between the given keyframes
-	@param lowerFrame Index of the lower keyframe
-	@param upperFrame Index of the upper keyframe
-	@param bias 0.0 to 1.0 indicating the bias between the keyframes
-	@return The frame of animation
+	Rounds a time into the animation to the time step
+	@param milliseconds The time into the animation
+	@return rounded time
 	*/
-	const Model& getFrame(size_t lowerFrame, size_t upperFrame, float bias) const;
+	static float quantizeTime(float milliseconds);
 
 	/**
-	Gets the frame of animation for the current time
-	@return The frame of animation
+	Finds the keyframes on either side of a time into the animation
+	@param millisecondsIntoAnimation The time into the animation
+	@param lowerFrame Returns the index of the lower keyframe
+	@param upperFrame Returns the index of the upper keyframe
+	@param bias Returns 0.0 to 1.0 indicating the bias between the keyframes
 	*/
-	const Model& getFrame(void) const
-	{
-		return getFrame(getTime());
-	}
+	void findKeyFrames(float millisecondsIntoAnimation, size_t &lowerFrame, size_t &upperFrame, float &bias) const;
 
-	/** A working copy of the mesh */
-	mutable vector<Mesh*> meshes;
+	/**
+	Interpolates between the given keyframes
+	@param meshes Receives the frame of animation
+	@param lowerFrame Index of the lower keyframe
+	@param upperFrame Index of the upper keyframe
+	@param bias 0.0 to 1.0 indicating the bias between the keyframes
+	*/
+	void interpolate(Model &meshes, size_t lowerFrame, size_t upperFrame, float bias) const;
+
+	/** Step that animation time is rounded to (milliseconds) */
+	static float timeStep;
 
-	/** The key frames of the animation */
-	vector<KeyFrame> keyFrames;
+	/** Interpolated frames requested from all animations */
+	static size_t numFrameRequests;
 
-	/** The name of the animation */
-	string m_strName;
+	/** Frame requests served from the frame cache */
+	static size_t numFrameCacheHits;
 
-	/** Used for determing the animation of choice during animation selection */
-	float m_Priority;
+	/** Loaded animation data */
+	boost::shared_ptr<SharedData> data;
 
 	/** Time into the animation (milliseconds) */
 	float m_Time;
@@ -246,12 +379,6 @@ private:
 	/** Multiply all Time Elapsed values by this to control animation speed */
 	float m_TimeScalar;
 
-	/** Whether or not the animation loops at the end of the sequence. */
-	bool m_bLooping;
-
-	/** base animation FPS */
-	float fps;
-
 	/**
 	Flags whether the animaton has been completed
 	If m_bLooping, then this is always false
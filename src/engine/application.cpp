@@ -233,9 +233,15 @@ void Application::run(void)
 		fme->Update();
 		float frameLength = (float)min(fme->getLength(), (unsigned int)70);
 
+		// frames of animation interpolated last frame may now be reused
+		AnimationSequence::beginFrame();
+
 		// Update the current game state
 		state->update(frameLength);
 
+		// execute delayed callbacks that have come due
+		scheduler.update(frameLength);
+
 		// update all tasks
 		for(std::list<Task*>::const_iterator i=tasks.begin();
             i!=tasks.end(); ++i)
@@ -286,6 +292,7 @@ void Application::stop(void)
     for(list<Task*>::iterator iter = tasks.begin(); iter != tasks.end(); ++iter)
         delete(*iter);
     tasks.clear();
+    scheduler.clear();
     TRACE("Deleted tasks");
 
     delete soundSystem;
@@ -332,6 +339,7 @@ void Application::clear(void)
 	world = 0;
 
 	tasks.clear();
+	scheduler.clear();
 }
 
 void Application::startDevIL()
@@ -435,6 +443,10 @@ void Application::saveXmlConfigFiles(void)
 	PerfBag.add("useBlurEffects", useBlurEffects);
 	PerfBag.add("textureFilter", textureFilter);
 	PerfBag.add("aniostropy", aniostropy);
+	PerfBag.add("animationTimeStep", AnimationSequence::getTimeStep());
+	PerfBag.add("shadowUpdatesPerFrame", (int)ShadowManager::getMaxUpdatesPerFrame());
+	PerfBag.add("shadowUpdateBudget", ShadowManager::getUpdateTimeBudget());
+	PerfBag.add("screenShotBurstInterval", ScreenShotTask::getBurstInterval());
 
 	BaseBag.add("performance", PerfBag);
 
@@ -481,6 +493,28 @@ void Application::loadXmlConfigFiles(void)
 	PerfBag.get("textureFilter", textureFilter);
 	PerfBag.get("aniostropy", aniostropy);
 
+	{
+		float animationTimeStep = AnimationSequence::getTimeStep();
+		PerfBag.get_optional("animationTimeStep", animationTimeStep);
+		AnimationSequence::setTimeStep(animationTimeStep);
+	}
+
+	{
+		int shadowUpdatesPerFrame = (int)ShadowManager::getMaxUpdatesPerFrame();
+		PerfBag.get_optional("shadowUpdatesPerFrame", shadowUpdatesPerFrame);
+		ShadowManager::setMaxUpdatesPerFrame((size_t)max(shadowUpdatesPerFrame, 0));
+
+		float shadowUpdateBudget = ShadowManager::getUpdateTimeBudget();
+		PerfBag.get_optional("shadowUpdateBudget", shadowUpdateBudget);
+		ShadowManager::setUpdateTimeBudget(shadowUpdateBudget);
+	}
+
+	{
+		int screenShotBurstInterval = ScreenShotTask::getBurstInterval();
+		PerfBag.get_optional("screenShotBurstInterval", screenShotBurstInterval);
+		ScreenShotTask::setBurstInterval(screenShotBurstInterval);
+	}
+
 	if(!supportsAniostropy && textureFilter==2)
 		textureFilter = 1;
 
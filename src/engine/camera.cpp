@@ -33,6 +33,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
+#include "opengl.h"
 
 #include "camera.h"
 
@@ -61,7 +63,7 @@ void Camera::setCamera(void)
 	orientation.setPos(vec3(0,0,0));
 
 	// Load the matrix for the camera
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glLoadMatrixf(getTransformation());
 
 	if(moved)
@@ -101,12 +103,7 @@ void Camera::fromXml(PropertyBag &xml)
 
 void Camera::lookAt(const vec3 &eye, const vec3 &center, const vec3 &up)
 {
-	glMatrixMode(GL_MODELVIEW);
-	glPushMatrix();
-	glLoadIdentity();
-	gluLookAt(eye.x, eye.y, eye.z, center.x, center.y, center.z, up.x, up.y, up.z);
-	glGetFloatv(GL_MODELVIEW_MATRIX, orientation);
-	glPopMatrix();
+	orientation.lookAt(eye, center, up);
 
 	// record the position of the camera
 	position = eye;
@@ -198,7 +195,7 @@ void Camera::updateFlyingCamera(float deltaTime)
 	setPosition(position);
 }
 
-Frustum Camera::getFrustum(void) const
+const Frustum& Camera::getFrustum(void) const
 {
 	return frustum;
 }
@@ -208,9 +205,7 @@ Frustum Camera::calculateFrustum(void)
 	Frustum f;
 
 	const mat4 &modl = getTransformation();
-
-	mat4 proj;
-	glGetFloatv(GL_PROJECTION_MATRIX, proj);
+	const mat4 &proj = OpenGL::GetSingleton().GetProjectionMatrix();
 
 	f.CalculateFrustum(modl, proj);
 
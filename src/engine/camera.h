@@ -190,7 +190,7 @@ public:
 	Gets the camera frustum
 	return camera frustum
 	*/
-	Frustum getFrustum(void) const;
+	const Frustum& getFrustum(void) const;
 };
 
 } // namespace Engine
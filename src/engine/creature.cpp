@@ -28,8 +28,9 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "stdafx.h" // Master Header
-#include "CallbackTask.h"
+#include <boost/bind.hpp>
 #include "gl.h"
+#include "StateCache.h"
 #include "widgetmanager.h"
 #include "ListPaneWidget.h"
 #include "ListElementTweaker.h"
@@ -63,7 +64,7 @@ void Creature::resurrect(void)
 
 	healthPoints = maxHealthPoints;
 
-	ChangeAnimation(getIdleAnim());
+	ChangeAnimation(getRoleAnimation(ANIM_IDLE));
 
 	// Start a resurrection particle effect
 	getZone().SpawnPfx("data/particle/summon.xml", getPos());
@@ -139,7 +140,7 @@ void Creature::damage(int amount, OBJECT_ID attackerID)
 	}
 	else
 	{
-		ChangeAnimation("flinch");
+		ChangeAnimation(getRoleAnimation(ANIM_PAIN));
 		g_SoundSystem.play(getHurtSfx());
 	}
 }
@@ -180,6 +181,8 @@ void Creature::clear(void)
 
 	// Reset data for this Creature
 	state = NORMAL;
+	animationModel = 0;
+	fill(animationHandles, animationHandles + NUM_ANIMATION_ROLES, 0);
 	m_strName			= "invalid name";
 	timeUntilOrderCancelled		= 0.0f;
 	m_pFSM				= 0;
@@ -280,7 +283,7 @@ void Creature::update(float deltaTime)
 		// Process the queued commands sent by the FSM
 		ProcessCommand();
 
-		ChangeAnimation(getWalkAnim(velocity.getMagnitude()));
+		ChangeAnimation(getRoleAnimation(getWalkRole(velocity.getMagnitude())));
 
 		break;
 
@@ -305,11 +308,11 @@ void Creature::update(float deltaTime)
 		}
 
 		starAngle = starAngle > 359 ? 0 : starAngle + deltaTime*starSpeed;
-		ChangeAnimation("stun");
+		ChangeAnimation(getRoleAnimation(ANIM_STUN));
 		break;
 
 	case FROZEN:
-		ChangeAnimation("stun");
+		ChangeAnimation(getRoleAnimation(ANIM_STUN));
 
 		stateTimer -= deltaTime;
 
@@ -332,7 +335,7 @@ void Creature::update(float deltaTime)
 		break;
 
 	case DEAD:
-		ChangeAnimation("dead");
+		ChangeAnimation(getRoleAnimation(ANIM_DEAD));
 
 		stateTimer -= deltaTime;
 
@@ -402,6 +405,9 @@ void Creature::load(const PropertyBag &Bag)
 {
 	Actor::load(Bag);
 
+	// Creatures may occupy the regions of Triggers
+	getZone().getRegions().addOccupant(m_ID, instanceof(*this, Player) ? REGION_OCCUPANT_PLAYER : REGION_OCCUPANT_CREATURE);
+
 	Bag.get_optional("healthPoints", healthPoints);
 	Bag.get_optional("maxHealthPoints", maxHealthPoints);
 	Bag.get_optional("attackDamage", attackDamage);
@@ -551,7 +557,7 @@ void Creature::startAttackAction(OBJECT_ID id)
 		int damageValue = (int)floorf(attackDamage * chargeMultiplier * weaponMultiplier);
 
 		// calculate the length of the attack animation
-		size_t animHandle = getAnimationHandle(getAttackAnim());
+		size_t animHandle = getRoleAnimation(ANIM_ATTACK);
 		float delay = getAnimationLength(animHandle);
 		ChangeAnimation(animHandle);
 
@@ -559,9 +565,7 @@ void Creature::startAttackAction(OBJECT_ID id)
 		attackCoolDownTimer = max(attackCoolDown * attackCoolDownMultiplier, delay); // reset
 
 		// inflict damage once the animation is underway
-		boost::function<void (void)> fn = boost::bind(&Creature::dealAttackDamage, this, damageValue, o.m_ID);
-		Task *task = makeCallbackTask(delay*0.33f, fn);
-		g_Application.addTask(task);
+		g_Scheduler.schedule(delay*0.33f, boost::bind(&Creature::dealAttackDamage, this, damageValue, o.m_ID), m_ID);
 
 		// Misc
 		timeSinceLastAttack = 0;
@@ -692,7 +696,7 @@ void Creature::kill(void)
 	g_SoundSystem.play(getDyingSfx());
 
 	// calculate the length of the dying animation
-	size_t animHandle = getAnimationHandle(getDyingAnim());
+	size_t animHandle = getRoleAnimation(ANIM_DYING);
 	float delay = getAnimationLength(animHandle);
 	ChangeAnimation(animHandle);
 
@@ -771,16 +775,36 @@ const string Creature::getRunRightRevAnim(void) const
 	return "runrightback";
 }
 
-const string Creature::getWalkAnim(float speed) const
+Creature::ANIMATION_ROLE Creature::getWalkRole(float speed) const
 {
 	if(speed < minWalkingVelocity)
 	{
-		return getIdleAnim();
+		return ANIM_IDLE;
 	}
 	else
 	{
-		return "run";
+		return ANIM_RUN;
+	}
+}
+
+void Creature::cacheAnimationHandles(void)
+{
+	animationModel = m_pModel;
+
+	if(m_pModel == 0)
+	{
+		fill(animationHandles, animationHandles + NUM_ANIMATION_ROLES, 0);
+		return;
 	}
+
+	animationHandles[ANIM_IDLE]   = m_pModel->getAnimationHandle(getIdleAnim());
+	animationHandles[ANIM_WALK]   = m_pModel->getAnimationHandle("walk");
+	animationHandles[ANIM_RUN]    = m_pModel->getAnimationHandle("run");
+	animationHandles[ANIM_ATTACK] = m_pModel->getAnimationHandle(getAttackAnim());
+	animationHandles[ANIM_PAIN]   = m_pModel->getAnimationHandle("flinch");
+	animationHandles[ANIM_DYING]  = m_pModel->getAnimationHandle(getDyingAnim());
+	animationHandles[ANIM_STUN]   = m_pModel->getAnimationHandle("stun");
+	animationHandles[ANIM_DEAD]   = m_pModel->getAnimationHandle("dead");
 }
 
 const string Creature::getDyingSfx(void) const
@@ -838,66 +862,41 @@ void Creature::gotoNextOrder(void)
 	}
 }
 
-void Creature::drawTransparentObject(void) const
+void Creature::submit(RenderQueue &queue) const
 {
-	if(state != GHOST || m_pModel==0)
+	if(m_pModel==0)
 	{
 		return;
 	}
 
-	CHECK_GL_ERROR();
-
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-		glDisable(GL_LIGHTING);
-		glEnable(GL_BLEND);
-		glColor4f(1.0f, 1.0f, 1.0f, 0.3f);
-
-		glPushMatrix();
-		glMultMatrixf(toWorldSpace());
-		m_pModel->draw();
-		glPopMatrix();
-
-	glPopAttrib();
-
-	CHECK_GL_ERROR();
-}
-
-void Creature::drawObject(void) const
-{
-	if(state == GHOST || m_pModel==0)
+	if(state == GHOST)
 	{
+		submitMeshes(queue, RenderQueue::TRANSPARENT_BUCKET, COLOR(1.0f, 1.0f, 1.0f, 0.3f), false);
 		return;
 	}
 
-	CHECK_GL_ERROR();
-
 	if(state==FROZEN)
 	{
-		glColor4f(98/255.f, 176/255.f, 1.0f, 1.0f); // coliander
-		Actor::drawObject();
-		glColor4fv(white);
+		submitModel(queue, COLOR(98/255.f, 176/255.f, 1.0f, 1.0f)); // coliander
 	}
 	else
 	{
-		Actor::drawObject();
+		submitModel(queue, white);
 	}
 
 	if(isAlive())
 	{
 		if(g_Application.displayDebugData)
 		{
-			drawHealthBar();
-			drawChargeBar();
+			queue.addCustom(RenderQueue::OPAQUE_BUCKET, getPos(), boost::bind(&Creature::drawHealthBar, this));
+			queue.addCustom(RenderQueue::OPAQUE_BUCKET, getPos(), boost::bind(&Creature::drawChargeBar, this));
 		}
 
 		if(state==STUNNED && stateTimer>500.0f)
 		{
-			drawStarsAboveHead(m_desiredHeight + 0.02f);
+			queue.addCustom(RenderQueue::TRANSPARENT_BUCKET, getPos(), boost::bind(&Creature::drawStarsAboveHead, this, m_desiredHeight + 0.02f));
 		}
 	}
-
-	CHECK_GL_ERROR();
 }
 
 void Creature::drawObjectDebugData(void) const
@@ -982,19 +981,19 @@ void Creature::drawStarsAboveHead(float y) const
 
 	float starsRadius = getCylinderRadius() > 1.0f ? 1.0f : getCylinderRadius();
 
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
 		glColor4fv(white);
 
-		glDisable(GL_LIGHTING);
-		glDisable(GL_COLOR_MATERIAL);
-		glDisable(GL_CULL_FACE);
+		g_StateCache.disable(GL_LIGHTING);
+		g_StateCache.disable(GL_COLOR_MATERIAL);
+		g_StateCache.disable(GL_CULL_FACE);
 
 		// Transparency
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-		glEnable(GL_BLEND);
+		g_StateCache.blendFunc(GL_SRC_ALPHA, GL_ONE);
+		g_StateCache.enable(GL_BLEND);
 
-		glEnable(GL_TEXTURE_2D);
+		g_StateCache.enable(GL_TEXTURE_2D);
 		starMaterial.bind();
 
 		glPushMatrix();
@@ -1026,7 +1025,7 @@ void Creature::drawStarsAboveHead(float y) const
 		}
 
 		glPopMatrix();
-	glPopAttrib();
+	g_StateCache.pop();
 }
 
 void Creature::drawFloatingBar(float y, float p, COLOR CA, COLOR CB) const
@@ -1036,12 +1035,12 @@ void Creature::drawFloatingBar(float y, float p, COLOR CA, COLOR CB) const
 	const float WIDTH = 1.0f;
 	const float HEIGHT = 0.05f;
 
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
-		glDisable(GL_LIGHTING);
-		glDisable(GL_COLOR_MATERIAL);
-		glDisable(GL_TEXTURE_2D);
-		glDisable(GL_CULL_FACE);
+		g_StateCache.disable(GL_LIGHTING);
+		g_StateCache.disable(GL_COLOR_MATERIAL);
+		g_StateCache.disable(GL_TEXTURE_2D);
+		g_StateCache.disable(GL_CULL_FACE);
 
 		glPushMatrix();
 		glTranslatef(center.x, center.y, center.z);
@@ -1066,7 +1065,9 @@ void Creature::drawFloatingBar(float y, float p, COLOR CA, COLOR CB) const
 			glEnd();
 
 		glPopMatrix();
-	glPopAttrib();
+
+		glColor4fv(white);
+	g_StateCache.pop();
 }
 
 } // namespace Engine
@@ -60,6 +60,20 @@ public:
 		SORT_DIST_DESCENDING
 	};
 
+	/** Roles that the animations of the Creature play */
+	enum ANIMATION_ROLE
+	{
+		ANIM_IDLE,
+		ANIM_WALK,
+		ANIM_RUN,
+		ANIM_ATTACK,
+		ANIM_PAIN,
+		ANIM_DYING,
+		ANIM_STUN,
+		ANIM_DEAD,
+		NUM_ANIMATION_ROLES
+	};
+
 	/**
 	Constructs a blank Creature
 	@param ID The unique identifying number for the Creature
@@ -99,11 +113,11 @@ public:
 	/** Kills the creature at the next tick */
 	virtual void kill(void);
 
-	/** Transforms and renders the creature */
-	virtual void drawObject(void) const;
-
-	/** Transforms and renders the transparent parts of the creature */
-	virtual void drawTransparentObject(void) const;
+	/**
+	Queues the creature to be rendered. Ghosts are transparent.
+	@param queue The render queue
+	*/
+	virtual void submit(RenderQueue &queue) const;
 
 	/** Used by drawObject to render Debug data */
 	virtual void drawObjectDebugData(void) const;
@@ -280,11 +294,27 @@ public:
 	virtual const string getRunRightRevAnim(void) const;
 
 	/**
-	Gets the name of the proper walking animation
+	Gets the role of the proper walking animation
 	@param speed meters per second speed of the creature
-	@return animation name
+	@return animation role
 	*/
-	virtual const string getWalkAnim(float speed) const;
+	virtual ANIMATION_ROLE getWalkRole(float speed) const;
+
+	/**
+	Gets the handle of the animation that plays a role.
+	Names are resolved only when the model or the animation names change.
+	@param role The role
+	@return animation handle
+	*/
+	inline size_t getRoleAnimation(ANIMATION_ROLE role)
+	{
+		if(animationModel != m_pModel)
+		{
+			cacheAnimationHandles();
+		}
+
+		return animationHandles[role];
+	}
 
 	/**
 	Get the name of the sound effect file to play when the creature is dying
@@ -450,6 +480,15 @@ private:
 	Message_s lastMessage;
 
 protected:
+	/**
+	Creatures are driven by their state machines and never sleep
+	@return false
+	*/
+	virtual bool canSleep(void) const
+	{
+		return false;
+	}
+
 	/**
 	Draws stars floating above the creature's head
 	@param y Height above the ground beneath the player
@@ -545,6 +584,19 @@ protected:
 
 	/** timer specific to the current Essential State of the creature (milliseconds) */
 	float stateTimer;
+
+	/**
+	Resolves the animation names of each role into handles.
+	Must be called again when the names returned by the get*Anim functions change.
+	*/
+	void cacheAnimationHandles(void);
+
+private:
+	/** Handle of the animation for each role */
+	size_t animationHandles[NUM_ANIMATION_ROLES];
+
+	/** The model that the animation handles were resolved against */
+	const AnimationController *animationModel;
 };
 
 } //namespace Engine
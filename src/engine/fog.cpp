@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "fog.h"
 
 
@@ -101,14 +102,14 @@ void Fog::activate(void) const
 		glHint(GL_FOG_HINT, GL_NICEST);
 
 		// and switch on fog
-		glEnable(GL_FOG);
+		g_StateCache.enable(GL_FOG);
 
 	}
 }
 
 void Fog::deactivate(void) const
 {
-	glDisable(GL_FOG);
+	g_StateCache.disable(GL_FOG);
 }
 
 
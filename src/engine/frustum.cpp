@@ -19,6 +19,8 @@ E-Mail: mailto:foxostro@gmail.com
 
 #include "stdafx.h"  // Master Header
 #include "gl.h"
+#include "StateCache.h"
+#include "simd.h"
 #include "frustum.h" // Frustum - This file implements the class
 
 
@@ -36,7 +38,7 @@ void clipPlane(const Frustum *frustum, GLenum clipPlane, FrustumSide side)
 	plane[3] = planeEq.w;
 	glClipPlane(clipPlane, plane);
 
-	glEnable(clipPlane);
+	g_StateCache.enable(clipPlane);
 }
 
 vec3 planeIntersection3(const vec4 &plane1, const vec4 &plane2, const vec4 &plane3)
@@ -63,6 +65,41 @@ enum PlaneData
 	D = 3				// The distance the plane is from the origin
 };
 
+#ifdef ENGINE_USE_SSE
+/**
+Finds the first plane that rejected an object in a group of four
+@param rejected For each plane, the movemask of the objects behind it
+@param lane Index of the object within the group
+@param none Value to return if no plane rejected the object
+@return index of the plane, or none
+*/
+static unsigned char firstRejectingPlane(const int rejected[6], int lane, unsigned char none)
+{
+	for(int side = 0; side < 6; ++side)
+	{
+		if(rejected[side] & (1 << lane))
+			return (unsigned char)side;
+	}
+
+	return none;
+}
+
+/**
+Gathers one coefficient of the cached planes of four objects
+@param frustum The frustum planes
+@param cached Index of the cached plane for each of the four objects
+@param coefficient Which coefficient of the planes to gather
+@return the coefficients
+*/
+static __m128 gatherPlanes(const float frustum[6][4], const unsigned char *cached, int coefficient)
+{
+	return _mm_setr_ps(frustum[cached[0]][coefficient],
+	                   frustum[cached[1]][coefficient],
+	                   frustum[cached[2]][coefficient],
+	                   frustum[cached[3]][coefficient]);
+}
+#endif
+
 ///////////////////////////////// NORMALIZE PLANE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*
 /////
 /////	This normalizes a plane (A side) from a given frustum.
@@ -181,17 +218,6 @@ void Frustum::CalculateFrustum(const mat4 &modl, const mat4 &proj)
 	NormalizePlane(m_Frustum, FRONT);
 }
 
-void Frustum::CalculateFrustum()
-{
-	mat4 proj;
-	mat4 modl;
-
-	glGetFloatv(GL_PROJECTION_MATRIX, proj);
-	glGetFloatv(GL_MODELVIEW_MATRIX, modl);
-
-	CalculateFrustum(modl, proj);
-}
-
 // The code below will allow us to make checks within the frustum.  For example,
 // if we want to see if a point, a sphere, or a cube lies inside of the frustum.
 // Because all of our planes point INWARDS (The normals are all pointing inside the frustum)
@@ -286,6 +312,254 @@ bool Frustum::CubeInFrustum( float x, float y, float z, float size ) const
 	return true;
 }
 
+void Frustum::cull(SphereBatch &batch) const
+{
+	const size_t count = batch.size();
+
+	if(count == 0)
+		return;
+
+	const float *x = &batch.x[0];
+	const float *y = &batch.y[0];
+	const float *z = &batch.z[0];
+	const float *radius = &batch.radius[0];
+	unsigned char *visible = &batch.visible[0];
+	unsigned char *lastPlane = &batch.lastPlane[0];
+
+	size_t i = 0;
+
+#ifdef ENGINE_USE_SSE
+	/*
+	Test four spheres at a time against all six planes without branching.
+	When all four were rejected last time, their cached planes are tried
+	first and the group is done if they reject all four again.  Otherwise
+	the first plane to reject each sphere is recovered from the masks and
+	written back to the cache.
+	*/
+	__m128 planes[6][4];
+
+	for(int side = 0; side < 6; ++side)
+	{
+		for(int j = 0; j < 4; ++j)
+		{
+			planes[side][j] = _mm_set1_ps(m_Frustum[side][j]);
+		}
+	}
+
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128 cx = _mm_loadu_ps(x + i);
+		const __m128 cy = _mm_loadu_ps(y + i);
+		const __m128 cz = _mm_loadu_ps(z + i);
+		const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+		if(lastPlane[i+0] != SphereBatch::NO_PLANE && lastPlane[i+1] != SphereBatch::NO_PLANE &&
+		   lastPlane[i+2] != SphereBatch::NO_PLANE && lastPlane[i+3] != SphereBatch::NO_PLANE)
+		{
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(gatherPlanes(m_Frustum, lastPlane + i, A), cx),
+			                                                         _mm_mul_ps(gatherPlanes(m_Frustum, lastPlane + i, B), cy)),
+			                                              _mm_mul_ps(gatherPlanes(m_Frustum, lastPlane + i, C), cz)),
+			                                   gatherPlanes(m_Frustum, lastPlane + i, D));
+
+			if(_mm_movemask_ps(_mm_cmple_ps(distance, negRadius)) == 15)
+			{
+				visible[i+0] = visible[i+1] = visible[i+2] = visible[i+3] = 0;
+				continue;
+			}
+		}
+
+		int rejected[6];
+
+		for(int side = 0; side < 6; ++side)
+		{
+			const __m128 *p = planes[side];
+
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[A], cx),
+			                                                         _mm_mul_ps(p[B], cy)),
+			                                              _mm_mul_ps(p[C], cz)),
+			                                   p[D]);
+
+			rejected[side] = _mm_movemask_ps(_mm_cmple_ps(distance, negRadius));
+		}
+
+		for(int lane = 0; lane < 4; ++lane)
+		{
+			lastPlane[i+lane] = firstRejectingPlane(rejected, lane, SphereBatch::NO_PLANE);
+			visible[i+lane] = (lastPlane[i+lane] == SphereBatch::NO_PLANE) ? 1 : 0;
+		}
+	}
+#endif
+
+	// Scalar loop for the remainder, or for everything without SSE
+	for(; i < count; ++i)
+	{
+		const int cached = lastPlane[i];
+
+		// Most spheres that were rejected last time are rejected by the same plane
+		if(cached != SphereBatch::NO_PLANE)
+		{
+			const float *p = m_Frustum[cached];
+
+			if(p[A]*x[i] + p[B]*y[i] + p[C]*z[i] + p[D] <= -radius[i])
+			{
+				visible[i] = 0;
+				continue;
+			}
+		}
+
+		int rejectedBy = SphereBatch::NO_PLANE;
+
+		for(int side = 0; side < 6; ++side)
+		{
+			const float *p = m_Frustum[side];
+
+			if(p[A]*x[i] + p[B]*y[i] + p[C]*z[i] + p[D] <= -radius[i])
+			{
+				rejectedBy = side;
+				break;
+			}
+		}
+
+		lastPlane[i] = (unsigned char)rejectedBy;
+		visible[i] = (rejectedBy == SphereBatch::NO_PLANE) ? 1 : 0;
+	}
+}
+
+void Frustum::cull(BoxBatch &batch) const
+{
+	const size_t count = batch.size();
+
+	if(count == 0)
+		return;
+
+	const float *minX = &batch.minX[0], *minY = &batch.minY[0], *minZ = &batch.minZ[0];
+	const float *maxX = &batch.maxX[0], *maxY = &batch.maxY[0], *maxZ = &batch.maxZ[0];
+	unsigned char *visible = &batch.visible[0];
+	unsigned char *lastPlane = &batch.lastPlane[0];
+
+	// For each plane, pick the corner of a box that lies furthest along the
+	// plane normal. The box is outside if even that corner is behind the plane.
+	bool useMaxX[6], useMaxY[6], useMaxZ[6];
+
+	for(int side = 0; side < 6; ++side)
+	{
+		useMaxX[side] = m_Frustum[side][A] >= 0.0f;
+		useMaxY[side] = m_Frustum[side][B] >= 0.0f;
+		useMaxZ[side] = m_Frustum[side][C] >= 0.0f;
+	}
+
+	size_t i = 0;
+
+#ifdef ENGINE_USE_SSE
+	/*
+	Test four boxes at a time against all six planes without branching.
+	The p-vertex term on each axis is the larger of the plane coefficient
+	times the box's min and max, which picks the same corner as useMax.
+	As with spheres, the cached planes are tried first when all four boxes
+	were rejected last time, and the cache is refreshed from the masks.
+	*/
+	__m128 planes[6][4];
+
+	for(int side = 0; side < 6; ++side)
+	{
+		for(int j = 0; j < 4; ++j)
+		{
+			planes[side][j] = _mm_set1_ps(m_Frustum[side][j]);
+		}
+	}
+
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128 lowX = _mm_loadu_ps(minX + i), highX = _mm_loadu_ps(maxX + i);
+		const __m128 lowY = _mm_loadu_ps(minY + i), highY = _mm_loadu_ps(maxY + i);
+		const __m128 lowZ = _mm_loadu_ps(minZ + i), highZ = _mm_loadu_ps(maxZ + i);
+
+		if(lastPlane[i+0] != BoxBatch::NO_PLANE && lastPlane[i+1] != BoxBatch::NO_PLANE &&
+		   lastPlane[i+2] != BoxBatch::NO_PLANE && lastPlane[i+3] != BoxBatch::NO_PLANE)
+		{
+			const __m128 a = gatherPlanes(m_Frustum, lastPlane + i, A);
+			const __m128 b = gatherPlanes(m_Frustum, lastPlane + i, B);
+			const __m128 c = gatherPlanes(m_Frustum, lastPlane + i, C);
+
+			const __m128 dx = _mm_max_ps(_mm_mul_ps(a, lowX), _mm_mul_ps(a, highX));
+			const __m128 dy = _mm_max_ps(_mm_mul_ps(b, lowY), _mm_mul_ps(b, highY));
+			const __m128 dz = _mm_max_ps(_mm_mul_ps(c, lowZ), _mm_mul_ps(c, highZ));
+
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(dx, dy), dz),
+			                                   gatherPlanes(m_Frustum, lastPlane + i, D));
+
+			if(_mm_movemask_ps(_mm_cmplt_ps(distance, _mm_setzero_ps())) == 15)
+			{
+				visible[i+0] = visible[i+1] = visible[i+2] = visible[i+3] = 0;
+				continue;
+			}
+		}
+
+		int rejected[6];
+
+		for(int side = 0; side < 6; ++side)
+		{
+			const __m128 *p = planes[side];
+
+			const __m128 dx = _mm_max_ps(_mm_mul_ps(p[A], lowX), _mm_mul_ps(p[A], highX));
+			const __m128 dy = _mm_max_ps(_mm_mul_ps(p[B], lowY), _mm_mul_ps(p[B], highY));
+			const __m128 dz = _mm_max_ps(_mm_mul_ps(p[C], lowZ), _mm_mul_ps(p[C], highZ));
+
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(dx, dy), dz), p[D]);
+
+			rejected[side] = _mm_movemask_ps(_mm_cmplt_ps(distance, _mm_setzero_ps()));
+		}
+
+		for(int lane = 0; lane < 4; ++lane)
+		{
+			lastPlane[i+lane] = firstRejectingPlane(rejected, lane, BoxBatch::NO_PLANE);
+			visible[i+lane] = (lastPlane[i+lane] == BoxBatch::NO_PLANE) ? 1 : 0;
+		}
+	}
+#endif
+
+	// Scalar loop for the remainder, or for everything without SSE
+	for(; i < count; ++i)
+	{
+		const int cached = lastPlane[i];
+
+		if(cached != BoxBatch::NO_PLANE)
+		{
+			const float *p = m_Frustum[cached];
+
+			const float px = useMaxX[cached] ? maxX[i] : minX[i];
+			const float py = useMaxY[cached] ? maxY[i] : minY[i];
+			const float pz = useMaxZ[cached] ? maxZ[i] : minZ[i];
+
+			if(p[A]*px + p[B]*py + p[C]*pz + p[D] < 0.0f)
+			{
+				visible[i] = 0;
+				continue;
+			}
+		}
+
+		int rejectedBy = BoxBatch::NO_PLANE;
+
+		for(int side = 0; side < 6; ++side)
+		{
+			const float *p = m_Frustum[side];
+
+			const float px = useMaxX[side] ? maxX[i] : minX[i];
+			const float py = useMaxY[side] ? maxY[i] : minY[i];
+			const float pz = useMaxZ[side] ? maxZ[i] : minZ[i];
+
+			if(p[A]*px + p[B]*py + p[C]*pz + p[D] < 0.0f)
+			{
+				rejectedBy = side;
+				break;
+			}
+		}
+
+		lastPlane[i] = (unsigned char)rejectedBy;
+		visible[i] = (rejectedBy == BoxBatch::NO_PLANE) ? 1 : 0;
+	}
+}
+
 void Frustum::beginClipping(void) const
 {
 	clipPlane(this, GL_CLIP_PLANE0, FRONT);
@@ -13,6 +13,7 @@ Co-Web Host of www.GameTutorials.com
 
 #include "vec4.h"
 #include "mat4.h"
+#include "CullingBatch.h"
 
 namespace Engine {
 
@@ -34,9 +35,6 @@ enum FrustumSide
 class Frustum
 {
 public:
-	// Calculates the frustum from the modelview/projection frustum currently set
-	void CalculateFrustum(void);
-
 	// Calculates the frustum from the given matrices
 	void CalculateFrustum(const mat4 &modl, const mat4 &proj);
 
@@ -49,6 +47,22 @@ public:
 	// This takes a 3D point and a sphere diameter and returns TRUE if the sphere is inside of the frustum
 	bool SphereInFrustum(float x, float y, float z, float diameter) const;
 
+	/**
+	Tests a batch of spheres against the frustum, in the same way as
+	SphereInFrustum2. The results are left in the batch.
+	With SSE, four spheres are tested against each plane at once.
+	@param batch The spheres
+	*/
+	void cull(SphereBatch &batch) const;
+
+	/**
+	Tests a batch of axis-aligned boxes against the frustum.
+	The results are left in the batch.
+	With SSE, four boxes are tested against each plane at once.
+	@param batch The boxes
+	*/
+	void cull(BoxBatch &batch) const;
+
 	// This takes a 3D point and a sphere diameter and returns TRUE if the sphere is inside of the frustum
 	inline bool SphereInFrustum2(const vec4 &sphereCenter, float diameter) const
 	{
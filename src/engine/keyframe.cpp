@@ -37,22 +37,64 @@ namespace Engine {
 KeyFrame::KeyFrame(Mesh* mesh)
 {
 	meshes.push_back(mesh);
+	calculateBounds();
 }
 
 KeyFrame::KeyFrame(vector<Mesh*> Meshes)
 : meshes(Meshes)
-{}
+{
+	calculateBounds();
+}
 
 KeyFrame::KeyFrame(const KeyFrame &keyframe)
-: meshes(keyframe.meshes)
+: meshes(keyframe.meshes),
+  minCorner(keyframe.minCorner),
+  maxCorner(keyframe.maxCorner),
+  radius(keyframe.radius),
+  cylindricalRadius(keyframe.cylindricalRadius)
 {}
 
 KeyFrame& KeyFrame::operator=(const KeyFrame &keyframe)
 {
 	meshes = keyframe.meshes;
+	minCorner = keyframe.minCorner;
+	maxCorner = keyframe.maxCorner;
+	radius = keyframe.radius;
+	cylindricalRadius = keyframe.cylindricalRadius;
 	return(*this);
 }
 
+void KeyFrame::calculateBounds(void)
+{
+	minCorner = maxCorner = vec3(0,0,0);
+	radius = cylindricalRadius = 0.0f;
+
+	for(Model::const_iterator i=meshes.begin(); i!=meshes.end(); ++i)
+	{
+		Mesh *mesh = *i;
+
+		const BoundingBox box = mesh->calculateBoundingBox();
+
+		// Seed from the first mesh so that a model away from the origin does not include it
+		if(i == meshes.begin())
+		{
+			minCorner = box.m_Min;
+			maxCorner = box.m_Max;
+		}
+
+		minCorner.x = min(minCorner.x, box.m_Min.x);
+		minCorner.y = min(minCorner.y, box.m_Min.y);
+		minCorner.z = min(minCorner.z, box.m_Min.z);
+
+		maxCorner.x = max(maxCorner.x, box.m_Max.x);
+		maxCorner.y = max(maxCorner.y, box.m_Max.y);
+		maxCorner.z = max(maxCorner.z, box.m_Max.z);
+
+		radius = max(radius, mesh->calculateRadius());
+		cylindricalRadius = max(cylindricalRadius, mesh->calculateCylindricalRadius());
+	}
+}
+
 bool KeyFrame::merge(const KeyFrame &o)
 {
 	if(getMeshes().size() == 0)
@@ -70,6 +112,8 @@ bool KeyFrame::merge(const KeyFrame &o)
 		}
 	}
 
+	calculateBounds();
+
 	return true;
 }
 
@@ -47,6 +47,21 @@ private:
 	/** Reference to the meshes involved in the keyframe */
 	Model meshes;
 
+	/** Minimum corner of the box enclosing every mesh (and the origin) */
+	vec3 minCorner;
+
+	/** Maximum corner of the box enclosing every mesh (and the origin) */
+	vec3 maxCorner;
+
+	/** Largest of the meshes' radii about their own center points */
+	float radius;
+
+	/** Largest distance of any vertex from the vertical axis */
+	float cylindricalRadius;
+
+	/** Calculates the bounds of the meshes */
+	void calculateBounds(void);
+
 public:
 	/**
 	Constructs the keyframe from a single mesh
@@ -109,6 +124,30 @@ public:
 	@return true if the merge was successful
 	*/
 	bool merge(const KeyFrame &o);
+
+	/** Gets the minimum corner of the box enclosing the keyframe */
+	const vec3& getMinCorner(void) const
+	{
+		return minCorner;
+	}
+
+	/** Gets the maximum corner of the box enclosing the keyframe */
+	const vec3& getMaxCorner(void) const
+	{
+		return maxCorner;
+	}
+
+	/** Gets the radius of the sphere enclosing the keyframe */
+	float getRadius(void) const
+	{
+		return radius;
+	}
+
+	/** Gets the radius of the cylinder enclosing the keyframe */
+	float getCylindricalRadius(void) const
+	{
+		return cylindricalRadius;
+	}
 };
 
 } //namespace Engine
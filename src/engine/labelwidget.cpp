@@ -41,7 +41,8 @@ LabelWidget::LabelWidget
 				const vec2 &pos
 			)
 : fontSize(FONT_SIZE_NORMAL),
-  font(0)
+  font(0),
+  geometryValid(false)
 {
 	setFont(g_Application.fontLarge);
 	setFontSize(FONT_SIZE_NORMAL);
@@ -59,7 +60,8 @@ LabelWidget::LabelWidget
 				TextWriter &font
 			)
 : fontSize(FONT_SIZE_NORMAL),
-  font(0)
+  font(0),
+  geometryValid(false)
 {
 	setFont(font);
 	setFontSize(FontSize);
@@ -72,7 +74,12 @@ void LabelWidget::setLabel(const string& labelTxt)
 {
 	ASSERT(font != 0, "font was null!  Call setFont method first!");
 
+	// Labels updated every frame usually have the same text as before
+	if(geometryValid && labelText == labelTxt)
+		return;
+
 	labelText = labelTxt;
+	geometryValid = false;
 
 	vec2 dim = font->getDimensions(labelText, fontSize);
 	setWidth(dim.x);
@@ -87,11 +94,13 @@ void LabelWidget::setColor(const COLOR &color)
 void LabelWidget::setFont(TextWriter &font)
 {
 	this->font = &font;
+	geometryValid = false;
 }
 
 void LabelWidget::setFontSize(FONT_SIZE fontSize)
 {
 	this->fontSize = fontSize;
+	geometryValid = false;
 }
 
 void LabelWidget::draw(void) const
@@ -100,7 +109,13 @@ void LabelWidget::draw(void) const
 
 	if(isVisible())
 	{
-		font->write(labelText, m_Color, fontSize);
+		if(!geometryValid)
+		{
+			font->build(geometry, labelText, fontSize);
+			geometryValid = true;
+		}
+
+		font->draw(geometry, m_Color);
 	}
 }
 
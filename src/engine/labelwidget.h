@@ -103,6 +103,12 @@ private:
 
 	/** The current font */
 	TextWriter *font;
+
+	/** Geometry of the label text, built when first drawn */
+	mutable TextGeometry geometry;
+
+	/** Whether the geometry matches the label text, font, and size */
+	mutable bool geometryValid;
 };
 
 } // namespace Engine
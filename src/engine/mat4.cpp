@@ -29,7 +29,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h"
-#include "gl.h"
 #include "mat4.h"
 
 
@@ -54,31 +53,121 @@ vec4 mat4::transformVector(const vec4 &v) const
 	return temp;
 }
 
+bool mat4::invert(void)
+{
+	float inv[16];
+
+	inv[0]  =  m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+	inv[4]  = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+	inv[8]  =  m[4]*m[9]*m[15]  - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+	inv[12] = -m[4]*m[9]*m[14]  + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+	inv[1]  = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+	inv[5]  =  m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+	inv[9]  = -m[0]*m[9]*m[15]  + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+	inv[13] =  m[0]*m[9]*m[14]  - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+	inv[2]  =  m[1]*m[6]*m[15]  - m[1]*m[7]*m[14]  - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7]  - m[13]*m[3]*m[6];
+	inv[6]  = -m[0]*m[6]*m[15]  + m[0]*m[7]*m[14]  + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7]  + m[12]*m[3]*m[6];
+	inv[10] =  m[0]*m[5]*m[15]  - m[0]*m[7]*m[13]  - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7]  - m[12]*m[3]*m[5];
+	inv[14] = -m[0]*m[5]*m[14]  + m[0]*m[6]*m[13]  + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6]  + m[12]*m[2]*m[5];
+	inv[3]  = -m[1]*m[6]*m[11]  + m[1]*m[7]*m[10]  + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7]   + m[9]*m[3]*m[6];
+	inv[7]  =  m[0]*m[6]*m[11]  - m[0]*m[7]*m[10]  - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7]   - m[8]*m[3]*m[6];
+	inv[11] = -m[0]*m[5]*m[11]  + m[0]*m[7]*m[9]   + m[4]*m[1]*m[11] - m[4]*m[3]*m[9]  - m[8]*m[1]*m[7]   + m[8]*m[3]*m[5];
+	inv[15] =  m[0]*m[5]*m[10]  - m[0]*m[6]*m[9]   - m[4]*m[1]*m[10] + m[4]*m[2]*m[9]  + m[8]*m[1]*m[6]   - m[8]*m[2]*m[5];
+
+	const float det = m[0]*inv[0] + m[1]*inv[4] + m[2]*inv[8] + m[3]*inv[12];
+
+	if(fabsf(det) < FLT_EPSILON)
+		return false;
+
+	const float invDet = 1.0f / det;
+
+	for(int ct=0; ct<16; ct++)
+	{
+		m[ct] = inv[ct] * invDet;
+	}
+
+	return true;
+}
+
 void mat4::rotate(float radians, const vec3 &axis)
 {
 	identity();
 
-	float degrees = radians * 180.0f / (float)M_PI;
+	const float length = sqrtf(axis.x*axis.x + axis.y*axis.y + axis.z*axis.z);
+
+	if(length < FLT_EPSILON)
+		return;
+
+	const float x = axis.x / length;
+	const float y = axis.y / length;
+	const float z = axis.z / length;
+
+	const float c = cosf(radians);
+	const float s = sinf(radians);
+	const float t = 1.0f - c;
 
-	glMatrixMode(GL_MODELVIEW);
-	glPushMatrix();
-	glLoadIdentity();
-	glRotatef(degrees, axis.x, axis.y, axis.z);
-	glGetFloatv(GL_MODELVIEW_MATRIX, m);
-	glPopMatrix();
+	m[0]  = x*x*t + c;
+	m[1]  = y*x*t + z*s;
+	m[2]  = x*z*t - y*s;
+
+	m[4]  = x*y*t - z*s;
+	m[5]  = y*y*t + c;
+	m[6]  = y*z*t + x*s;
+
+	m[8]  = x*z*t + y*s;
+	m[9]  = y*z*t - x*s;
+	m[10] = z*z*t + c;
 }
 
 void mat4::lookAt(const vec3 &eye, const vec3 &center, const vec3 &up)
 {
-	vec3 z = vec3(eye-center).getNormal();
-	vec3 y = up;
-	vec3 x = up.cross(z);
+	// Only the xyz components participate; w may be anything here
+	const vec3 f = vec3(center.x-eye.x, center.y-eye.y, center.z-eye.z).getNormal();
+	const vec3 s = f.cross(up).getNormal();
+	const vec3 u = s.cross(f);
+
+	identity();
+
+	// The rows of the rotation are the camera's side, up, and back vectors
+	m[0] = s.x;		m[4] = s.y;		m[8]  = s.z;
+	m[1] = u.x;		m[5] = u.y;		m[9]  = u.z;
+	m[2] = -f.x;	m[6] = -f.y;	m[10] = -f.z;
+
+	// Bake in the translation of the eye point to the origin
+	m[12] = -(s.x*eye.x + s.y*eye.y + s.z*eye.z);
+	m[13] = -(u.x*eye.x + u.y*eye.y + u.z*eye.z);
+	m[14] =   f.x*eye.x + f.y*eye.y + f.z*eye.z;
+}
+
+void mat4::perspective(float fovy, float aspect, float zNear, float zFar)
+{
+	ASSERT(aspect != 0.0f, "mat4::perspective  ->  aspect ratio is zero");
+	ASSERT(zNear != zFar, "mat4::perspective  ->  near and far planes coincide");
+
+	const float radians = fovy * 0.5f * (float)M_PI / 180.0f;
+	const float f = cosf(radians) / sinf(radians);
+
+	zero();
+
+	m[0]  = f / aspect;
+	m[5]  = f;
+	m[10] = (zFar + zNear) / (zNear - zFar);
+	m[11] = -1.0f;
+	m[14] = 2.0f * zFar * zNear / (zNear - zFar);
+}
+
+void mat4::ortho(float left, float right, float bottom, float top, float zNear, float zFar)
+{
+	ASSERT(left != right && bottom != top && zNear != zFar, "mat4::ortho  ->  degenerate view volume");
 
 	identity();
-	setAxisX(x);
-	setAxisY(y);
-	setAxisZ(z);
-	setPos(eye);
+
+	m[0]  = 2.0f / (right - left);
+	m[5]  = 2.0f / (top - bottom);
+	m[10] = -2.0f / (zFar - zNear);
+	m[12] = -(right + left) / (right - left);
+	m[13] = -(top + bottom) / (top - bottom);
+	m[14] = -(zFar + zNear) / (zFar - zNear);
 }
 
 
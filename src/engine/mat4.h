@@ -462,57 +462,24 @@ public:
 	}
 
 	/**
-	Invert the matrix
+	Invert the matrix.
+	The inverse is computed from the cofactors of the matrix, so this
+	works for any non-singular matrix, including projection matrices.
+	If the matrix is singular then it is left unchanged.
+	@return true if the matrix was inverted
 	*/
-	void invert(void)
-	{
-		float *data = m;
-		const int actualsize = 4;
-		const int maxsize = 4;
+	bool invert(void);
 
-		for (int i=1; i < actualsize; i++) data[i] /= data[0]; // normalize row 0
-		for (int i=1; i < actualsize; i++)  {
-		for (int j=i; j < actualsize; j++)  { // do a column of L
-			float sum = 0.0;
-			for (int k = 0; k < i; k++)
-				sum += data[j*maxsize+k] * data[k*maxsize+i];
-			data[j*maxsize+i] -= sum;
-			}
-		if (i == actualsize-1) continue;
-		for (int j=i+1; j < actualsize; j++)  {  // do a row of U
-			float sum = 0.0;
-			for (int k = 0; k < i; k++)
-				sum += data[i*maxsize+k]*data[k*maxsize+j];
-			data[i*maxsize+j] =
-			(data[i*maxsize+j]-sum) / data[i*maxsize+i];
-			}
-		}
-		for ( int i = 0; i < actualsize; i++ )  // invert L
-		for ( int j = i; j < actualsize; j++ )  {
-			float x = 1.0;
-			if ( i != j ) {
-			x = 0.0;
-			for ( int k = i; k < j; k++ )
-				x -= data[j*maxsize+k]*data[k*maxsize+i];
-			}
-			data[j*maxsize+i] = x / data[j*maxsize+j];
-			}
-		for ( int i = 0; i < actualsize; i++ )   // invert U
-		for ( int j = i; j < actualsize; j++ )  {
-			if ( i == j ) continue;
-			float sum = 0.0;
-			for ( int k = i; k < j; k++ )
-				sum += data[k*maxsize+j]*( (i==k) ? 1.0f : data[i*maxsize+k] );
-			data[i*maxsize+j] = -sum;
-			}
-		for ( int i = 0; i < actualsize; i++ )   // final inversion
-		for ( int j = 0; j < actualsize; j++ )  {
-			float sum = 0.0;
-			for ( int k = ((i>j)?i:j); k < actualsize; k++ )
-				sum += ((j==k)?1.0f:data[j*maxsize+k])*data[k*maxsize+i];
-			data[j*maxsize+i] = sum;
-			}
-    }
+	/**
+	Gets the inverse of the matrix
+	@return inverse matrix (or a copy of this matrix if it is singular)
+	*/
+	mat4 getInverse(void) const
+	{
+		mat4 inverse(*this);
+		inverse.invert();
+		return inverse;
+	}
 
 	/**
 	Rotate the transformation matrix about the X-Axis
@@ -610,8 +577,8 @@ public:
 	/**
 	Rotate the transformation matrix about an arbitrary axis.
 	@param angle Angle to rotate the matrix by around the axis
+	Produces the same matrix as glRotatef, but the angle is in radians.
 	@param axis The axis of rotation
-	@todo Implemented using OpenGL matrix functions. (Quite the hack.)
 	*/
 	void rotate(float angle, const vec3 &axis);
 
@@ -624,7 +591,7 @@ public:
 	the direction described by the up vector projected onto the viewing plane
 	is mapped to the positive y-axis so that it points upward in the viewport.
 	The up vector must not be parallel to the line of sight from the eye to
-	the reference point.
+	the reference point.  Produces the same matrix as gluLookAt.
 
 	@param eye		The position of the eye point.
 	@param center	The position of the reference point.
@@ -632,6 +599,28 @@ public:
 	*/
 	void lookAt(const vec3 &eye, const vec3 &center, const vec3 &up);
 
+	/**
+	Sets up a perspective projection matrix.
+	Produces the same matrix as gluPerspective.
+	@param fovy		Field of view angle, in degrees, in the y direction
+	@param aspect	Aspect ratio (width / height) of the viewport
+	@param zNear	Distance to the near clipping plane (must be positive)
+	@param zFar		Distance to the far clipping plane (must be positive)
+	*/
+	void perspective(float fovy, float aspect, float zNear, float zFar);
+
+	/**
+	Sets up an orthographic projection matrix.
+	Produces the same matrix as glOrtho.
+	@param left		Coordinate of the left clipping plane
+	@param right	Coordinate of the right clipping plane
+	@param bottom	Coordinate of the bottom clipping plane
+	@param top		Coordinate of the top clipping plane
+	@param zNear	Distance to the near clipping plane
+	@param zFar		Distance to the far clipping plane
+	*/
+	void ortho(float left, float right, float bottom, float top, float zNear, float zFar);
+
 	/**
 	Translates the transformation matrix.
 	@param x Amount to translate on the X-Axis
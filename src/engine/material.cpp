@@ -123,6 +123,16 @@ void Material::setTexture(TextureHandle *handle, unsigned int textureUnit)
 	textures[textureUnit] = handle;
 }
 
+bool Material::isEquivalent(const Material &mat) const
+{
+	return this == &mat ||
+	       (memcmp(textures, mat.textures, sizeof(textures))==0 &&
+	        ambient == mat.ambient &&
+	        diffuse == mat.diffuse &&
+	        specular == mat.specular &&
+	        shininess == mat.shininess);
+}
+
 void Material::bind(void) const
 {
 	CHECK_GL_ERROR();
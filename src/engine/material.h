@@ -138,6 +138,23 @@ public:
 		return effect;
 	}
 
+	/**
+	Gets the texture assigned to a texture unit
+	@param textureUnit The texture unit
+	@return The texture handle, or null if the unit is unused
+	*/
+	TextureHandle* getTexture(unsigned int textureUnit) const
+	{
+		return textures[textureUnit];
+	}
+
+	/**
+	Determines whether binding another material would set exactly the same state as this one
+	@param mat The other material
+	@return true if the materials are interchangeable
+	*/
+	bool isEquivalent(const Material &mat) const;
+
 	/**	Passes Material information to the currently bound Effect. */
 	void bind(void) const;
 
@@ -37,6 +37,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Effect.h"
 #include "EffectManager.h"
+#include "simd.h"
 
 #ifdef _WIN32
 #define strcpy strcpy_s // avoid deprecation warnings and keep portable syntax
@@ -131,14 +132,19 @@ void Mesh::draw(void) const
 	CHECK_GL_ERROR();
 
 	material.bind();
-	currentEffect.passVertexStream((float*)m_pVerts);
-	currentEffect.passNormalStream((float*)m_pNormals);
-	currentEffect.passTexCoordStream((float*)m_pTexVerts, 0);
-	glDrawElements(GL_TRIANGLES, m_numOfFaces*3, GL_UNSIGNED_INT, m_pElements);
+	drawGeometry(currentEffect);
 
 	FLUSH_GL_ERROR();
 }
 
+void Mesh::drawGeometry(Effect &effect) const
+{
+	effect.passVertexStream((float*)m_pVerts);
+	effect.passNormalStream((float*)m_pNormals);
+	effect.passTexCoordStream((float*)m_pTexVerts, 0);
+	glDrawElements(GL_TRIANGLES, m_numOfFaces*3, GL_UNSIGNED_INT, m_pElements);
+}
+
 void Mesh::reallocElements()
 {
 	// Destroy the old array
@@ -157,6 +163,19 @@ void Mesh::reallocElements()
 	}
 }
 
+size_t Mesh::getMemoryUsage(void) const
+{
+	size_t bytes = sizeof(Mesh);
+
+	if(m_pVerts)    bytes += sizeof(Point3) * m_numOfVerts;
+	if(m_pNormals)  bytes += sizeof(Point3) * m_numOfVerts;
+	if(m_pTexVerts) bytes += sizeof(Point2) * m_numOfVerts;
+	if(m_pFaces)    bytes += sizeof(Face) * m_numOfFaces;
+	if(m_pElements) bytes += sizeof(unsigned int) * m_numOfFaces * 3;
+
+	return bytes;
+}
+
 float Mesh::calculateCylindricalRadius()
 {
 	float furthest = 0.0f;
@@ -220,7 +239,38 @@ BoundingBox Mesh::calculateBoundingBox()
 	return box;
 }
 
-void Mesh::interpolate(float bias, Mesh *pA, Mesh *pB)
+/**
+Linear interpolation over packed floats, four at a time with SSE
+@param n Number of floats
+@param bias Interpolation bias between 0.0 and 1.0
+@param a The first array
+@param b The second array
+@param out Returns the interpolated array
+*/
+static void lerp(int n, float bias, const float *a, const float *b, float *out)
+{
+	int i = 0;
+
+#ifdef ENGINE_USE_SSE
+	const __m128 t = _mm_set1_ps(bias);
+
+	for(; i + 4 <= n; i += 4)
+	{
+		const __m128 a4 = _mm_loadu_ps(a + i);
+		const __m128 b4 = _mm_loadu_ps(b + i);
+
+		_mm_storeu_ps(out + i, _mm_add_ps(a4, _mm_mul_ps(t, _mm_sub_ps(b4, a4))));
+	}
+#endif
+
+	// Linear Interpolation  ...   p(t) = p0 + t(p1 - p0)
+	for(; i<n; ++i)
+	{
+		out[i] = a[i] + bias*(b[i] - a[i]);
+	}
+}
+
+void Mesh::interpolate(float bias, const Mesh *pA, const Mesh *pB)
 {
 	ASSERT(pA!=0, "Mesh::interpolate  ->  pA was null");
 	ASSERT(pB!=0, "Mesh::interpolate  ->  pB was null");
@@ -231,42 +281,61 @@ void Mesh::interpolate(float bias, Mesh *pA, Mesh *pB)
 	ASSERT(m_numOfFaces == pA->m_numOfFaces, "Mesh::interpolate  ->  Different number of faces from keyframe A");
 	ASSERT(m_numOfFaces == pB->m_numOfFaces, "Mesh::interpolate  ->  Different number of faces from keyframe B");
 
-	// Set some pointers up for the arrays to avoid dereferencing pA and pB a million times a frame
-	unsigned int *elA = pA->m_pElements;
-	unsigned int *elB = pB->m_pElements;
-	Point3 *vertsA = pA->m_pVerts;
-	Point3 *vertsB = pB->m_pVerts;
-	Point3 *normsA = pA->m_pNormals;
-	Point3 *normsB = pB->m_pNormals;
+	/*
+	Vertices correspond by index, so each one is interpolated exactly once
+	and the element array is left alone. Points and normals are both
+	packed floats, so this is a plain loop over contiguous arrays.
+	The normals are not renormalized here, since GL_NORMALIZE is enabled
+	for all drawing (see OpenGL's constructor).
+	*/
+	const int n = m_numOfVerts * 3;
+
+	lerp(n, bias, (const float*)pA->m_pVerts, (const float*)pB->m_pVerts, (float*)m_pVerts);
+	lerp(n, bias, (const float*)pA->m_pNormals, (const float*)pB->m_pNormals, (float*)m_pNormals);
+}
+
+void Mesh::interpolateFaces(float bias, const Mesh *pA, const Mesh *pB)
+{
+	ASSERT(pA!=0, "Mesh::interpolateFaces  ->  pA was null");
+	ASSERT(pB!=0, "Mesh::interpolateFaces  ->  pB was null");
+
+	ASSERT(m_numOfFaces == pA->m_numOfFaces, "Mesh::interpolateFaces  ->  Different number of faces from keyframe A");
+	ASSERT(m_numOfFaces == pB->m_numOfFaces, "Mesh::interpolateFaces  ->  Different number of faces from keyframe B");
+
+	const unsigned int *elA = pA->m_pElements;
+	const unsigned int *elB = pB->m_pElements;
 
-	// Linear Interpolation  ...   p(t) = p0 + t(p1 - p0)
 	for(int i=0; i<m_numOfFaces*3; ++i)
 	{
-		unsigned int a = elA[i];
-		unsigned int b = elB[i];
-
 		// Make sure conectivity is the same as one of the keyframes
-		m_pElements[i] = a;
-		unsigned int x = m_pElements[i];
+		const unsigned int x = m_pElements[i] = elA[i];
 
-		Point3 &vertexA = vertsA[a];
-		Point3 &normalA = normsA[a];
+		const Point3 &vertexA = pA->m_pVerts[x];
+		const Point3 &normalA = pA->m_pNormals[x];
+		const Point3 &vertexB = pB->m_pVerts[elB[i]];
+		const Point3 &normalB = pB->m_pNormals[elB[i]];
 
-		Point3 &vertexB = vertsB[b];
-		Point3 &normalB = normsB[b];
-
-		// Interpolate Vertices
 		m_pVerts[x].x = vertexA.x + bias*(vertexB.x - vertexA.x);
 		m_pVerts[x].y = vertexA.y + bias*(vertexB.y - vertexA.y);
 		m_pVerts[x].z = vertexA.z + bias*(vertexB.z - vertexA.z);
 
-		// Interpolate Normals
 		m_pNormals[x].x = normalA.x + bias*(normalB.x - normalA.x);
 		m_pNormals[x].y = normalA.y + bias*(normalB.y - normalA.y);
 		m_pNormals[x].z = normalA.z + bias*(normalB.z - normalA.z);
 	}
 }
 
+bool Mesh::hasSameTopology(const Mesh &mesh) const
+{
+	if(m_numOfVerts != mesh.m_numOfVerts || m_numOfFaces != mesh.m_numOfFaces)
+		return false;
+
+	if(m_pElements==0 || mesh.m_pElements==0)
+		return m_pElements == mesh.m_pElements;
+
+	return memcmp(m_pElements, mesh.m_pElements, sizeof(unsigned int) * m_numOfFaces * 3) == 0;
+}
+
 void Mesh::calculateFOV(mat4 &mat, float &lxMax, float &lyMax) const
 {
 	vec3 vert1, vert2;
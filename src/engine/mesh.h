@@ -40,6 +40,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Engine {
 
+class Effect;
+
 
 /** Holds mesh data and can render that data */
 class Mesh
@@ -123,6 +125,12 @@ public:
 	/** Draws the object */
 	void draw(void) const;
 
+	/**
+	Draws the object, assuming that its material is already bound
+	@param effect The current Effect
+	*/
+	void drawGeometry(Effect &effect) const;
+
 	/**
 	Calculates the radius of the smallest sphere that encloses the object.
 	@return radius
@@ -145,12 +153,36 @@ public:
 	void reallocElements(void);
 
 	/**
-	Creates an object interpolated from two other existing objects
+	Gets the memory used by the mesh's arrays
+	@return bytes
+	*/
+	size_t getMemoryUsage(void) const;
+
+	/**
+	Creates an object interpolated from two other existing objects.
+	The keyframes must share this object's topology (see hasSameTopology)
+	so that corresponding vertices sit at the same index in each one.
+	@param bias Interpolation bias between 0.0 and 1.0
+	@param a The first keyframe
+	@param b The second keyframe
+	*/
+	void interpolate(float bias, const Mesh *a, const Mesh *b);
+
+	/**
+	Creates an object interpolated from two keyframes whose vertices may be
+	ordered differently, pairing up vertices through the faces instead.
 	@param bias Interpolation bias between 0.0 and 1.0
 	@param a The first keyframe
 	@param b The second keyframe
 	*/
-	void interpolate(float bias, Mesh *a, Mesh *b);
+	void interpolateFaces(float bias, const Mesh *a, const Mesh *b);
+
+	/**
+	Determines whether two meshes have the same vertex count and faces
+	@param mesh The other mesh
+	@return true if the meshes index the same vertices for each face
+	*/
+	bool hasSameTopology(const Mesh &mesh) const;
 
 	/**
 	Calculates the FOV of the Mesh
@@ -98,12 +98,15 @@ AnimationController* createAnimationController(const string &fileName)
 
 GEN_ACTOR_RTTI_CPP(Actor, "class Engine::Actor")
 
+const float Actor::SLEEP_DELAY = 1000.0f;
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
 Actor::Actor(const OBJECT_ID ID)
-: m_ID(ID)
+: m_ID(ID),
+  spareModel(0)
 {
 	clear();
 }
@@ -111,6 +114,26 @@ Actor::Actor(const OBJECT_ID ID)
 Actor::~Actor(void)
 {
 	destroy();
+	delete spareModel;
+}
+
+void Actor::retire(void)
+{
+	// Hold on to the model so that the next load of the same model can reuse it
+	if(m_pModel != 0)
+	{
+		delete spareModel;
+		spareModel = m_pModel;
+		spareModelFilename = m_strModelFilename;
+	}
+
+	destroy();
+}
+
+void Actor::reuse(OBJECT_ID handle)
+{
+	m_ID = handle;
+	clear();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -133,6 +156,8 @@ void Actor::clear(void)
 	myEffect			= effect_TEXTURE_LIT; // default
 	floating			= false;
 	slidOnWall			= false;
+	asleep				= false;
+	idleTime			= 0.0f;
 	frictionAcceleration		= 32.0f;
 	minWalkingVelocity		= 0.5f;
 	m_pModel                        = 0;
@@ -145,6 +170,9 @@ void Actor::clear(void)
 	validatedPos.zero();
 	position.zero();
 	velocity.zero();
+
+	// A pooled actor must not keep pointers to the actors it last touched
+	m_Collisions.clear();
     
     editorDataFile.clear();
 }
@@ -190,7 +218,17 @@ void Actor::lookAt(const vec3 &center)
 
 void Actor::LoadModel(const string &fileName)
 {
-	m_pModel = createAnimationController(fileName);
+	if(spareModel != 0 && spareModelFilename == fileName)
+	{
+		// Reuse the model controller kept when the actor was pooled
+		m_pModel = spareModel;
+		m_pModel->rewind();
+		spareModel = 0;
+	}
+	else
+	{
+		m_pModel = createAnimationController(fileName);
+	}
 
 	// Error check
 	if(m_pModel == 0)
@@ -231,6 +269,7 @@ void Actor::Place(const vec3 &pos)
 	spawnPoint = validatedPos = position = pos;
 
 	RecordValidatedPos();
+	wake();
 
 	OnPlace();
 }
@@ -240,6 +279,7 @@ void Actor::OnPlace(void)
 
 void Actor::updateForEditor(float)
 {
+	wake();
 	sync();
 
 	// Set our elevation to that of the tile we are standing on
@@ -266,8 +306,7 @@ void Actor::update(float milliseconds)
 	// If there is a model for this object
 	if(m_pModel!=0)
 	{
-		m_pModel->update(milliseconds);
-		hasAnimated=true;
+		hasAnimated = m_pModel->update(milliseconds);
 	}
 
 	// Eliminate any vertical component of velocity
@@ -313,6 +352,43 @@ void Actor::update(float milliseconds)
 	}
 }
 
+bool Actor::canSleep(void) const
+{
+	if(velocity.getMagnitude() > FLT_EPSILON)
+		return false;
+
+	if(m_pModel!=0 && m_pModel->getNumAnimations()>0)
+	{
+		const AnimationSequence &animation = m_pModel->getAnimation();
+
+		if(animation.getNumKeyFrames()>1 && (animation.isLooping() || !animation.isFinished()))
+			return false;
+	}
+
+	return !g_Scheduler.hasPending(m_ID);
+}
+
+void Actor::updateActivity(float deltaTime)
+{
+	if(!canSleep())
+	{
+		idleTime = 0.0f;
+		return;
+	}
+
+	idleTime += deltaTime;
+
+	if(idleTime >= SLEEP_DELAY)
+	{
+		asleep = true;
+
+		// Nothing will change until the actor is woken again
+		hasMoved = false;
+		hasAnimated = false;
+		m_Collisions.clear();
+	}
+}
+
 void Actor::setHeight(float h)
 {
 	this->m_desiredHeight = h;
@@ -372,6 +448,10 @@ void Actor::DoCollisionResponse(void)
 	for(list<Actor*>::iterator iter=m_Collisions.begin(); iter!=m_Collisions.end(); ++iter)
 	{
 		Actor &a = **iter;
+
+		// Being pushed around wakes a sleeping actor
+		if(hasMoved) a.wake();
+
 		a.OnCollision(*this);
 		OnCollision(a);
 	}
@@ -507,48 +587,45 @@ list<Actor*> Actor::getCollisions(const ActorSet &s) const
 	return colliders;
 }
 
-void Actor::drawTransparentObject(void) const
-{}
+void Actor::submit(RenderQueue &queue) const
+{
+	submitModel(queue, white);
+}
 
-void Actor::drawObject(void) const
+void Actor::submitModel(RenderQueue &queue, const COLOR &color) const
 {
-	CHECK_GL_ERROR();
+	// At visual priorities less than 0.0, the object is not rendered at all
+	if(m_pModel==0 || !(showModel || g_Application.getState()==GAME_STATE_EDITOR || g_Application.displayDebugData))
+	{
+		return;
+	}
 
 	// Color the model while in editor mode
 	if(g_Application.getState()==GAME_STATE_EDITOR)
 	{
 		const EditorToolBar *e = GameStateEditor::GetSingleton().getEditorToolBar();
-		glColor4fv((e!=0 && e->getSelectedId() == m_ID) ? red : white);
+		submitMeshes(queue, RenderQueue::OPAQUE_BUCKET, (e!=0 && e->getSelectedId() == m_ID) ? red : white, true);
 	}
-	else if(!isLit)
+	else
 	{
-		glPushAttrib(GL_ENABLE_BIT);
-		glDisable(GL_LIGHTING);
+		submitMeshes(queue, RenderQueue::OPAQUE_BUCKET, color, isLit);
 	}
+}
 
-	// At visual priorities less than 0.0, the object is not rendered at all
-	if(
-		(m_pModel!=0)
-			&&
-		(
-			showModel
-				||
-			(g_Application.getState()==GAME_STATE_EDITOR || g_Application.displayDebugData)
-		)
-	  )
+void Actor::submitMeshes(RenderQueue &queue, RenderQueue::BUCKET bucket, const COLOR &color, bool lit) const
+{
+	if(m_pModel==0)
 	{
-		glPushMatrix();
-		glMultMatrixf(toWorldSpace());
-		m_pModel->draw();
-		glPopMatrix();
+		return;
 	}
 
-	if(g_Application.getState()!=GAME_STATE_EDITOR && !isLit)
+	const mat4 transform = toWorldSpace();
+	const Model &meshes = m_pModel->getAnimation().getFrame();
+
+	for(Model::const_iterator i=meshes.begin(); i!=meshes.end(); ++i)
 	{
-		glPopAttrib();
+		queue.add(bucket, **i, transform, color, lit);
 	}
-
-	CHECK_GL_ERROR();
 }
 
 void Actor::drawObjectToDepthBuffer(void) const
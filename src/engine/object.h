@@ -42,6 +42,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "EffectSig.h"
 #include "Message.h"
 #include "AnimationController.h"
+#include "RenderQueue.h"
 
 namespace Engine {
 
@@ -119,11 +120,11 @@ public:
 		return getDistance(&a, b);
 	}
 
-	/** Transforms and renders the object */
-	virtual void drawObject(void) const;
-
-	/** Transforms and renders the transparent parts of the object */
-	virtual void drawTransparentObject(void) const;
+	/**
+	Queues the object, and its transparent parts, to be rendered
+	@param queue The render queue
+	*/
+	virtual void submit(RenderQueue &queue) const;
 
 	/** Quickly render the object into the depth buffer */
 	virtual void drawObjectToDepthBuffer(void) const;
@@ -158,6 +159,42 @@ public:
 	*/
 	virtual void updateForEditor(float deltaTime);
 
+	/**
+	Puts the actor to sleep once it has been idle for SLEEP_DELAY.
+	Called after the actor has been updated.
+	@param deltaTime milliseconds since the last tick
+	*/
+	void updateActivity(float deltaTime);
+
+	/**
+	Called when the actor is released into its type's pool.
+	Destroys the actor but keeps its model controller for reuse.
+	*/
+	void retire(void);
+
+	/**
+	Called when a pooled actor is taken up again
+	@param handle The new unique ID of the actor
+	*/
+	void reuse(OBJECT_ID handle);
+
+	/** Wakes the actor so that it is updated from the next tick on */
+	inline void wake(void)
+	{
+		asleep = false;
+		idleTime = 0.0f;
+	}
+
+	/**
+	Sleeping actors are neither updated nor do they look for collisions of
+	their own, though awake actors still collide with them.
+	@return true if the actor is asleep
+	*/
+	inline bool isAsleep(void) const
+	{
+		return asleep;
+	}
+
 	/**
 	Perform collision detection
 	@param s the set of actors to test for collision against
@@ -513,6 +550,31 @@ protected:
 	/** Records all collisions in the previous tick */
 	list<Actor*> m_Collisions;
 
+	/**
+	Queues the model as an opaque object, following the editor highlight,
+	lighting, and visibility settings of the actor
+	@param queue The render queue
+	@param color Color to draw the model with outside of the editor
+	*/
+	void submitModel(RenderQueue &queue, const COLOR &color) const;
+
+	/**
+	Queues the meshes of the current frame of the model
+	@param queue The render queue
+	@param bucket Opaque or transparent bucket
+	@param color Color to draw the model with
+	@param lit false if the model is to be drawn without lighting
+	*/
+	void submitMeshes(RenderQueue &queue, RenderQueue::BUCKET bucket, const COLOR &color, bool lit) const;
+
+	/**
+	Determines whether the actor is idle and could be put to sleep.
+	By default, this is the case when it has no velocity, no animation
+	to advance, and no pending scheduled callbacks.
+	@return true if the actor is idle
+	*/
+	virtual bool canSleep(void) const;
+
 	/**
 	Determines if the actor can cross into the tile from its current position
 	@param m The map
@@ -624,7 +686,7 @@ public:
 	/** The actor has moved within the last tick */
 	bool hasMoved;
 
-	/** The actor has animated within the last tick */
+	/** The actor's pose has changed within the last tick */
 	bool hasAnimated;
 
 protected:
@@ -698,6 +760,21 @@ private:
 	/** Indicates that we slid on a wall in the previous tick */
 	bool slidOnWall;
 
+	/** The actor is asleep and is not being updated */
+	bool asleep;
+
+	/** Milliseconds that the actor has been idle while awake */
+	float idleTime;
+
+	/** Milliseconds an actor must be idle before it is put to sleep */
+	static const float SLEEP_DELAY;
+
+	/** Model controller kept from before the actor was pooled, or NULL */
+	AnimationController *spareModel;
+
+	/** File name of the spare model controller */
+	string spareModelFilename;
+
 	/**
 	Extract the angle about the Y-Axis from the orientation matrix
 	@return radians about the Y-Axis
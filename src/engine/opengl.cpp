@@ -35,6 +35,7 @@ E-Mail: mailto:tcauchoi@andrew.cmu.edu
 #include "stdafx.h" // Master Header
 #include "gl.h"
 #include "opengl.h"
+#include "StateCache.h"
 #include "COLOR.h"
 
 
@@ -56,6 +57,9 @@ bool g_bUseFramebufferObjects = false;
 /** Indicates support for GL_ARB_depth_texture */
 bool g_bUseDepthTexture = false;
 
+/** Indicates support for GL_ARB_vertex_buffer_object */
+bool g_bUseVertexBufferObjects = false;
+
 /** Indicates support for shadows */
 bool supportsShadow = false;
 
@@ -84,10 +88,18 @@ OpenGL :: OpenGL(int width, int height)
 
 OpenGL :: ~OpenGL()
 {
+	StateCache::Destroy();
 }
 
 bool OpenGL :: InitGL()
 {
+	// Set up all hardware supported extensions
+	SetupExtensions();
+
+	// Every state shadowed by the cache is unknown in a new context
+	StateCache::Create();
+	g_StateCache.invalidate();
+
 	// Black background
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
@@ -96,8 +108,8 @@ bool OpenGL :: InitGL()
 
 	// Setup the depth buffer
 	glClearDepth(1.0f);
-	glDepthFunc(GL_LEQUAL);
-	glEnable(GL_DEPTH_TEST);
+	g_StateCache.depthFunc(GL_LEQUAL);
+	g_StateCache.enable(GL_DEPTH_TEST);
 
 	// Polygon color should be mixed with texture color
 	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
@@ -107,22 +119,19 @@ bool OpenGL :: InitGL()
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
 	// Backface Culling
-	glEnable(GL_CULL_FACE);
+	g_StateCache.enable(GL_CULL_FACE);
 	glFrontFace(GL_CCW);
-	glCullFace(GL_BACK);
+	g_StateCache.cullFace(GL_BACK);
 
 	// Set up a default colored material
-	glEnable(GL_COLOR_MATERIAL);
+	g_StateCache.enable(GL_COLOR_MATERIAL);
 	glShadeModel(GL_SMOOTH);
 
 	// calculation hints for lighting
-	glEnable(GL_NORMALIZE);
+	g_StateCache.enable(GL_NORMALIZE);
 	glLightModeli(GL_LIGHT_MODEL_LOCAL_VIEWER, GL_TRUE);
 	glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL, GL_SEPARATE_SPECULAR_COLOR);
 
-	// Set up all hardware supported extensions
-	SetupExtensions();
-
 	return true;
 }
 
@@ -139,12 +148,12 @@ GLvoid OpenGL :: ReSizeGLScene(int width, int height)
 	glViewport(0, 0, width, height);
 
 	// Reset projection matrix
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	gluPerspective(45, m_AspectRatio, 0.01f, 5000.0f);
+	m_Projection.perspective(45.0f, m_AspectRatio, 0.01f, 5000.0f);
+	g_StateCache.matrixMode(GL_PROJECTION);
+	glLoadMatrixf(m_Projection);
 
 	// Reset moelview matrix
-	glMatrixMode(GL_MODELVIEW);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 }
 
@@ -156,10 +165,10 @@ void OpenGL::SetClippingPlanes(float Near, float Far)
 	m_NearClip = Near;
 	m_FarClip  = Far;
 
-	glMatrixMode(GL_PROJECTION);     // Select The Projection mat4
-	glLoadIdentity();                // Reset The Projection mat4
-	gluPerspective(45.0f, m_AspectRatio, m_NearClip, m_FarClip);
-	glMatrixMode(GL_MODELVIEW);
+	m_Projection.perspective(45.0f, m_AspectRatio, m_NearClip, m_FarClip);
+	g_StateCache.matrixMode(GL_PROJECTION);     // Select The Projection mat4
+	glLoadMatrixf(m_Projection);
+	g_StateCache.matrixMode(GL_MODELVIEW);
 }
 
 bool OpenGL::CheckExtension(const char *str)
@@ -200,6 +209,8 @@ void OpenGL::SetupExtensions(void)
 
 	g_bUseDepthTexture = glewIsExtensionSupported("GL_ARB_depth_texture")==GL_TRUE;
 
+	g_bUseVertexBufferObjects = glewIsExtensionSupported("GL_ARB_vertex_buffer_object")==GL_TRUE;
+
 	supportsShadow = g_bUseMultitexture && g_bUseDepthTexture && glewIsExtensionSupported("GL_ARB_shadow")==GL_TRUE;
 
 	supportsAniostropy = glewIsExtensionSupported("GL_EXT_texture_filter_anisotropic")==GL_TRUE;
@@ -37,6 +37,7 @@ E-Mail: mailto:tcauchoi@andrew.cmu.edu
 #define OPENGL_H
 
 #include "gl.h"
+#include "mat4.h"
 #include "timer.h"		// Timing functions
 #include "singleton.h"	// OpenGL will be a Singleton (we will never have more than one :)
 
@@ -51,6 +52,7 @@ public:
 	float		m_NearClip;       // Near clipping plane
 	float		m_FarClip;        // Far clipping plane
 	float		m_AspectRatio;    // Aspect ratio of the viewport
+	mat4		m_Projection;     // Projection matrix last loaded into GL
 	int			stencil;		  // stencil buffer bits
 
 	// Helper functions
@@ -66,6 +68,7 @@ public:
 	int	GetStencil() const { return stencil; }
 	float GetNearClip() const { return m_NearClip; }
 	float GetFarClip() const { return m_FarClip; }
+	const mat4& GetProjectionMatrix() const { return m_Projection; }
 	void SetClippingPlanes(float Near, float Far);
 	void ReSizeGLScene(int width, int height);
 
@@ -89,6 +92,9 @@ extern bool g_bUseFramebufferObjects;
 /** Indicates support for GL_ARB_depth_texture */
 extern bool g_bUseDepthTexture;
 
+/** Indicates support for GL_ARB_vertex_buffer_object */
+extern bool g_bUseVertexBufferObjects;
+
 /** Indicates support for shadows */
 extern bool supportsShadow;
 
@@ -30,9 +30,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 
 #include "random.h"
 #include "particle.h"
+#include "ParticleRenderer.h"
+#include "simd.h"
 
 namespace Engine {
 
@@ -54,8 +57,6 @@ vec3 GetRandomVector(float length)
 	return( vector * length );
 }
 
-typedef ParticleElement* ELEMENT_PTR;
-
 ParticleBody::ParticleBody(void)
 : position(0,0,0),
   initialVelocity(0,0,0),
@@ -108,14 +109,19 @@ void ParticleBody::update(float dTime)
 }
 
 void ParticleBody::setPosition(const vec3 &position, const vec3 &center)
+{
+	initialVelocity = getOutwardVelocity(position, center);
+
+	initialPosition = position;
+}
+
+vec3 ParticleBody::getOutwardVelocity(const vec3 &position, const vec3 &center) const
 {
 	const vec3 dirAwayFromCenter = vec3(position-center).getNormal();
 
 	const float addVariety = FRAND_RANGE(0.8f, 1.2f);
 
-	initialVelocity = dirAwayFromCenter * (initialOutwardVelocity*addVariety);
-
-	initialPosition = position;
+	return dirAwayFromCenter * (initialOutwardVelocity*addVariety);
 }
 
 void ParticleBody::setPosition(const vec3 &position)
@@ -131,6 +137,8 @@ ParticleGraph::ParticleGraph(void)
 
 	min = vec2(0,0);
 	max = vec2(0,0);
+
+	bake();
 }
 
 ParticleGraph::ParticleGraph(const PropertyBag & xml)
@@ -162,12 +170,32 @@ void ParticleGraph::load(const PropertyBag &xml)
 		if(pt.x > max.x) max.x = pt.x;
 		if(pt.y > max.y) max.y = pt.y;
 	}
+
+	bake();
+}
+
+void ParticleGraph::bake(void)
+{
+	for(int i=0; i<=RESOLUTION; ++i)
+	{
+		table[i] = calculateValue((float)i / RESOLUTION);
+	}
+
+	table[RESOLUTION+1] = table[RESOLUTION];
 }
 
 float ParticleGraph::getValue(float t) const
 {
 	ASSERT(t >= 0.0f && t <= 1.0f, "Parameter \'t\' is invalid: " + ftoa(t));
 
+	const float x = t * RESOLUTION;
+	const int i = (int)x;
+
+	return table[i] + (table[i+1] - table[i]) * (x - i);
+}
+
+float ParticleGraph::calculateValue(float t) const
+{
 	size_t numberOfPoints = points.size();
 
 	if(numberOfPoints == 0)
@@ -197,6 +225,13 @@ float ParticleGraph::getValue(float t) const
 	return 0.0f;
 }
 
+void ParticleVectors::resize(size_t n)
+{
+	x.resize(n);
+	y.resize(n);
+	z.resize(n);
+}
+
 ParticleElement::ParticleElement(void)
 : ParticleBody(),
   materialHandle(0),
@@ -292,7 +327,7 @@ void ParticleElement::draw(const mat4 &matrix) const
 
 		const Material &material = owner->getMaterial(materialHandle);
 		material.bind();
-		glBlendFunc(GL_SRC_ALPHA, (material.glow) ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+		g_StateCache.blendFunc(GL_SRC_ALPHA, (material.glow) ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
 	}
 
 	// Build the billboard vertices
@@ -343,19 +378,33 @@ void ParticleElement::update(float deltaTime)
 
 	ASSERT(lifeSpan!=0.0f, "m_LifeSpan==0.0, and causes division by zero.");
 
-	const float percent = age / lifeSpan;
-
-	graphSizeImmediate     = graphSize  . getValue(percent);
-	graphAlphaImmediate    = graphAlpha . getValue(percent);
-	graphRedImmediate      = graphRed   . getValue(percent);
-	graphGreenImmediate    = graphGreen . getValue(percent);
-	graphBlueImmediate     = graphBlue  . getValue(percent);
+	getValues(age / lifeSpan,
+	          graphSizeImmediate,
+	          graphRedImmediate,
+	          graphGreenImmediate,
+	          graphBlueImmediate,
+	          graphAlphaImmediate);
 
 	ParticleBody::update(deltaTime);
 }
 
+void ParticleElement::getValues(float percent,
+                                float &size,
+                                float &red,
+                                float &green,
+                                float &blue,
+                                float &alpha) const
+{
+	size  = graphSize  . getValue(percent);
+	red   = graphRed   . getValue(percent);
+	green = graphGreen . getValue(percent);
+	blue  = graphBlue  . getValue(percent);
+	alpha = graphAlpha . getValue(percent);
+}
+
 ParticleEmitter::ParticleEmitter(const PropertyBag &data, ParticleSystem &Owner)
 : owner(&Owner),
+  particleTemplate(0),
   radiusFalloff(1.0f),
   age(0.0f),
   lifeSpan(0.0f),
@@ -365,7 +414,7 @@ ParticleEmitter::ParticleEmitter(const PropertyBag &data, ParticleSystem &Owner)
 	{
 		string t;
 		data.get("template", t);
-		particleTemplate = owner->getTemplate(t);
+		particleTemplate = &owner->getTemplate(t);
 	}
 
 	{
@@ -425,9 +474,15 @@ void ParticleEmitter::update(float deltaTime)
 	{
 		ASSERT(lifeSpan > 0.0f, "lifeSpan==0 -> will cause division by zero");
 
+		/*
+		Emitter graphs are evaluated a few times a frame, so they use the
+		exact curve rather than the lookup table.  Several of the shipped
+		rate graphs have a point between two table entries, which the
+		table would round off.
+		*/
 		for(size_t i = 0,
 				   numberOfEmittedParticles =
-					(size_t)ceil(graphEmissionRate.getValue(age / lifeSpan));
+					(size_t)ceil(graphEmissionRate.calculateValue(age / lifeSpan));
 			i < numberOfEmittedParticles;
 			++i)
 		{
@@ -441,12 +496,7 @@ void ParticleEmitter::emitParticle(void)
 	ASSERT(owner!=0, "owner was null");
 	ASSERT(lifeSpan > 0.0f, "lifeSpan==0 -> will cause division by zero");
 
-	// Copy the template
-	ParticleElement particle = particleTemplate;
-
-	particle.setSizeMultiplier(graphSizeMultiplier.getValue(age / lifeSpan));
-
-	particle.setLifeSpan(graphLifeSpan.getValue(age / lifeSpan));
+	ASSERT(particleTemplate!=0, "particleTemplate was null");
 
 	/*
 	Chooses a point at a random distance away from the emitter position,
@@ -455,9 +505,14 @@ void ParticleEmitter::emitParticle(void)
 	*/
 	const float radius = radiusFalloff * (1 - powf((float)M_E, -SQR(FRAND_RANGE(0,2))));
 	const vec3 offset = GetRandomVector(radius);
-	particle.setPosition(owner->getPosition() + offset, owner->getPosition());
-
-	owner->spawn(particle);
+	const vec3 center = owner->getPosition();
+	const vec3 position = center + offset;
+
+	owner->spawn(*particleTemplate,
+	             position,
+	             particleTemplate->getOutwardVelocity(position, center),
+	             graphSizeMultiplier.calculateValue(age / lifeSpan),
+	             graphLifeSpan.calculateValue(age / lifeSpan));
 }
 
 bool ParticleEmitter::isDead(void) const
@@ -471,37 +526,62 @@ void ParticleEmitter::kill(void)
 	numberOfLifeCycles = 0; // Do not loop
 }
 
+void ParticleEmitter::setOwner(ParticleSystem &system)
+{
+	ASSERT(particleTemplate!=0, "particleTemplate was null");
+
+	owner = &system;
+	particleTemplate = &owner->getTemplate(particleTemplate->getName());
+}
+
+size_t ParticleSystem::numParticlesUpdated = 0;
+
 ParticleSystem::ParticleSystem(PropertyBag &Bag)
 : ParticleBody(Bag),
   maxNumberOfParticles(0),
   emissionBehavior(IGNORE_EMISSION),
-  elements(0)
+  numParticles(0)
 {
 	load(Bag);
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem &system)
 : ParticleBody(system),
+  templatesByName(system.templatesByName),
+  materials(system.materials),
   emitters(system.emitters),
   maxNumberOfParticles(system.maxNumberOfParticles),
   emissionBehavior(system.emissionBehavior),
-  elements(0)
+  numParticles(system.numParticles),
+  particleTemplates(system.particleTemplates),
+  particleInitialPositions(system.particleInitialPositions),
+  particleVelocities(system.particleVelocities),
+  particleAccelerations(system.particleAccelerations),
+  particlePositions(system.particlePositions),
+  particleAges(system.particleAges),
+  particleLifeSpans(system.particleLifeSpans),
+  particleSizeMultipliers(system.particleSizeMultipliers),
+  particleRadii(system.particleRadii),
+  particleReds(system.particleReds),
+  particleGreens(system.particleGreens),
+  particleBlues(system.particleBlues),
+  particleAlphas(system.particleAlphas)
 {
-	// Allocate the m_pElements array
-	elements = new ELEMENT_PTR[maxNumberOfParticles];
-	ASSERT(elements != 0,  "elements[i] was null");
-	memset(elements, 0, sizeof(ELEMENT_PTR) * maxNumberOfParticles);
+	// Templates, emitters, and particles must refer to this system's copies
+	for(map<string, ParticleElement>::iterator i = templatesByName.begin();
+	    i != templatesByName.end(); ++i)
+	{
+		i->second.owner = this;
+	}
 
-	// Copy the particle data
-	for(size_t i=0; i<maxNumberOfParticles; ++i)
+	for(size_t i=0; i<emitters.size(); ++i)
 	{
-		elements[i] = 0;
+		emitters[i].setOwner(*this);
+	}
 
-		if(system.elements[i])
-		{
-			elements[i] = new ParticleElement(*system.elements[i]);
-			ASSERT(elements[i] != 0, "elements[i] was null");
-		}
+	for(size_t i=0; i<numParticles; ++i)
+	{
+		particleTemplates[i] = &getTemplate(particleTemplates[i]->getName());
 	}
 }
 
@@ -509,7 +589,7 @@ ParticleSystem::ParticleSystem( const string &fileName )
 : ParticleBody(),
   maxNumberOfParticles(0),
   emissionBehavior(IGNORE_EMISSION),
-  elements(0)
+  numParticles(0)
 {
 	PropertyBag Bag;
 	Bag.loadFromFile(fileName);
@@ -520,7 +600,7 @@ ParticleSystem::ParticleSystem(void)
 : ParticleBody(),
   maxNumberOfParticles(0),
   emissionBehavior(IGNORE_EMISSION),
-  elements(0)
+  numParticles(0)
 {}
 
 ParticleSystem::~ParticleSystem(void)
@@ -530,12 +610,26 @@ ParticleSystem::~ParticleSystem(void)
 
 void ParticleSystem::destroyElements(void)
 {
-	for(size_t i=0; elements!=0 && i<maxNumberOfParticles; ++i)
-	{
-		delete(elements[i]);
-	}
+	allocateElements(0);
+}
 
-	delete [] elements;
+void ParticleSystem::allocateElements(size_t maxNumberOfParticles)
+{
+	numParticles = 0;
+
+	particleTemplates.resize(maxNumberOfParticles);
+	particleInitialPositions.resize(maxNumberOfParticles);
+	particleVelocities.resize(maxNumberOfParticles);
+	particleAccelerations.resize(maxNumberOfParticles);
+	particlePositions.resize(maxNumberOfParticles);
+	particleAges.resize(maxNumberOfParticles);
+	particleLifeSpans.resize(maxNumberOfParticles);
+	particleSizeMultipliers.resize(maxNumberOfParticles);
+	particleRadii.resize(maxNumberOfParticles);
+	particleReds.resize(maxNumberOfParticles);
+	particleGreens.resize(maxNumberOfParticles);
+	particleBlues.resize(maxNumberOfParticles);
+	particleAlphas.resize(maxNumberOfParticles);
 }
 
 void ParticleSystem::load(PropertyBag &Bag)
@@ -559,34 +653,15 @@ void ParticleSystem::load(PropertyBag &Bag)
 	Bag.get("max", maxNumberOfParticles);
 	ASSERT(maxNumberOfParticles>0, "particle system does not give maxNumberOfParticles>0");
 
-	// Allocate the m_pElements array
-	elements = new ELEMENT_PTR[maxNumberOfParticles];
-	ASSERT(elements!=0, "elements was null");
-	memset(elements, 0, sizeof(ELEMENT_PTR) * maxNumberOfParticles);
+	// Allocate storage for the particles
+	allocateElements(maxNumberOfParticles);
 
 	// Load the materials from XML for particles
 	for(size_t i=0; i<nMaterials; ++i)
 	{
-		Material mat;
 		PropertyBag MatBag;
-
 		Bag.get("material", MatBag, i);
-
-		MatBag.get("glow", mat.glow);
-
-		{
-			string name;
-			MatBag.get("name", name);
-			mat.setName(name);
-		}
-
-		{
-			string image;
-			MatBag.get("image", image);
-			mat.loadTexture(image, 0);
-		}
-
-		materials.push_back(mat);
+		materials.push_back(loadMaterial(MatBag));
 	}
 
 	// Load the particle templates
@@ -615,25 +690,39 @@ void ParticleSystem::load(PropertyBag &Bag)
 	ASSERT(!emitters.empty(),        "after loading, there are no particle emitters in system");
 }
 
-void ParticleSystem::draw(void) const
+Material ParticleSystem::loadMaterial(PropertyBag &MatBag)
 {
-	ASSERT(elements!=0, "Cannot draw particles because none were allocated!");
+	Material mat;
 
-	float matrix[16] = {0};
+	MatBag.get("glow", mat.glow);
 
-	glGetFloatv(GL_MODELVIEW_MATRIX,matrix);
+	{
+		string name;
+		MatBag.get("name", name);
+		mat.setName(name);
+	}
+
+	{
+		string image;
+		MatBag.get("image", image);
+		mat.loadTexture(image, 0);
+	}
 
-	glPushMatrix();
-	glDepthMask(GL_FALSE);
+	return mat;
+}
 
-		for(size_t i = 0; i<maxNumberOfParticles; ++i)
+void ParticleSystem::draw(ParticleRenderer &renderer) const
+{
+	for(size_t i = 0; i<numParticles; ++i)
+	{
+		if(particleAges[i] <= particleLifeSpans[i])
 		{
-			if(elements[i] && !elements[i]->isDead())
-				elements[i]->draw(matrix);
+			renderer.add(materials[particleTemplates[i]->materialHandle],
+			             particlePositions.get(i),
+			             particleRadii[i],
+			             COLOR(particleReds[i], particleGreens[i], particleBlues[i], particleAlphas[i]));
 		}
-
-	glDepthMask(GL_TRUE);
-	glPopMatrix();
+	}
 }
 
 void ParticleSystem::update(float dTime)
@@ -643,46 +732,371 @@ void ParticleSystem::update(float dTime)
 		emitters[i].update(dTime);
 	}
 
-	ASSERT(elements!=0, "Cannot update particles: no particle storage has even been allocated!");
-
-	for(size_t i=0; i<maxNumberOfParticles; ++i)
+	// Swap dead particles out of the live range
+	for(size_t i=0; i<numParticles; )
 	{
-		if(!elements[i] || (elements[i] && elements[i]->isDead()))
+		if(particleAges[i] > particleLifeSpans[i])
 		{
-			delete(elements[i]);
-			elements[i] = 0;
+			removeParticle(i); // the last particle now sits at i
 		}
 		else
 		{
-			elements[i]->update(dTime);
+			++i;
 		}
 	}
 
+	evaluateParticles();
+
+	integrateParticles(dTime);
+
+	numParticlesUpdated += numParticles;
+
 	ParticleBody::update(dTime);
 }
 
-void ParticleSystem::spawn(const ParticleElement &element)
+void ParticleSystem::evaluateParticle(size_t i)
+{
+	evaluateScalar(1,
+	               &particleTemplates[i],
+	               &particleAges[i],
+	               &particleLifeSpans[i],
+	               &particleSizeMultipliers[i],
+	               &particleRadii[i],
+	               &particleReds[i],
+	               &particleGreens[i],
+	               &particleBlues[i],
+	               &particleAlphas[i]);
+}
+
+void ParticleSystem::evaluateParticles(void)
+{
+	if(numParticles == 0)
+		return;
+
+	evaluate(numParticles,
+	         &particleTemplates[0],
+	         &particleAges[0],
+	         &particleLifeSpans[0],
+	         &particleSizeMultipliers[0],
+	         &particleRadii[0],
+	         &particleReds[0],
+	         &particleGreens[0],
+	         &particleBlues[0],
+	         &particleAlphas[0]);
+}
+
+void ParticleSystem::integrateParticles(float dTime)
+{
+	if(numParticles == 0)
+		return;
+
+	integrate(numParticles,
+	          dTime,
+	          &particleAges[0],
+	          particleInitialPositions,
+	          particleVelocities,
+	          particleAccelerations,
+	          particlePositions);
+}
+
+/**
+Moves a range of particles along their paths, one particle at a time
+@param begin Index of the first particle
+@param end Index one past the last particle
+@param dTime Milliseconds since the last update
+@param ages Milliseconds since each particle was created; advanced in place
+@param p0 Initial position of each particle
+@param v Initial velocity of each particle (meters per second)
+@param a Constant acceleration of each particle
+@param p Returns the new position of each particle
+*/
+static void integrateRange(size_t begin,
+                           size_t end,
+                           float dTime,
+                           float *ages,
+                           const ParticleVectors &p0,
+                           const ParticleVectors &v,
+                           const ParticleVectors &a,
+                           ParticleVectors &p)
 {
-	ASSERT(elements!=0, "Cannot spawn particle: no particle storage was allocated!");
+	for(size_t i=begin; i<end; ++i)
+	{
+		const float t = (ages[i] += dTime) / 1000.0f;
+		const float h = 0.5f * t * t;
+
+		p.x[i] = a.x[i]*h + v.x[i]*t + p0.x[i];
+		p.y[i] = a.y[i]*h + v.y[i]*t + p0.y[i];
+		p.z[i] = a.z[i]*h + v.z[i]*t + p0.z[i];
+	}
+}
+
+#ifdef ENGINE_USE_SSE2
+/**
+Moves one coordinate of four particles along their paths
+@param t Seconds since each particle was created
+@param h Half of t squared
+@param p0 Initial coordinate of the first particle
+@param v Initial velocity of the first particle along the axis
+@param a Constant acceleration of the first particle along the axis
+@param p Returns the new coordinate of each particle
+*/
+static inline void integrateAxis(__m128 t, __m128 h, const float *p0, const float *v, const float *a, float *p)
+{
+	_mm_storeu_ps(p, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a), h),
+	                                       _mm_mul_ps(_mm_loadu_ps(v), t)),
+	                            _mm_loadu_ps(p0)));
+}
+#endif
+
+void ParticleSystem::integrate(size_t count,
+                               float dTime,
+                               float *ages,
+                               const ParticleVectors &p0,
+                               const ParticleVectors &v,
+                               const ParticleVectors &a,
+                               ParticleVectors &p)
+{
+	size_t i = 0;
+
+#ifdef ENGINE_USE_SSE2
+	// Each coordinate has its own array, so four particles fill every register
+	const __m128 delta = _mm_set1_ps(dTime);
+	const __m128 milliseconds = _mm_set1_ps(1000.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128 age = _mm_add_ps(_mm_loadu_ps(ages + i), delta);
+		_mm_storeu_ps(ages + i, age);
+
+		const __m128 t = _mm_div_ps(age, milliseconds);
+		const __m128 h = _mm_mul_ps(_mm_mul_ps(half, t), t);
+
+		integrateAxis(t, h, &p0.x[i], &v.x[i], &a.x[i], &p.x[i]);
+		integrateAxis(t, h, &p0.y[i], &v.y[i], &a.y[i], &p.y[i]);
+		integrateAxis(t, h, &p0.z[i], &v.z[i], &a.z[i], &p.z[i]);
+	}
+#endif
+
+	// The remainder, or everything without SSE2
+	integrateRange(i, count, dTime, ages, p0, v, a, p);
+}
+
+void ParticleSystem::integrateScalar(size_t count,
+                                     float dTime,
+                                     float *ages,
+                                     const ParticleVectors &p0,
+                                     const ParticleVectors &v,
+                                     const ParticleVectors &a,
+                                     ParticleVectors &p)
+{
+	integrateRange(0, count, dTime, ages, p0, v, a, p);
+}
+
+#ifdef ENGINE_USE_SSE2
+/**
+Fetches the two lookup table entries that one particle interpolates between
+@param graph Graph of the particle
+@param index Entry below the particle's time
+@param lane Lane of the particle
+@param low Returns the entry below the particle's time, in the lane
+@param high Returns the entry above the particle's time, in the lane
+*/
+static inline void fetch(const ParticleGraph &graph, int index, int lane, float *low, float *high)
+{
+	const float *table = graph.getTable();
+	low[lane] = table[index];
+	high[lane] = table[index+1];
+}
+
+/**
+Interpolates four particles between their lookup table entries
+@param low Entries below each particle's time
+@param high Entries above each particle's time
+@param fraction Distance of each particle's time past its lower entry, in [0, 1]
+*/
+static inline __m128 interpolate(const float *low, const float *high, __m128 fraction)
+{
+	const __m128 a = _mm_loadu_ps(low);
+	return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(high), a), fraction));
+}
+#endif
+
+void ParticleSystem::evaluate(size_t count,
+                              const ParticleElement * const *templates,
+                              const float *ages,
+                              const float *lifeSpans,
+                              const float *sizeMultipliers,
+                              float *radii,
+                              float *reds,
+                              float *greens,
+                              float *blues,
+                              float *alphas)
+{
+	size_t i = 0;
+
+#ifdef ENGINE_USE_SSE2
+	/*
+	The arithmetic of ParticleGraph::getValue, four particles at a time.
+	SSE2 cannot gather from four different tables, so the entries each
+	particle interpolates between are fetched one particle at a time.
+	*/
+	const __m128 resolution = _mm_set1_ps((float)ParticleGraph::RESOLUTION);
+
+	enum { SIZE, RED, GREEN, BLUE, ALPHA, NUM_GRAPHS };
 
-	for(size_t i=0; i<maxNumberOfParticles; ++i)
+	for(; i + 4 <= count; i += 4)
 	{
-		if(elements[i] == 0)
+		const __m128 x = _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(ages + i), _mm_loadu_ps(lifeSpans + i)), resolution);
+		const __m128i entry = _mm_cvttps_epi32(x);
+		const __m128 fraction = _mm_sub_ps(x, _mm_cvtepi32_ps(entry));
+
+		int index[4];
+		_mm_storeu_si128((__m128i*)index, entry);
+
+		float low[NUM_GRAPHS][4], high[NUM_GRAPHS][4];
+
+		for(int lane=0; lane<4; ++lane)
 		{
-			elements[i] = new ParticleElement(element);
-			return;
+			ASSERT(index[lane] >= 0 && index[lane] <= ParticleGraph::RESOLUTION, "particle age is outside of its life span");
+
+			const ParticleElement &element = *templates[i+lane];
+
+			fetch(element.getGraphSize(),  index[lane], lane, low[SIZE],  high[SIZE]);
+			fetch(element.getGraphRed(),   index[lane], lane, low[RED],   high[RED]);
+			fetch(element.getGraphGreen(), index[lane], lane, low[GREEN], high[GREEN]);
+			fetch(element.getGraphBlue(),  index[lane], lane, low[BLUE],  high[BLUE]);
+			fetch(element.getGraphAlpha(), index[lane], lane, low[ALPHA], high[ALPHA]);
 		}
+
+		_mm_storeu_ps(radii + i,  _mm_mul_ps(_mm_loadu_ps(sizeMultipliers + i), interpolate(low[SIZE], high[SIZE], fraction)));
+		_mm_storeu_ps(reds + i,   interpolate(low[RED],   high[RED],   fraction));
+		_mm_storeu_ps(greens + i, interpolate(low[GREEN], high[GREEN], fraction));
+		_mm_storeu_ps(blues + i,  interpolate(low[BLUE],  high[BLUE],  fraction));
+		_mm_storeu_ps(alphas + i, interpolate(low[ALPHA], high[ALPHA], fraction));
 	}
+#endif
+
+	// The remainder, or everything without SSE2
+	evaluateScalar(count - i,
+	               templates + i,
+	               ages + i,
+	               lifeSpans + i,
+	               sizeMultipliers + i,
+	               radii + i,
+	               reds + i,
+	               greens + i,
+	               blues + i,
+	               alphas + i);
+}
 
-	if(emissionBehavior == REPLACE_RANDOM)
+void ParticleSystem::evaluateScalar(size_t count,
+                                    const ParticleElement * const *templates,
+                                    const float *ages,
+                                    const float *lifeSpans,
+                                    const float *sizeMultipliers,
+                                    float *radii,
+                                    float *reds,
+                                    float *greens,
+                                    float *blues,
+                                    float *alphas)
+{
+	for(size_t i=0; i<count; ++i)
 	{
-		size_t i = IRAND_RANGE(0, maxNumberOfParticles-1);
+		ASSERT(lifeSpans[i]!=0.0f, "lifeSpan==0.0, and causes division by zero.");
 
-		delete(elements[i]);
-		elements[i] = new ParticleElement(element);
+		float size=0.0f;
 
-		return;
+		templates[i]->getValues(ages[i] / lifeSpans[i],
+		                        size,
+		                        reds[i],
+		                        greens[i],
+		                        blues[i],
+		                        alphas[i]);
+
+		radii[i] = sizeMultipliers[i] * size;
+	}
+}
+
+void ParticleSystem::getParticle(size_t i,
+                                 vec3 &initialPosition,
+                                 vec3 &velocity,
+                                 vec3 &acceleration,
+                                 vec3 &position,
+                                 float &age) const
+{
+	ASSERT(i < numParticles, "Parameter \'i\' out of bounds!");
+
+	initialPosition = particleInitialPositions.get(i);
+	velocity        = particleVelocities.get(i);
+	acceleration    = particleAccelerations.get(i);
+	position        = particlePositions.get(i);
+	age             = particleAges[i];
+}
+
+void ParticleSystem::removeParticle(size_t i)
+{
+	ASSERT(i < numParticles, "Parameter \'i\' out of bounds!");
+
+	const size_t last = --numParticles;
+
+	if(i != last)
+	{
+		particleTemplates[i]        = particleTemplates[last];
+		particleInitialPositions.move(i, last);
+		particleVelocities.move(i, last);
+		particleAccelerations.move(i, last);
+		particlePositions.move(i, last);
+		particleAges[i]             = particleAges[last];
+		particleLifeSpans[i]        = particleLifeSpans[last];
+		particleSizeMultipliers[i]  = particleSizeMultipliers[last];
+		particleRadii[i]            = particleRadii[last];
+		particleReds[i]             = particleReds[last];
+		particleGreens[i]           = particleGreens[last];
+		particleBlues[i]            = particleBlues[last];
+		particleAlphas[i]           = particleAlphas[last];
+	}
+}
+
+void ParticleSystem::spawn(const ParticleElement &element)
+{
+	spawn(getTemplate(element.getName()),
+	      element.initialPosition,
+	      element.getInitialVelocity(),
+	      element.getSizeMultiplier(),
+	      element.lifeSpan);
+}
+
+void ParticleSystem::spawn(const ParticleElement &particleTemplate,
+                           const vec3 &position,
+                           const vec3 &velocity,
+                           float sizeMultiplier,
+                           float lifeSpan)
+{
+	size_t i = numParticles;
+
+	if(numParticles == maxNumberOfParticles)
+	{
+		if(emissionBehavior != REPLACE_RANDOM || maxNumberOfParticles == 0)
+			return;
+
+		i = IRAND_RANGE(0, maxNumberOfParticles-1);
+	}
+	else
+	{
+		numParticles++;
 	}
+
+	particleTemplates[i]        = &particleTemplate;
+	particleInitialPositions.set(i, position);
+	particleVelocities.set(i, velocity);
+	particleAccelerations.set(i, particleTemplate.constantAcceleration);
+	particlePositions.set(i, position);
+	particleAges[i]             = 0.0f;
+	particleLifeSpans[i]        = lifeSpan;
+	particleSizeMultipliers[i]  = sizeMultiplier;
+
+	evaluateParticle(i);
 }
 
 const ParticleElement& ParticleSystem::getTemplate(const string &name)
@@ -731,11 +1145,7 @@ void ParticleSystem::kill(void)
 		emitters[i].kill();
 	}
 
-	for(size_t i=0; i<maxNumberOfParticles; ++i)
-	{
-		delete(elements[i]);
-		elements[i] = 0;
-	}
+	numParticles = 0;
 }
 
 } // namespace Engine
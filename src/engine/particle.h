@@ -105,6 +105,15 @@ public:
 		return position;
 	}
 
+	/**
+	Gets the initial velocity of the Body
+	@return initial velocity of the Body (meters per second)
+	*/
+	inline const vec3& getInitialVelocity(void) const
+	{
+		return initialVelocity;
+	}
+
 	/**
 	Sets the position of the body
 	@param position Position of the body
@@ -112,6 +121,15 @@ public:
 	*/
 	void setPosition(const vec3 &position, const vec3 &center);
 
+	/**
+	Calculates a velocity directed outward from a center point, using
+	the initial radial velocity of the body with some random variety
+	@param position Position of the body
+	@param center Center of the body
+	@return Initial velocity (meters per second)
+	*/
+	vec3 getOutwardVelocity(const vec3 &position, const vec3 &center) const;
+
 	/**
 	Sets the position of the body
 	@param position Position of the body
@@ -128,6 +146,9 @@ systems e.g. colors, size.
 class ParticleGraph
 {
 public:
+	/** Number of intervals in the lookup table that the curve is baked into */
+	static const int RESOLUTION = 256;
+
 	/** Min. corner of the graph */
 	vec2 min;
 
@@ -138,6 +159,12 @@ private:
 	/** data points */
 	vector<Point2> points;
 
+	/**
+	The curve sampled at RESOLUTION+1 evenly spaced times over [0, 1].
+	The last sample is repeated so that t == 1 interpolates like any other time.
+	*/
+	float table[RESOLUTION+2];
+
 public:
 	/** Default Constructor */
 	ParticleGraph(void);
@@ -155,13 +182,94 @@ public:
 	void load(const PropertyBag &xml);
 
 	/**
-	Calculates the value at the specified time
+	Calculates the value at the specified time.
+	Interpolates between entries of the lookup table, so this does not
+	search the data points.
 	@param t [0.0, 1.0] representing progress through time on the curve
 	*/
 	float getValue(float t) const;
+
+	/**
+	Calculates the value at the specified time directly from the data points.
+	This is what the lookup table is baked from, and the reference it is tested against.
+	The table is only exact where every data point falls on one of its entries.
+	@param t [0.0, 1.0] representing progress through time on the curve
+	*/
+	float calculateValue(float t) const;
+
+	/**
+	Gets the lookup table, for evaluating many curves at once.
+	getValue(t) interpolates between entries i and i+1, where i is t*RESOLUTION rounded down.
+	@return RESOLUTION+2 entries
+	*/
+	inline const float* getTable(void) const
+	{
+		return table;
+	}
+
+private:
+	/** Samples the curve into the lookup table */
+	void bake(void);
+};
+
+/**
+A run of vectors stored as one array per coordinate.
+SSE code can then load the same coordinate of four consecutive vectors into one register.
+*/
+class ParticleVectors
+{
+public:
+	/** x coordinate of each vector */
+	vector<float> x;
+
+	/** y coordinate of each vector */
+	vector<float> y;
+
+	/** z coordinate of each vector */
+	vector<float> z;
+
+	/**
+	Changes the number of vectors
+	@param n Number of vectors
+	*/
+	void resize(size_t n);
+
+	/**
+	Gets one of the vectors
+	@param i Index of the vector
+	*/
+	inline vec3 get(size_t i) const
+	{
+		return vec3(x[i], y[i], z[i]);
+	}
+
+	/**
+	Sets one of the vectors
+	@param i Index of the vector
+	@param v New value of the vector
+	*/
+	inline void set(size_t i, const vec3 &v)
+	{
+		x[i] = v.x;
+		y[i] = v.y;
+		z[i] = v.z;
+	}
+
+	/**
+	Copies one vector over another
+	@param to Index of the vector to overwrite
+	@param from Index of the vector to copy
+	*/
+	inline void move(size_t to, size_t from)
+	{
+		x[to] = x[from];
+		y[to] = y[from];
+		z[to] = z[from];
+	}
 };
 
 class ParticleSystem; // Prototype
+class ParticleRenderer; // Prototype
 
 /** A single particle element. */
 class ParticleElement : public ParticleBody
@@ -246,6 +354,23 @@ public:
 	*/
 	void update(float deltaTime);
 
+	/**
+	Evaluates the element's graphs at some point in its life.
+	The graphs are shared by every particle spawned from this template.
+	@param percent [0.0, 1.0] representing progress through the life span
+	@param size Returns the size in meters (before the size multiplier)
+	@param red Returns the red component
+	@param green Returns the green component
+	@param blue Returns the blue component
+	@param alpha Returns the alpha component
+	*/
+	void getValues(float percent,
+	               float &size,
+	               float &red,
+	               float &green,
+	               float &blue,
+	               float &alpha) const;
+
 	/**
 	Determines whether the particle is dead or not
 	@return true if the particle is now dead
@@ -270,6 +395,36 @@ public:
 		return age;
 	}
 
+	/** Gets the size in meters over time */
+	inline const ParticleGraph& getGraphSize(void) const
+	{
+		return graphSize;
+	}
+
+	/** Gets the red component over time */
+	inline const ParticleGraph& getGraphRed(void) const
+	{
+		return graphRed;
+	}
+
+	/** Gets the green component over time */
+	inline const ParticleGraph& getGraphGreen(void) const
+	{
+		return graphGreen;
+	}
+
+	/** Gets the blue component over time */
+	inline const ParticleGraph& getGraphBlue(void) const
+	{
+		return graphBlue;
+	}
+
+	/** Gets the alpha component over time */
+	inline const ParticleGraph& getGraphAlpha(void) const
+	{
+		return graphAlpha;
+	}
+
 	inline float setSizeMultiplier(float x)
 	{
 		return(sizeMultiplier = x);
@@ -291,8 +446,8 @@ private:
 	/** The particle system that owns this emitter */
 	ParticleSystem *owner;
 
-	/** Particle template for all Elements emitted by this object */
-	ParticleElement particleTemplate;
+	/** Particle template for all Elements emitted by this object (owned by the system) */
+	const ParticleElement *particleTemplate;
 
 	/** The probability of a particle being created drops to zero between the hot spot radius and the falloff radius. */
 	float radiusFalloff;
@@ -350,6 +505,13 @@ public:
 	*/
 	bool isDead(void) const;
 
+	/**
+	Attaches the emitter to a different particle system.
+	The particle template is looked up again by name in the new system.
+	@param owner ParticleSystem that owns the emitter
+	*/
+	void setOwner(ParticleSystem &owner);
+
 private:
 	/** Emits a particle */
 	void emitParticle(void);
@@ -382,8 +544,57 @@ private:
 		REPLACE_RANDOM
 	} emissionBehavior;
 
-	/** Array of particles allocated for the ParticleSystem */
-	ParticleElement **elements;
+	/*
+	Particles are stored as parallel arrays allocated once, when the system
+	is loaded, for maxNumberOfParticles particles. Live particles are packed
+	into the range [0, numParticles) and dead ones are swapped out of it, so
+	spawning and updating never touch the heap or scan for free slots.
+	*/
+
+	/** Number of live particles at the front of the particle arrays */
+	size_t numParticles;
+
+	/** Template that each particle was spawned from (shares the graphs) */
+	vector<const ParticleElement*> particleTemplates;
+
+	/** Initial position of each particle */
+	ParticleVectors particleInitialPositions;
+
+	/** Initial velocity of each particle (meters per second) */
+	ParticleVectors particleVelocities;
+
+	/** Constant acceleration of each particle, copied from its template */
+	ParticleVectors particleAccelerations;
+
+	/** Current position of each particle */
+	ParticleVectors particlePositions;
+
+	/** Milliseconds since each particle was created */
+	vector<float> particleAges;
+
+	/** Milliseconds that each particle will be alive for */
+	vector<float> particleLifeSpans;
+
+	/** Multiplier for the size of each particle */
+	vector<float> particleSizeMultipliers;
+
+	/** Radius of each particle at the immediate moment */
+	vector<float> particleRadii;
+
+	/** Red component of each particle at the immediate moment */
+	vector<float> particleReds;
+
+	/** Green component of each particle at the immediate moment */
+	vector<float> particleGreens;
+
+	/** Blue component of each particle at the immediate moment */
+	vector<float> particleBlues;
+
+	/** Alpha component of each particle at the immediate moment */
+	vector<float> particleAlphas;
+
+	/** Particles updated over the lifetime of the program */
+	static size_t numParticlesUpdated;
 
 public:
 	/** Destructor */
@@ -414,8 +625,11 @@ public:
 	*/
 	virtual void load(PropertyBag &data);
 
-	/** Draws the particles in the system */
-	void draw(void) const;
+	/**
+	Adds a billboard for each live particle in the system to the renderer
+	@param renderer Collects and draws the billboards
+	*/
+	void draw(ParticleRenderer &renderer) const;
 
 	/**
 	Updates the particle system
@@ -429,6 +643,20 @@ public:
 	*/
 	void spawn(const ParticleElement &element);
 
+	/**
+	Spawns a new particle from one of this system's templates
+	@param particleTemplate Template of the new particle
+	@param position Initial position of the particle
+	@param velocity Initial velocity of the particle (meters per second)
+	@param sizeMultiplier Multiplier for the size of the particle
+	@param lifeSpan Milliseconds that the particle will be alive for
+	*/
+	void spawn(const ParticleElement &particleTemplate,
+	           const vec3 &position,
+	           const vec3 &velocity,
+	           float sizeMultiplier,
+	           float lifeSpan);
+
 	/**
 	Retrieves a particle template given its name
 	@param name Name of the particle template
@@ -454,9 +682,146 @@ public:
 	/** Kills each particle emitter */
 	void kill(void);
 
+	/** Gets the number of live particles in the system */
+	inline size_t getNumParticles(void) const
+	{
+		return numParticles;
+	}
+
+	/** Gets the number of particles updated over the lifetime of the program */
+	static size_t getNumParticlesUpdated(void)
+	{
+		return numParticlesUpdated;
+	}
+
+	/**
+	Gets the state of a live particle
+	@param i Index of the particle
+	@param initialPosition Returns the initial position of the particle
+	@param velocity Returns the initial velocity of the particle
+	@param acceleration Returns the acceleration of the particle
+	@param position Returns the current position of the particle
+	@param age Returns the milliseconds since the particle was created
+	*/
+	void getParticle(size_t i,
+	                 vec3 &initialPosition,
+	                 vec3 &velocity,
+	                 vec3 &acceleration,
+	                 vec3 &position,
+	                 float &age) const;
+
+	/**
+	Advances the ages of a run of particles and moves each along its path.
+	With SSE2, four particles are advanced at a time.
+	@param count Number of particles
+	@param deltaTime Milliseconds since the last update
+	@param ages Milliseconds since each particle was created; advanced in place
+	@param initialPositions Initial position of each particle
+	@param velocities Initial velocity of each particle (meters per second)
+	@param accelerations Constant acceleration of each particle
+	@param positions Returns the new position of each particle
+	*/
+	static void integrate(size_t count,
+	                      float deltaTime,
+	                      float *ages,
+	                      const ParticleVectors &initialPositions,
+	                      const ParticleVectors &velocities,
+	                      const ParticleVectors &accelerations,
+	                      ParticleVectors &positions);
+
+	/**
+	Same as integrate, one particle at a time.  This is the fallback when
+	SSE2 is not available, and the reference the SSE2 path is tested against.
+	*/
+	static void integrateScalar(size_t count,
+	                            float deltaTime,
+	                            float *ages,
+	                            const ParticleVectors &initialPositions,
+	                            const ParticleVectors &velocities,
+	                            const ParticleVectors &accelerations,
+	                            ParticleVectors &positions);
+
+	/**
+	Evaluates the graphs of a run of particles for their current ages.
+	With SSE2, four particles are interpolated at a time; the lookup table
+	entries are still fetched one particle at a time, since each particle
+	may use a different template.
+	@param count Number of particles
+	@param templates Template of each particle, which holds its graphs
+	@param ages Milliseconds since each particle was created
+	@param lifeSpans Milliseconds that each particle will be alive for
+	@param sizeMultipliers Multiplier for the size of each particle
+	@param radii Returns the radius of each particle
+	@param reds Returns the red component of each particle
+	@param greens Returns the green component of each particle
+	@param blues Returns the blue component of each particle
+	@param alphas Returns the alpha component of each particle
+	*/
+	static void evaluate(size_t count,
+	                     const ParticleElement * const *templates,
+	                     const float *ages,
+	                     const float *lifeSpans,
+	                     const float *sizeMultipliers,
+	                     float *radii,
+	                     float *reds,
+	                     float *greens,
+	                     float *blues,
+	                     float *alphas);
+
+	/**
+	Same as evaluate, one particle at a time with ParticleElement::getValues.
+	This is the fallback when SSE2 is not available, and the reference the
+	SSE2 path is tested against.
+	*/
+	static void evaluateScalar(size_t count,
+	                           const ParticleElement * const *templates,
+	                           const float *ages,
+	                           const float *lifeSpans,
+	                           const float *sizeMultipliers,
+	                           float *radii,
+	                           float *reds,
+	                           float *greens,
+	                           float *blues,
+	                           float *alphas);
+
 private:
 	/** Destroy and free all particle elements */
 	void destroyElements(void);
+
+	/**
+	Allocates storage for the particles
+	@param maxNumberOfParticles Maximum number of live particles
+	*/
+	void allocateElements(size_t maxNumberOfParticles);
+
+	/**
+	Evaluates a particle's graphs for its current age
+	@param i Index of the particle
+	*/
+	void evaluateParticle(size_t i);
+
+	/** Evaluates the graphs of each live particle for its current age */
+	void evaluateParticles(void);
+
+	/**
+	Advances the age of each live particle and moves it along its path
+	@param deltaTime Milliseconds since the last update
+	*/
+	void integrateParticles(float deltaTime);
+
+	/**
+	Removes a particle by moving the last live particle into its slot
+	@param i Index of the particle
+	*/
+	void removeParticle(size_t i);
+
+protected:
+	/**
+	Loads one of the system's materials, along with its texture
+	@param data Data describing the material
+	@return The material
+	*/
+	virtual Material loadMaterial(PropertyBag &data);
 };
 
 } // namespace Engine
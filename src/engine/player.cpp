@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdafx.h" // Master Header
+#include <boost/bind.hpp>
 #include "gl.h"
 
 #include "player.h"
@@ -38,7 +39,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "item.h"
 #include "MenuGameOver.h"
 #include "WaitScreen.h"
-#include "CallbackInterpolator.h"
 #include "Dimmer.h"
 #include "Switch.h"
 #include "GameStateMenu.h"
@@ -155,8 +155,7 @@ void Player::OnDeath(void)
 	if(allPlayersAreDead(getZone()))
 	{
 		// Begin to fade the screen out
-		boost::function<void (void)> fn = boost::bind(&Player::enterGameOverScreen, this);
-		g_Application.addTask(  makeCallbackInterpolator(&Dimmer::alphaBlur, 0.0f, 1.0f, 2000.0f, fn)  );
+		g_Scheduler.scheduleInterpolation(&Dimmer::alphaBlur, 0.0f, 1.0f, 2000.0f, boost::bind(&Player::enterGameOverScreen, this), m_ID);
 	}
 }
 
@@ -210,6 +209,13 @@ void Player::update(float deltaTime)
 	if(!inventory.isMember(selectedItem))
 		selectedItem = INVALID_ID;
 
+	// Animation names depend upon the selected item
+	if(animationItem != selectedItem)
+	{
+		animationItem = selectedItem;
+		cacheAnimationHandles();
+	}
+
 	// Has the player tried to perform a USE action?
 	if(isAlive() && canMove() && g_Keys.isKeyDown(KEY_PLAYER_USE))
 	{
@@ -312,6 +318,7 @@ void Player::clear(void)
 
 	playerGlow=INVALID_LIGHT;
 	selectedItem = 0;
+	animationItem = 0;
 	useKeyDebounce = false;
 	playerNumber = -1;
 
@@ -495,19 +502,19 @@ const string Player::getDyingAnim(void) const
 	return string("dying") + getItemName();
 }
 
-const string Player::getWalkAnim(float speed) const
+Creature::ANIMATION_ROLE Player::getWalkRole(float speed) const
 {
 	if(speed >= topSpeed*0.9)
 	{
-		return "run";
+		return ANIM_RUN;
 	}
 	else if(speed < minWalkingVelocity)
 	{
-		return getIdleAnim();
+		return ANIM_IDLE;
 	}
 	else
 	{
-		return "walk";
+		return ANIM_WALK;
 	}
 }
 
@@ -117,11 +117,11 @@ public:
 	string getItemName(void) const;
 
 	/**
-	Gets the name of the proper walking animation
+	Gets the role of the proper walking animation
 	@param speed meters per second speed of the creature
-	@return animation name
+	@return animation role
 	*/
-	virtual const string getWalkAnim(float speed) const;
+	virtual ANIMATION_ROLE getWalkRole(float speed) const;
 
 	/**
 	Put an item in the player's inventory
@@ -225,6 +225,9 @@ protected:
 	*/
 	OBJECT_ID selectedItem;
 
+	/** The selected item for which the animation handles were resolved */
+	OBJECT_ID animationItem;
+
 	/**
 	Saves the object state to an XML data source, but only if it differs from the default value
 	@param xml The XML data source returned
@@ -2,7 +2,7 @@
 Original Author: Andrew Fox
 E-Mail: mailto:foxostro@gmail.com
 
-Copyright (c) 2007,2009 Game Creation Society
+Copyright (c) 2009 Game Creation Society
 All rights reserved.
 
 Redistribution and use in source and binary forms, with or without
@@ -28,61 +28,25 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#ifndef _QUAD_TREE_NODE_H_
-#define _QUAD_TREE_NODE_H_
 
-#include "BoundingBox.h"
+#ifndef _SIMD_H_
+#define _SIMD_H_
 
-namespace Engine {
-
-class Tile;
-
-/** A node in the quad tree */
-class QuadTreeNode
-{
-public:
-	/**
-	Constructor
-	*/
-	QuadTreeNode(Tile *grid, size_t leftColumn, size_t lowerRow, size_t numColumns, size_t totalNumColumns, float tileMetersX);
-
-	/**
-	Destructor
-	*/
-	virtual ~QuadTreeNode(void);
-
-	/**
-	Draws the node
-	@param nodeCenter The center of the node
-	*/
-	virtual void draw(const vec3 &nodeCenter) const;
-
-	/**
-	Determines whether the node is visible or not
-	@param nodeCenter The center of the node
-	@return true if the node is visible, false otherwise
-	*/
-	bool isVisible(const vec3 &nodeCenter) const;
-
-protected:
-	/**
-	Initializes the bounding box for the node
-	@param size cube size
-	*/
-	void setupBoundingBox(float size);
-
-	/** Bounding box for the node */
-	BoundingBox boundingBox;
+/*
+SSE code paths are compiled in only when the compiler targets the
+instruction set: gcc defines __SSE__ and __SSE2__ for -msse and -msse2
+(both are implied on x86-64), and MSVC sets _M_IX86_FP for /arch:SSE and
+/arch:SSE2 (also implied on x64).  Every SSE path has a scalar fallback.
+*/
 
-private:
-	QuadTreeNode *northWest;
-	QuadTreeNode *southWest;
-	QuadTreeNode *northEast;
-	QuadTreeNode *southEast;
-	Tile *tile;
-	float diameter;
-};
+#if defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(_M_X64)
+#define ENGINE_USE_SSE 1
+#include <xmmintrin.h>
+#endif
 
-} // namespace Engine
+#if defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(_M_X64)
+#define ENGINE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
 
 #endif
@@ -42,32 +42,28 @@ vec3 Project(const vec3 &p)
 	GLdouble winx = 0, winy = 0, winz = 0;
 	GLdouble objx = p.x, objy = p.y, objz = p.z;
 
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-		viewport[0] = 0;
-		viewport[1] = 0;
-		viewport[2] = 1024;
-		viewport[3] = 800;
-
-		// Use the game camera's modelview matrix
-		const mat4 &modl = g_Camera.getTransformation();
-		for(int i=0; i<16; ++i)
-		{
-			modelMat[i] = modl[i];
-		}
-
-		// Use the perspective transformation for the projection matrix
-		glMatrixMode(GL_PROJECTION);
-		glPushMatrix();
-			glLoadIdentity();
-			gluPerspective(45, 1024.0f / 768.0f, 0.01f, 5000.0f);
-			glGetDoublev(GL_PROJECTION_MATRIX, projMat);
-		glPopMatrix();
-
-		// Now project the point to window coords
-		gluProject(objx, objy, objz, modelMat, projMat, viewport, &winx, &winy, &winz);
-
-	glPopAttrib();
+	viewport[0] = 0;
+	viewport[1] = 0;
+	viewport[2] = 1024;
+	viewport[3] = 800;
+
+	// Use the game camera's modelview matrix
+	const mat4 &modl = g_Camera.getTransformation();
+	for(int i=0; i<16; ++i)
+	{
+		modelMat[i] = modl[i];
+	}
+
+	// Use the perspective transformation for the projection matrix
+	mat4 proj;
+	proj.perspective(45, 1024.0f / 768.0f, 0.01f, 5000.0f);
+	for(int i=0; i<16; ++i)
+	{
+		projMat[i] = proj[i];
+	}
+
+	// Now project the point to window coords
+	gluProject(objx, objy, objz, modelMat, projMat, viewport, &winx, &winy, &winz);
 
 	return vec3((float)winx, (float)winy, (float)winz);
 }
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h" // Master Header
 #include "gl.h"
+#include "StateCache.h"
 #include "file.h"
 #include "opengl.h"
 #include "text.h"
@@ -41,6 +42,7 @@ namespace Engine {
 TextWriter::TextWriter(void)
 {
 	fileName = "nill";
+	atlas = 0;
 
 	fontSize.insert(make_pair(FONT_SIZE_HUGE, 24.f));
 	fontSize.insert(make_pair(FONT_SIZE_LARGE, 16.f));
@@ -53,10 +55,11 @@ TextWriter::TextWriter(void)
 
 void TextWriter::release(void)
 {
-	for(int i=0; i<256; ++i)
+	if(atlas != 0)
 	{
-		glDeleteTextures(1, &characters[i].charTex);
-		characters[i].charTex = 0;
+		StateCache::forgetTexture(atlas);
+		glDeleteTextures(1, &atlas);
+		atlas = 0;
 	}
 }
 
@@ -126,14 +129,12 @@ void TextWriter::setup(PropertyBag &xml)
 	GLint width = fontWidth / 16;
 	GLint height = fontHeight / 16;
 
-	// Create a buffer
-	size_t size = width * height * bytesPerPixel;
-	unsigned char *buffer = new unsigned char[size];
-	memset(buffer, 0, size);
+	// Keep filtering from sampling the neighbouring cells
+	const float insetS = 0.5f / fontWidth;
+	const float insetT = 0.5f / fontHeight;
 
-	// Create sub textures for each character
-	glEnable(GL_TEXTURE_2D);
-	for(unsigned char c=0; c<255; ++c)
+	// Measure each character and find its cell in the atlas
+	for(int c=0; c<256; ++c)
 	{
 		int charX = c % 16;
 		int charY = 15 - (c - charX) / 16;
@@ -143,7 +144,6 @@ void TextWriter::setup(PropertyBag &xml)
 		int imgLeft=width;
 		int imgRight=0;
 
-		// Copy the character into the smaller buffer
 		for(int row=0; row<height; ++row)
 		{
 			size_t font_row = row + y;
@@ -151,19 +151,13 @@ void TextWriter::setup(PropertyBag &xml)
 			size_t x_offset = x * bytesPerPixel;
 			size_t font_idx = font_row * font_rowLength + x_offset;
 
-			size_t char_row = row;
-			size_t char_rowLength = width * bytesPerPixel;
-			size_t char_idx = char_row * char_rowLength;
-
-			memcpy(buffer + char_idx, font + font_idx, char_rowLength);
-
 			const int threshold = 96;
 
 			int left=0;
-			while(left < width && buffer[char_idx + left*bytesPerPixel + 3] < threshold) ++left;
+			while(left < width && font[font_idx + left*bytesPerPixel + 3] < threshold) ++left;
 
 			int right=width-1;
-			while(right >= 0 && buffer[char_idx + right*bytesPerPixel + 3] < threshold) --right;
+			while(right >= 0 && font[font_idx + right*bytesPerPixel + 3] < threshold) --right;
 
 			imgLeft = min(imgLeft, left);
 			imgRight = max(imgRight, right);
@@ -180,33 +174,39 @@ void TextWriter::setup(PropertyBag &xml)
 			characters[c].left = imgLeft / (float)width;
 		}
 
-		// Create a new texture object
-		characters[c].charTex=0;
-		glGenTextures(1, &characters[c].charTex);
+		characters[c].s0 = x / (float)fontWidth + insetS;
+		characters[c].t0 = y / (float)fontHeight + insetT;
+		characters[c].s1 = (x + width) / (float)fontWidth - insetS;
+		characters[c].t1 = (y + height) / (float)fontHeight - insetT;
+	}
 
-		// and bind it as the present texture
-		glBindTexture(GL_TEXTURE_2D, characters[c].charTex);
+	// Stop mipmapping before the cells blur into one another
+	int maxLevel = 0;
+	while((min(width, height) >> (maxLevel+1)) >= 4) ++maxLevel;
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+	release();
 
-		// Now build mipmaps from the texture data
-		gluBuild2DMipmaps(GL_TEXTURE_2D,
-				  bytesPerPixel,
-				  width,
-				  height,
-				  alpha ? GL_RGBA : GL_RGB,
-				  GL_UNSIGNED_BYTE,
-				  buffer);
+	// Create the atlas texture from the whole font image
+	glGenTextures(1, &atlas);
+	g_StateCache.enable(GL_TEXTURE_2D);
+	g_StateCache.bindTexture(atlas);
 
-		CHECK_GL_ERROR();
-	} // loop
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
 
-	// Delete the buffer
-	delete[] buffer;
-	buffer=0;
+	// Now build mipmaps from the texture data
+	gluBuild2DMipmaps(GL_TEXTURE_2D,
+			  bytesPerPixel,
+			  fontWidth,
+			  fontHeight,
+			  alpha ? GL_RGBA : GL_RGB,
+			  GL_UNSIGNED_BYTE,
+			  font);
+
+	CHECK_GL_ERROR();
 
 	TRACE(string("Created font: ") + fontImageFileName);
 }
@@ -237,20 +237,67 @@ const TextWriter::Character& TextWriter::getCharacter(wchar_t z) const
 	return characters[  (size_t)((z < 128) ? z : '?')  ];
 }
 
-void TextWriter::drawChar(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d, char z, const COLOR &color) const
+void TextWriter::putChar(TextGeometry &geometry, vec3 &offset, char character, const vec3 &right, const vec3 &up, float w, float h, bool useBillboard) const
 {
-	glBindTexture(GL_TEXTURE_2D, getCharacter(z).charTex);
-	glColor4fv(color);
-
-	glBegin(GL_QUADS);
-		glTexCoord2f(0.0f, 0.0f); glVertex3f(a.x, a.y, a.z);
-		glTexCoord2f(1.0f, 0.0f); glVertex3f(b.x, b.y, b.z);
-		glTexCoord2f(1.0f, 1.0f); glVertex3f(c.x, c.y, c.z);
-		glTexCoord2f(0.0f, 1.0f); glVertex3f(d.x, d.y, d.z);
-	glEnd();
+	if(character == '\n')
+	{
+		if(useBillboard)
+		{
+			offset = up*(h*lineHeight); // FIXME: this only allows 2 lines of text
+		}
+		else
+		{
+			offset.x = 0;
+			offset.y = offset.y - h*lineHeight;
+		}
+
+		return;
+	}
+
+	const Character &glyph = getCharacter(character);
+
+	/*               center the quad          place it      shift left by an offset  */
+	const vec3 a = -right*(w*0.5f)        + offset - right*w*glyph.left;
+	const vec3 b =  right*(w*0.5f)        + offset - right*w*glyph.left;
+	const vec3 c =  right*(w*0.5f) + up*h + offset - right*w*glyph.left;
+	const vec3 d = -right*(w*0.5f) + up*h + offset - right*w*glyph.left;
+
+	const vec3 corners[4] = { a, b, c, d };
+	const float texCoords[8] = { glyph.s0, glyph.t0,
+	                             glyph.s1, glyph.t0,
+	                             glyph.s1, glyph.t1,
+	                             glyph.s0, glyph.t1 };
+
+	for(int i=0; i<4; ++i)
+	{
+		geometry.vertices.push_back(corners[i].x);
+		geometry.vertices.push_back(corners[i].y);
+		geometry.vertices.push_back(corners[i].z);
+	}
+
+	geometry.texCoords.insert(geometry.texCoords.end(), texCoords, texCoords + 8);
+
+	float offsetRight = w*glyph.width + w*0.1f; // TODO: plus some spacing between characters
+
+	offset = offset + right*offsetRight;
+}
+
+void TextWriter::disableMultiTex(void)
+{
+	// Disable all extra texture units
+	if(g_bUseMultitexture)
+	{
+		for(int textureUnit=1; textureUnit<g_MultitextureUnits; ++textureUnit)
+		{
+			g_StateCache.activeTexture(textureStages[textureUnit]);
+			g_StateCache.disable(GL_TEXTURE_2D);
+		}
+		g_StateCache.activeTexture(GL_TEXTURE0_ARB);
+	}
+	g_StateCache.enable(GL_TEXTURE_2D);
 }
 
-void TextWriter::putChar(vec3 *offset, char character, const COLOR *color, FONT_SIZE size, bool useBillboard) const
+void TextWriter::build(TextGeometry &geometry, const string &text, FONT_SIZE size, bool useBillboard) const
 {
 	const float _size = fontSize.find(size)->second;
 
@@ -258,7 +305,6 @@ void TextWriter::putChar(vec3 *offset, char character, const COLOR *color, FONT_
 	float h = 0.0f;
 	vec3 right;
 	vec3 up;
-	vec3 nextOffset;
 
 	if(useBillboard)
 	{
@@ -277,77 +323,64 @@ void TextWriter::putChar(vec3 *offset, char character, const COLOR *color, FONT_
 		up = vec3(0, 1, 0);
 	}
 
-	if(character == '\n')
-	{
-		if(useBillboard)
-		{
-			nextOffset = up*(h*lineHeight); // FIXME: this only allows 2 lines of text
-		}
-		else
-		{
-			nextOffset.x = 0;
-			nextOffset.y = (*offset).y - h*lineHeight;
-		}
-	}
-	else
-	{
-		/*               center the quad          place it        shift left by an offset  */
-		const vec3 a = -right*(w*0.5f)        + (*offset) - right*w*getCharacter(character).left;
-		const vec3 b =  right*(w*0.5f)        + (*offset) - right*w*getCharacter(character).left;
-		const vec3 c =  right*(w*0.5f) + up*h + (*offset) - right*w*getCharacter(character).left;
-		const vec3 d = -right*(w*0.5f) + up*h + (*offset) - right*w*getCharacter(character).left;
-
-		drawChar(a, b, c, d, character, *color);
-
-		float offsetRight = w*getCharacter(character).width + w*0.1f; // TODO: plus some spacing between characters
-
-		nextOffset = (*offset) + right*offsetRight;
-	}
-
-	(*offset) = nextOffset;
-}
+	geometry.clear();
+	geometry.vertices.reserve(text.size() * 12);
+	geometry.texCoords.reserve(text.size() * 8);
 
-void TextWriter::disableMultiTex(void)
-{
-	// Disable all extra texture units
-	if(g_bUseMultitexture)
+	vec3 offset;
+	for(string::const_iterator i = text.begin(); i != text.end(); ++i)
 	{
-		for(int textureUnit=1; textureUnit<g_MultitextureUnits; ++textureUnit)
-		{
-			glActiveTextureARB(textureStages[textureUnit]);
-			glDisable(GL_TEXTURE_2D);
-		}
-		glActiveTextureARB(GL_TEXTURE0_ARB);
+		putChar(geometry, offset, *i, right, up, w, h, useBillboard);
 	}
-	glEnable(GL_TEXTURE_2D);
 }
 
-void TextWriter::write(const string &text, const COLOR &color, FONT_SIZE size, bool useBillboard) const
+void TextWriter::draw(const TextGeometry &geometry, const COLOR &color) const
 {
+	if(geometry.empty())
+		return;
+
 	CHECK_GL_ERROR();
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
 		disableMultiTex();
 
-		glDisable(GL_CULL_FACE);
-		glDisable(GL_LIGHTING);
-		glDisable(GL_COLOR_MATERIAL);
+		g_StateCache.disable(GL_CULL_FACE);
+		g_StateCache.disable(GL_LIGHTING);
+		g_StateCache.disable(GL_COLOR_MATERIAL);
 
-		glEnable(GL_ALPHA_TEST);
-		glAlphaFunc(GL_GREATER, 0.1f);
+		g_StateCache.enable(GL_ALPHA_TEST);
+		g_StateCache.alphaFunc(GL_GREATER, 0.1f);
 
 		// Enable blending, to smooth the characters' edges and show through to the background
-		glBlendFunc(GL_SRC_ALPHA,GL_ONE);
-		glEnable(GL_BLEND);
+		g_StateCache.blendFunc(GL_SRC_ALPHA,GL_ONE);
+		g_StateCache.enable(GL_BLEND);
+
+		g_StateCache.bindTexture(atlas);
+
+		// Send the whole string at once
+		g_StateCache.disableClientState(GL_NORMAL_ARRAY);
+		g_StateCache.disableClientState(GL_COLOR_ARRAY);
+		g_StateCache.enableClientState(GL_VERTEX_ARRAY);
+		g_StateCache.clientActiveTexture(GL_TEXTURE0_ARB);
+		g_StateCache.enableClientState(GL_TEXTURE_COORD_ARRAY);
+
+		glVertexPointer(3, GL_FLOAT, 0, &geometry.vertices[0]);
+		glTexCoordPointer(2, GL_FLOAT, 0, &geometry.texCoords[0]);
 
-		// Write out the string
-		vec3 offset;
-		for_each(text.begin(), text.end(), bind(&TextWriter::putChar, this, &offset, _1, &color, size, useBillboard));
+		glColor4fv(color);
+		glDrawArrays(GL_QUADS, 0, (GLsizei)geometry.getNumVertices());
+		glColor4fv(white);
 
-	glPopAttrib();
+	g_StateCache.pop();
 	CHECK_GL_ERROR();
 }
 
+void TextWriter::write(const string &text, const COLOR &color, FONT_SIZE size, bool useBillboard) const
+{
+	build(scratch, text, size, useBillboard);
+	draw(scratch, color);
+}
+
 vec2 TextWriter::getDimensions(const string &text, FONT_SIZE size) const
 {
 	float row_width=0;
@@ -48,7 +48,49 @@ enum FONT_SIZE
 };
 
 /**
-Manages a single font and can print strings to the screen with this font
+Vertex arrays for a string laid out in some font.
+The geometry stays valid for as long as the string, font, and size are
+unchanged, so static strings may keep it from frame to frame.
+*/
+class TextGeometry
+{
+public:
+	/** Quad corners, three floats per vertex */
+	vector<float> vertices;
+
+	/** Atlas coordinates, two floats per vertex */
+	vector<float> texCoords;
+
+	/** Removes all geometry */
+	inline void clear(void)
+	{
+		vertices.clear();
+		texCoords.clear();
+	}
+
+	/**
+	Determines whether there is anything to draw
+	@return true if there is no geometry
+	*/
+	inline bool empty(void) const
+	{
+		return vertices.empty();
+	}
+
+	/**
+	Gets the number of vertices in the geometry
+	@return vertex count
+	*/
+	inline size_t getNumVertices(void) const
+	{
+		return vertices.size() / 3;
+	}
+};
+
+/**
+Manages a single font and can print strings to the screen with this font.
+All characters live in a single atlas texture, and each string is drawn
+with a single vertex array.
 */
 class TextWriter
 {
@@ -66,13 +108,23 @@ private:
 		/** Clears out the character data */
 		void clear(void)
 		{
-			charTex = 0;
+			s0 = t0 = 0.0f;
+			s1 = t1 = 1.0f;
 			width = 1.0f;
 			left = 0.0f;
 		}
 
-		/** The texture handle of the character */
-		GLuint charTex;
+		/** Atlas coordinate of the left edge of the character's cell */
+		float s0;
+
+		/** Atlas coordinate of the bottom edge of the character's cell */
+		float t0;
+
+		/** Atlas coordinate of the right edge of the character's cell */
+		float s1;
+
+		/** Atlas coordinate of the top edge of the character's cell */
+		float t1;
 
 		/** Width of the character from the leftmost edge of the glyph to the rightmost edge (0.0 to 1.0, a portion of the Quad Width) */
 		float width;
@@ -87,6 +139,12 @@ private:
 	/** Characters in the font */
 	Character characters[256];
 
+	/** Texture holding every character in the font */
+	GLuint atlas;
+
+	/** Geometry of the string being written by write */
+	mutable TextGeometry scratch;
+
 	/** Height of a line (as a portion of the Quad Height) */
 	float lineHeight;
 
@@ -97,26 +155,17 @@ private:
 	static void disableMultiTex(void);
 
 	/**
-	Prints a single character to the screen
-	@param a Corner of the character's quad
-	@param b Corner of the character's quad
-	@param c Corner of the character's quad
-	@param d Corner of the character's quad
-	@param z The character to print out
-	@param color The color of the text
-	@param size The size of the text
-	*/
-	void drawChar(const vec3 &a, const vec3 &b, const vec3 &c, const vec3 &d, char z, const COLOR &color) const;
-
-	/**
-	Prints a single character to the screen and advances the cursor
+	Adds a single character to the geometry and advances the cursor
+	@param geometry Receives the character's quad
 	@param offset The position of the chracter on the screen.  Returns the position of the next character.
-	@param character The character to print out
-	@param color The coor of the text
-	@param size The size of the text
+	@param character The character to add
+	@param right Direction of the text
+	@param up Direction of the next line of text
+	@param w Width of the character's quad
+	@param h Height of the character's quad
 	@param useBillboard Should use a billboard when displaying
 	*/
-	void putChar(vec3 *offset, char character, const COLOR *color, FONT_SIZE size, bool useBillboard) const;
+	void putChar(TextGeometry &geometry, vec3 &offset, char character, const vec3 &right, const vec3 &up, float w, float h, bool useBillboard) const;
 
 	/**
 	Gets character information
@@ -180,6 +229,23 @@ public:
 	*/
 	void write(const string &text, const COLOR &color, FONT_SIZE size, bool useBillboard=false) const;
 
+	/**
+	Lays out a string, without drawing it.
+	Billboarded geometry faces the camera as it was when built.
+	@param geometry Receives the geometry of the string
+	@param text The text to lay out
+	@param size The size of the text
+	@param useBillboard Should use a billboard when displaying
+	*/
+	void build(TextGeometry &geometry, const string &text, FONT_SIZE size, bool useBillboard=false) const;
+
+	/**
+	Draws a string laid out by build
+	@param geometry The geometry of the string
+	@param color The color of the text
+	*/
+	void draw(const TextGeometry &geometry, const COLOR &color) const;
+
 	/**
 	Gets the dimensions of the given string
 	@param text text
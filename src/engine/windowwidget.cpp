@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "Application.h"
 #include "world.h"
 #include "SDLwindow.h"
@@ -95,7 +96,7 @@ WindowWidget::~WindowWidget(void)
 void WindowWidget::draw(void) const
 {
 	glColor4fv(white);
-	glEnable(GL_TEXTURE_2D);
+	g_StateCache.enable(GL_TEXTURE_2D);
 	getMaterial().bind();
 
 	if(stretchToFit)
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "gl.h"
+#include "StateCache.h"
 #include "profile.h"
 #include "searchfile.h"
 
@@ -40,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Dimmer.h"
 #include "EffectSig.h"
 #include "EffectManager.h"
+#include "Effect_Receive_Shadows.h"
 
 #include "world.h"
 
@@ -113,7 +115,9 @@ void World::clear()
 	objects.clear();
 	lightManager.clear();
 	shadowManager.clear();
+	regions.clear();
 	worldMap.clear();
+	visibleSet.clear();
 
 	name = "nill";
 	clockTicks=0.0f;
@@ -126,6 +130,7 @@ void World::destroy(void)
 {
 	TRACE("Destroying World...");
 
+	visibleSet.clear();
 	worldMap.destroy();
 	TRACE("...destroyed worldMap...");
 
@@ -135,6 +140,16 @@ void World::destroy(void)
 	shadowManager.destroy();
 	TRACE("...destroyed shadowManager...");
 
+	regions.clear();
+	TRACE("...destroyed regions...");
+
+	// Callbacks and interpolations owned by these actors must not outlive them
+	for(ActorSet::const_iterator i=objects.begin(); i!=objects.end(); ++i)
+	{
+		g_Scheduler.cancelAll(i->first);
+	}
+	TRACE("...cancelled scheduled callbacks...");
+
 	objects.destroy();
 	TRACE("...destroyed objects...");
 
@@ -220,6 +235,9 @@ void World::load(const PropertyBag &bag)
 		worldMap.create(mapBag);
 	}
 
+	// Lay the trigger region grid over the map
+	regions.create(worldMap);
+
 	// Initialize the lighting system
 	lightManager.create();
 	shadowManager.create();
@@ -268,11 +286,11 @@ void World::drawEditorScene(void) const
 CHECK_GL_ERROR();
 
 	g_Camera.setCamera();
+	gatherVisibleSet();
 
 	// draw the scene geometry
 	effect_Begin(effect_TEXTURE_REPLACE);
-		worldMap.draw();
-		objects.draw(g_Camera.getFrustum());
+		drawShadowReceivers();
 	effect_End();
 
 CHECK_GL_ERROR();
@@ -283,15 +301,14 @@ void World::drawShadowlessScene(bool useLights) const
 CHECK_GL_ERROR();
 
 	g_Camera.setCamera();
+	gatherVisibleSet();
 
 	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, white*lightManager.ambientLight*Light::BRIGHTNESS); // scene ambient light
-	lightManager.bindAll();
 	fog.activate();
 
 	// draw the scene geometry
 	effect_Begin(useLights ? effect_TEXTURE_LIT : effect_TEXTURE_REPLACE);
-		worldMap.draw();
-		objects.draw(g_Camera.getFrustum());
+		drawShadowReceivers(useLights);
 	effect_End();
 
 	// particles last
@@ -310,9 +327,10 @@ CHECK_GL_ERROR();
 	2) In areas that are definitely not affected by shadows, draw with full lighting
 	3) In areas that might be affected by shadows:
 		4) Draw with ambient light
-		5) Draw with full lighting, but fail fragments that are in shadow
-			* Alphatest
-			* Shadowmap projection to achieve the failing alpha values
+		5) For each shadow, mark the fragments that are in shadow in the stencil buffer
+			* Clip to the shadow's frustum so only its tile of the atlas is sampled
+			* Shadowmap projection and alphatest to find the shadowed fragments
+		6) Draw with full lighting where no shadow was marked
 	*/
 
 	// set the ambient light
@@ -323,12 +341,15 @@ CHECK_GL_ERROR();
 	// set the camera
 	g_Camera.setCamera();
 
+	// cull once, and replay the visible set in every pass below
+	gatherVisibleSet();
+
 
 	// Draw areas that might be affected shadows into the stencil buffer
 	effect_Begin(effect_RED);
-		glPushAttrib(GL_ENABLE_BIT);
-			glDisable(GL_LIGHTING);
-			glEnable(GL_STENCIL_TEST);
+		g_StateCache.push();
+			g_StateCache.disable(GL_LIGHTING);
+			g_StateCache.enable(GL_STENCIL_TEST);
 			glStencilFunc(GL_ALWAYS, 1, 0xFFFF);
 			glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
 
@@ -338,10 +359,11 @@ CHECK_GL_ERROR();
 				if(s.isInUse())
 				{
 					s.getFrustum().beginClipping();
-					drawShadowReceivers();
+					visibleSet.submit(renderQueue, s.getFrustum());
+					renderQueue.flush();
 				}
 			}
-		glPopAttrib();
+		g_StateCache.pop();
 	effect_End();
 	glClear(GL_DEPTH_BUFFER_BIT);
 
@@ -349,18 +371,17 @@ CHECK_GL_ERROR();
 
 
 	// draw the scene with shadows
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	g_StateCache.push();
 
 		// for the following steps, we need to enable the stencil test but refrain from modifying the stencil itself
-		glEnable(GL_STENCIL_TEST);
+		g_StateCache.enable(GL_STENCIL_TEST);
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
 		glStencilFunc(GL_NOTEQUAL, 1, 0xFFFF); // only where shadows are garaunteed to not be cast
 
 				// draw areas of the scene unaffected by shadows
 				effect_Begin(effect_TEXTURE_LIT);
-					lightManager.bindAll();
-					drawShadowReceivers();
+					drawShadowReceivers(true);
 				effect_End();
 
 		glStencilFunc(GL_EQUAL, 1, 0xFFFF); // only where shadows might be cast
@@ -378,26 +399,39 @@ CHECK_GL_ERROR();
 					drawShadowReceivers();
 				effect_End();
 
-				// draw the shadowed portions of the map
+				// mark the shadowed fragments, one shadow at a time
 				effect_Begin(effect_CLASS_RECEIVE_SHADOWS);
 
-					lightManager.bindAll(); // full lighting
+					g_StateCache.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+					g_StateCache.depthMask(GL_FALSE);
+
+					// keep the fragments that fail Effect_Receive_Shadows' usual test
+					g_StateCache.alphaFunc(GL_LESS, Effect_Receive_Shadows::ALPHA_THRESHOLD);
+
+					// 1 -> 2 where in shadow, and each fragment is marked only once
+					glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
 
-					// bind all shadows that are in use
-					unsigned int tex=1;
 					for(unsigned int i=0; i<shadowManager.getMaxShadows(); ++i)
 					{
 						const Shadow &s = shadowManager.getShadow(i);
-						if(s.isInUse())
+						if(s.isInUse() && s.bind(getObjects(), 1))
 						{
-							s.bind(getObjects(), tex++);
+							s.getFrustum().beginClipping();
+							visibleSet.submit(renderQueue, s.getFrustum());
+							renderQueue.flush();
 						}
 					}
 
-					drawShadowReceivers();
+				effect_End();
 
+				// draw the unshadowed portions with full lighting
+				effect_Begin(effect_TEXTURE_LIT);
+					drawShadowReceivers(true);
 				effect_End();
-	glPopAttrib();
+
+		glStencilFunc(GL_ALWAYS, 0, 0xFFFF);
+		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+	g_StateCache.pop();
 
 	if(g_Application.displayDebugData)
 	{
@@ -411,10 +445,15 @@ CHECK_GL_ERROR();
 CHECK_GL_ERROR();
 }
 
-void World::drawShadowReceivers(void) const
+void World::gatherVisibleSet(void) const
+{
+	visibleSet.gather(g_Camera.getFrustum(), worldMap, objects, lightManager);
+}
+
+void World::drawShadowReceivers(bool useLights) const
 {
-	worldMap.draw();
-	objects.draw(g_Camera.getFrustum());
+	visibleSet.submit(renderQueue);
+	renderQueue.flush(useLights ? &lightManager : 0);
 }
 
 void World::drawParticles(void) const
@@ -424,6 +463,8 @@ void World::drawParticles(void) const
 	{
 		effect_Begin(effect_PARTICLE_FX);
 
+		particleRenderer.begin(g_Camera.getOrientation());
+
 		for(map<size_t, ParticleSystem*>::const_iterator iter=particles.begin();
 		    iter!=particles.end();
 		    ++iter)
@@ -434,10 +475,12 @@ void World::drawParticles(void) const
 
 			if(!system->isDead())
 			{
-				system->draw();
+				system->draw(particleRenderer);
 			}
 		}
 
+		particleRenderer.flush();
+
 		effect_End();
 	}
 }
@@ -483,8 +526,17 @@ void World::update(float deltaTime)
 
 	clockTicks += double(deltaTime); // Update the game clock
 
+	// Actors resting on tiles that changed must settle onto them again
+	float minX, minZ, maxX, maxZ;
+	if(worldMap.takeChangedBlock(minX, minZ, maxX, maxZ))
+	{
+		objects.wakeWithin(minX, minZ, maxX, maxZ);
+	}
+
 	objects.update(deltaTime, this);
 
+	regions.update(objects);
+
 	router.update(deltaTime);
 
 	lightManager.update(deltaTime);
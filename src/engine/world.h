@@ -40,8 +40,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "particle.h"
 #include "LightManager.h"
 #include "ShadowManager.h"
+#include "RegionManager.h"
 #include "MusicEngine.h"
 #include "Map.h"
+#include "VisibleSet.h"
+#include "RenderQueue.h"
+#include "ParticleRenderer.h"
 #include "fog.h"
 
 
@@ -226,6 +230,33 @@ public:
 		return lightManager;
 	}
 
+	/**
+	Gets the trigger regions
+	@return the region manager
+	*/
+	inline RegionManager& getRegions(void)
+	{
+		return regions;
+	}
+
+	/**
+	Gets the trigger regions
+	@return the region manager
+	*/
+	inline const RegionManager& getRegions(void) const
+	{
+		return regions;
+	}
+
+	/**
+	Gets the map chunks and actors that were visible in the last frame
+	@return the visible set
+	*/
+	inline const VisibleSet& getVisibleSet(void) const
+	{
+		return visibleSet;
+	}
+
 	/**
 	Gets the number of players less than the maximum that are actually in use
 	@return number of players
@@ -328,11 +359,16 @@ private:
 	/** Draws the scene with shadows */
 	void drawScene(void) const;
 
+	/** Culls the map and the actors against the camera for this frame */
+	void gatherVisibleSet(void) const;
+
 	/**
 	Draws the shadow receiving geometry of the scene.
 	Assumes that appropriate states are already setup for the operation.
+	@param useLights true to light each chunk and actor with its own lights,
+	false to leave the lights as the pass set them
 	*/
-	void drawShadowReceivers(void) const;
+	void drawShadowReceivers(bool useLights = false) const;
 
 	/**
 	Update the shadows
@@ -372,6 +408,9 @@ private:
 	/** All shadows in the World */
 	ShadowManager shadowManager;
 
+	/** Regions of the Triggers in the World */
+	RegionManager regions;
+
 	/** Manages fog settings */
 	Fog fog;
 
@@ -381,6 +420,15 @@ private:
 	/** Brick and Mortar walls of the World */
 	Map worldMap;
 
+	/** Map chunks and actors within the camera frustum this frame */
+	mutable VisibleSet visibleSet;
+
+	/** Sorts the draws of each pass of the scene */
+	mutable RenderQueue renderQueue;
+
+	/** Batches the billboards of every particle system in the realm */
+	mutable ParticleRenderer particleRenderer;
+
 	/** Storage for all possible players */
 	Player *player[MAX_PLAYERS];
 
@@ -0,0 +1,129 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+Times frames of World1, the first zone of the game, with the blur effect
+off and then on.  With the blur on, the effect is restarted every frame so
+that every frame pays for a capture as well as the overlay, which is the
+worst case.  Each frame is finished with glFinish and timed by the wall
+clock, so the time spent on the GPU is counted too.
+
+The application is started as the game starts it, splash screen and all,
+so a window opens and the configuration in the data directory is used.
+
+usage: blur_bench [data directory]
+The data directory defaults to redist/share/arbarlith2, relative to the top
+of the source tree.
+*/
+
+#include "engine/stdafx.h"
+#include "engine/file.h"
+#include "engine/gl.h"
+#include "engine/Application.h"
+#include "engine/GameStateRun.h"
+#include "engine/animation.h"
+
+#include <SDL/SDL.h>
+
+using namespace Engine;
+
+namespace {
+
+const int NUM_WARMUP_FRAMES = 60;
+const int NUM_FRAMES = 600;
+const float FRAME = 1000.0f / 60.0f; // milliseconds
+
+/**
+Runs the game state for a while
+@param blur true to capture and draw the blur on every frame
+@return average milliseconds per frame
+*/
+double run(bool blur)
+{
+	GameStateRun &state = GameStateRun::GetSingleton();
+
+	g_pApplication->useBlurEffects = blur;
+
+	unsigned int start = 0;
+
+	for(int frame = 0; frame < NUM_WARMUP_FRAMES + NUM_FRAMES; ++frame)
+	{
+		if(frame == NUM_WARMUP_FRAMES)
+		{
+			glFinish();
+			start = (unsigned int)SDL_GetTicks();
+		}
+
+		AnimationSequence::beginFrame();
+
+		if(blur)
+		{
+			state.startBlurEffect(1000.0f, COLOR(1.0f, 1.0f, 1.0f, 0.5f));
+		}
+
+		state.update(FRAME);
+		g_Scheduler.update(FRAME);
+		glFinish();
+	}
+
+	const double milliseconds = (double)((unsigned int)SDL_GetTicks() - start) / NUM_FRAMES;
+
+	printf("blur %-3s: %.2f ms per frame\n", blur ? "on" : "off", milliseconds);
+
+	return milliseconds;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const string dataDirectory = (argc > 1) ? argv[1] : "redist/share/arbarlith2";
+
+	if(!setWorkingDirectory(dataDirectory))
+	{
+		printf("could not change to the data directory %s\n", dataDirectory.c_str());
+		return EXIT_FAILURE;
+	}
+
+	// The application changes to the share directory itself as it starts
+	setenv("ARBARLITH2_SHARE", ".", 1);
+
+	g_pApplication = new Application();
+	g_pApplication->start();
+	g_pApplication->enterWorld(0);
+
+	const double off = run(false);
+	const double on = run(true);
+
+	printf("the blur costs %.2f ms per frame\n", on - off);
+
+	return EXIT_SUCCESS;
+}
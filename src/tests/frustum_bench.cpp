@@ -0,0 +1,187 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+Times Frustum::cull over batches of 10,000 spheres and 10,000 boxes
+scattered around the camera, and checks the results against testing each
+volume on its own.  Build once with SSE and once without (for example with
+-U__SSE__ -U__SSE2__ on frustum.cpp) to compare the two code paths.
+*/
+
+#include "engine/stdafx.h"
+#include "engine/frustum.h"
+#include "engine/CullingBatch.h"
+#include "engine/simd.h"
+
+#include <ctime>
+
+using namespace Engine;
+
+namespace {
+
+const int NUM_OBJECTS = 10000;
+const int NUM_ITERATIONS = 2000;
+
+float random(float low, float high)
+{
+	return low + (high - low) * (float)rand() / (float)RAND_MAX;
+}
+
+/**
+Reference test of a box against the frustum, one corner at a time
+@return true unless all of the box's corners lie behind one plane
+*/
+bool boxInFrustum(const Frustum &frustum, const vec3 &boxMin, const vec3 &boxMax)
+{
+	for(int side = 0; side < 6; ++side)
+	{
+		const vec4 p = frustum.getPlane((FrustumSide)side);
+
+		const float x = (p.x >= 0.0f) ? boxMax.x : boxMin.x;
+		const float y = (p.y >= 0.0f) ? boxMax.y : boxMin.y;
+		const float z = (p.z >= 0.0f) ? boxMax.z : boxMin.z;
+
+		if(p.x*x + p.y*y + p.z*z + p.w < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+double millisecondsSince(clock_t start)
+{
+	return double(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+} // namespace
+
+int main(int, char**)
+{
+#ifdef ENGINE_USE_SSE
+	printf("Frustum::cull is using SSE\n");
+#else
+	printf("Frustum::cull is using the scalar loop\n");
+#endif
+
+	mat4 view, projection;
+	view.lookAt(vec3(0,20,0), vec3(30,0,40), vec3(0,1,0));
+	projection.perspective(45.0f, 4.0f/3.0f, 0.1f, 100.0f);
+
+	Frustum frustum;
+	frustum.CalculateFrustum(view, projection);
+
+	srand(1);
+
+	vector<vec3> centers, extents;
+	vector<float> radii;
+	SphereBatch spheres;
+	BoxBatch boxes;
+
+	for(int i=0; i<NUM_OBJECTS; ++i)
+	{
+		const vec3 center(random(-120, 120), random(-10, 10), random(-120, 120));
+		const vec3 extent(random(0.5f, 4), random(0.5f, 4), random(0.5f, 4));
+		const float radius = random(0.5f, 4);
+
+		centers.push_back(center);
+		extents.push_back(extent);
+		radii.push_back(radius);
+	}
+
+	for(int i=0; i<NUM_OBJECTS; ++i)
+	{
+		spheres.add(centers[i], radii[i]);
+		boxes.add(centers[i] - extents[i], centers[i] + extents[i]);
+	}
+
+	/*
+	Check the batched tests against testing each volume on its own, first
+	with an empty plane coherency cache and then with the cache filled in
+	by the first pass.
+	*/
+	int mismatches = 0, numVisible = 0;
+
+	for(int pass=0; pass<2; ++pass)
+	{
+		frustum.cull(spheres);
+		frustum.cull(boxes);
+
+		numVisible = 0;
+
+		for(int i=0; i<NUM_OBJECTS; ++i)
+		{
+			const bool sphere = frustum.SphereInFrustum2(centers[i], radii[i]);
+			const bool box = boxInFrustum(frustum, centers[i] - extents[i], centers[i] + extents[i]);
+
+			if(spheres.isVisible(i) != sphere) mismatches++;
+			if(boxes.isVisible(i) != box) mismatches++;
+			if(sphere) numVisible++;
+		}
+	}
+
+	printf("%d of %d spheres visible, %d mismatches against the per-object tests over two passes\n",
+	       numVisible, NUM_OBJECTS, mismatches);
+
+	// Time the per-object test, then the batches
+	clock_t start = clock();
+	int count = 0;
+	for(int n=0; n<NUM_ITERATIONS; ++n)
+	{
+		for(int i=0; i<NUM_OBJECTS; ++i)
+		{
+			count += frustum.SphereInFrustum2(centers[i], radii[i]) ? 1 : 0;
+		}
+	}
+	const double perObject = millisecondsSince(start);
+
+	start = clock();
+	for(int n=0; n<NUM_ITERATIONS; ++n)
+	{
+		frustum.cull(spheres);
+		count += spheres.isVisible(n % NUM_OBJECTS) ? 1 : 0;
+	}
+	const double sphereBatch = millisecondsSince(start);
+
+	start = clock();
+	for(int n=0; n<NUM_ITERATIONS; ++n)
+	{
+		frustum.cull(boxes);
+		count += boxes.isVisible(n % NUM_OBJECTS) ? 1 : 0;
+	}
+	const double boxBatch = millisecondsSince(start);
+
+	printf("SphereInFrustum2, one at a time: %.1f us per 10k\n", perObject * 1000.0 / NUM_ITERATIONS);
+	printf("cull(SphereBatch):               %.1f us per 10k\n", sphereBatch * 1000.0 / NUM_ITERATIONS);
+	printf("cull(BoxBatch):                  %.1f us per 10k\n", boxBatch * 1000.0 / NUM_ITERATIONS);
+	printf("(%d)\n", count); // keeps the loops from being optimized away
+
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,275 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+Checks the matrix builders against reference matrices that were worked out
+by hand from the formulas in the GLU and OpenGL specifications for
+gluLookAt, gluPerspective, glOrtho, and glRotate.  Matrices are given in
+column-major order, as OpenGL expects them.
+*/
+
+#include "engine/stdafx.h"
+#include "engine/mat4.h"
+
+using namespace Engine;
+
+namespace {
+
+int numFailures = 0;
+
+void expectMatrix(const char *name, const mat4 &actual, const float expected[16])
+{
+	const float tolerance = 1e-5f;
+
+	for(int i=0; i<16; ++i)
+	{
+		if(fabsf(actual.m[i] - expected[i]) > tolerance)
+		{
+			printf("FAIL %s: m[%d] is %f, expected %f\n", name, i, actual.m[i], expected[i]);
+			numFailures++;
+			return;
+		}
+	}
+
+	printf("ok   %s\n", name);
+}
+
+void expectTrue(const char *name, bool condition)
+{
+	if(!condition)
+	{
+		printf("FAIL %s\n", name);
+		numFailures++;
+		return;
+	}
+
+	printf("ok   %s\n", name);
+}
+
+void testLookAt(void)
+{
+	// Looking down -Z from (0,0,5): the view is a translation by -5 along Z
+	{
+		const float expected[16] =
+		{
+			1, 0, 0, 0,
+			0, 1, 0, 0,
+			0, 0, 1, 0,
+			0, 0,-5, 1
+		};
+
+		mat4 m;
+		m.lookAt(vec3(0,0,5), vec3(0,0,0), vec3(0,1,0));
+		expectMatrix("lookAt down -Z", m, expected);
+	}
+
+	/*
+	Looking down -X from (3,0,0):
+	f = (-1,0,0), s = f x up = (0,0,-1), u = s x f = (0,1,0)
+	The rows of the rotation are s, u, and -f; the translation is (-s.eye, -u.eye, f.eye)
+	*/
+	{
+		const float expected[16] =
+		{
+			 0, 0, 1, 0,
+			 0, 1, 0, 0,
+			-1, 0, 0, 0,
+			 0, 0,-3, 1
+		};
+
+		mat4 m;
+		m.lookAt(vec3(3,0,0), vec3(0,0,0), vec3(0,1,0));
+		expectMatrix("lookAt down -X", m, expected);
+	}
+
+	// The eye point maps to the origin and the center onto the negative Z-axis
+	{
+		mat4 m;
+		m.lookAt(vec3(1,2,3), vec3(-4,0,1), vec3(0,1,0));
+
+		vec4 eye = m.transformVector(vec4(1,2,3,1));
+		vec4 center = m.transformVector(vec4(-4,0,1,1));
+
+		expectTrue("lookAt maps the eye to the origin",
+		           fabsf(eye.x) < 1e-5f && fabsf(eye.y) < 1e-5f && fabsf(eye.z) < 1e-5f);
+
+		expectTrue("lookAt maps the center onto -Z",
+		           fabsf(center.x) < 1e-5f && fabsf(center.y) < 1e-5f && center.z < 0.0f);
+	}
+}
+
+void testPerspective(void)
+{
+	/*
+	gluPerspective(90, 2, 1, 3):
+	f = cot(45) = 1
+	m[0] = f/aspect = 0.5, m[5] = f = 1
+	m[10] = (far+near)/(near-far) = -2
+	m[14] = 2*far*near/(near-far) = -3
+	m[11] = -1
+	*/
+	const float expected[16] =
+	{
+		0.5f, 0, 0, 0,
+		0,    1, 0, 0,
+		0,    0,-2,-1,
+		0,    0,-3, 0
+	};
+
+	mat4 m;
+	m.perspective(90.0f, 2.0f, 1.0f, 3.0f);
+	expectMatrix("perspective", m, expected);
+}
+
+void testOrtho(void)
+{
+	/*
+	glOrtho(-1, 3, -2, 2, 1, 5):
+	m[0] = 2/(r-l) = 0.5, m[5] = 2/(t-b) = 0.5, m[10] = -2/(f-n) = -0.5
+	m[12] = -(r+l)/(r-l) = -0.5, m[13] = -(t+b)/(t-b) = 0, m[14] = -(f+n)/(f-n) = -1.5
+	*/
+	const float expected[16] =
+	{
+		0.5f, 0,    0,    0,
+		0,    0.5f, 0,    0,
+		0,    0,   -0.5f, 0,
+	   -0.5f, 0,   -1.5f, 1
+	};
+
+	mat4 m;
+	m.ortho(-1.0f, 3.0f, -2.0f, 2.0f, 1.0f, 5.0f);
+	expectMatrix("ortho", m, expected);
+}
+
+void testRotate(void)
+{
+	// glRotate(90, 0, 0, 1): x maps to y and y maps to -x
+	const float expected[16] =
+	{
+		 0, 1, 0, 0,
+		-1, 0, 0, 0,
+		 0, 0, 1, 0,
+		 0, 0, 0, 1
+	};
+
+	mat4 m;
+	m.rotate((float)M_PI / 2.0f, vec3(0,0,1));
+	expectMatrix("rotate about Z", m, expected);
+}
+
+void testInvert(void)
+{
+	// Scale by (2,4,8) then translate by (1,2,3)
+	{
+		const float matrix[16] =
+		{
+			2, 0, 0, 0,
+			0, 4, 0, 0,
+			0, 0, 8, 0,
+			1, 2, 3, 1
+		};
+
+		const float expected[16] =
+		{
+			0.5f,  0,     0,      0,
+			0,     0.25f, 0,      0,
+			0,     0,     0.125f, 0,
+		   -0.5f, -0.5f, -0.375f, 1
+		};
+
+		mat4 m(matrix);
+		expectTrue("invert a scale and translation succeeds", m.invert());
+		expectMatrix("invert a scale and translation", m, expected);
+	}
+
+	/*
+	The perspective matrix from testPerspective.  Its lower right block
+	[-2 -3; -1 0] has the inverse [0 -1; -1/3 2/3].
+	*/
+	{
+		const float expected[16] =
+		{
+			2, 0, 0,     0,
+			0, 1, 0,     0,
+			0, 0, 0,    -1.0f/3.0f,
+			0, 0,-1,     2.0f/3.0f
+		};
+
+		mat4 m;
+		m.perspective(90.0f, 2.0f, 1.0f, 3.0f);
+		expectTrue("invert a projection succeeds", m.invert());
+		expectMatrix("invert a projection", m, expected);
+	}
+
+	// A matrix times its inverse is the identity
+	{
+		mat4 view, projection;
+		view.lookAt(vec3(1,2,3), vec3(-4,0,1), vec3(0,1,0));
+		projection.perspective(60.0f, 4.0f/3.0f, 0.5f, 100.0f);
+
+		const mat4 m = projection * view;
+		const float identity[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+
+		expectMatrix("projection * view times its inverse", m * m.getInverse(), identity);
+	}
+
+	// A singular matrix is left unchanged
+	{
+		mat4 m;
+		m.zero();
+		m.m[0] = 1.0f;
+
+		const mat4 original = m;
+
+		expectTrue("invert a singular matrix fails", !m.invert());
+		expectMatrix("invert a singular matrix", m, original.m);
+	}
+}
+
+} // namespace
+
+int main(int, char**)
+{
+	testLookAt();
+	testPerspective();
+	testOrtho();
+	testRotate();
+	testInvert();
+
+	if(numFailures > 0)
+	{
+		printf("%d check(s) failed\n", numFailures);
+		return EXIT_FAILURE;
+	}
+
+	printf("All checks passed\n");
+	return EXIT_SUCCESS;
+}
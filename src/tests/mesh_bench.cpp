@@ -0,0 +1,153 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+Times keyframe interpolation of the hero (MD3) and spider (3DS) models.
+Every animation of each model is sampled at evenly spaced times, with the
+frame cache recycled before each request so that every frame is actually
+interpolated.  Build once with SSE and once without (for example with
+-U__SSE__ -U__SSE2__ on mesh.cpp) to compare the two code paths.
+
+The model loaders upload textures, so a small window is opened first to
+get an OpenGL context, as the game does at startup.
+
+usage: mesh_bench [data directory]
+The data directory defaults to redist/share/arbarlith2, relative to the top
+of the source tree.
+*/
+
+#include "engine/stdafx.h"
+#include "engine/file.h"
+#include "engine/Application.h"
+#include "engine/SDLwindow.h"
+#include "engine/opengl.h"
+#include "engine/Md3Loader.h"
+#include "engine/3dsLoader.h"
+#include "engine/simd.h"
+
+#include <ctime>
+
+using namespace Engine;
+
+namespace {
+
+const int NUM_SAMPLES = 200; // frames requested from each animation, per pass
+const int NUM_PASSES = 20;
+
+/**
+Times interpolation over every animation of a model
+@param name Name of the model to report
+@param controller The model
+*/
+void run(const char *name, const AnimationController &controller)
+{
+	size_t numVerts = 0, numFrames = 0;
+	double checksum = 0.0;
+
+	clock_t start = clock();
+
+	for(int pass = 0; pass < NUM_PASSES; ++pass)
+	{
+		for(size_t handle = 0; handle < controller.getNumAnimations(); ++handle)
+		{
+			AnimationSequence sequence = controller.getAnimation(handle); // shares the keyframes
+
+			if(sequence.getNumKeyFrames() < 2)
+				continue;
+
+			for(int i = 0; i < NUM_SAMPLES; ++i)
+			{
+				AnimationSequence::beginFrame();
+
+				sequence.SetTime(sequence.getLength() * (i + 0.5f) / NUM_SAMPLES);
+				const Model &frame = sequence.getFrame();
+
+				for(size_t j = 0; j < frame.size(); ++j)
+				{
+					numVerts += frame[j]->m_numOfVerts;
+					checksum += frame[j]->m_pVerts[0].x;
+				}
+
+				numFrames++;
+			}
+		}
+	}
+
+	const double milliseconds = double(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+	printf("%s: %u frames, %u vertices per frame, %.2f us per frame, %.2f ns per vertex (%g)\n",
+	       name,
+	       (unsigned int)numFrames,
+	       (unsigned int)(numVerts / max(numFrames, (size_t)1)),
+	       milliseconds * 1000.0 / numFrames,
+	       milliseconds * 1000000.0 / numVerts,
+	       checksum);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const string dataDirectory = (argc > 1) ? argv[1] : "redist/share/arbarlith2";
+
+	if(!setWorkingDirectory(dataDirectory))
+	{
+		printf("could not change to the data directory %s\n", dataDirectory.c_str());
+		return EXIT_FAILURE;
+	}
+
+#ifdef ENGINE_USE_SSE
+	printf("Mesh::interpolate is using SSE\n");
+#else
+	printf("Mesh::interpolate is using the scalar loop\n");
+#endif
+
+	g_pApplication = new Application();
+	new SDLWindow(*g_pApplication);
+	g_Window.Create("mesh_bench", 64, 64, SDLWindow::R8G8B8A8, 24, false);
+	new OpenGL(64, 64);
+
+	// Share nothing between requests, so every request interpolates
+	AnimationSequence::setTimeStep(0.0f);
+
+	Md3Loader md3;
+	AnimationController *hero = md3.load("data/hero/model.md3xml");
+	run("hero", *hero);
+
+	_3dsLoader _3ds;
+	AnimationController *spider = _3ds.load("data/spider/model.3dsxml");
+	run("spider", *spider);
+
+	delete hero;
+	delete spider;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,299 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+Times ParticleSystem::update on each of the shipped particle systems and
+prints the number of particles updated per millisecond.  Many instances of
+each system are started a few frames apart, so that the engine sees a
+steady mix of young and old particles as it would in a busy fight.
+Textures are not loaded, so no GL context is needed.
+
+The integrators are then timed on their own over 10,000 particles, once
+with ParticleSystem::integrate (SSE2 when it is available) and once with
+ParticleSystem::integrateScalar.  The graph evaluators are timed the same
+way, with ParticleSystem::evaluate and ParticleSystem::evaluateScalar over
+particles that alternate between the templates of the fireball system.
+
+usage: particle_bench [data directory]
+The data directory defaults to redist/share/arbarlith2, relative to the top
+of the source tree.
+*/
+
+#include "engine/stdafx.h"
+#include "engine/file.h"
+#include "engine/particle.h"
+#include "engine/simd.h"
+
+#include <ctime>
+
+using namespace Engine;
+
+namespace {
+
+const char *SYSTEMS[] =
+{
+	"data/particle/arctic-wind.xml",
+	"data/particle/chill-explosion.xml",
+	"data/particle/chill.xml",
+	"data/particle/fireball-explosion.xml",
+	"data/particle/fireball.xml",
+	"data/particle/heal.xml",
+	"data/particle/ice-blast.xml",
+	"data/particle/ice-explosion.xml",
+	"data/particle/small-ice-explosion.xml",
+	"data/particle/summon.xml"
+};
+
+const int NUM_INSTANCES = 64;
+const int STAGGER = 4;            // frames between the starts of successive instances
+const int NUM_FRAMES = 600;
+const float FRAME = 1000.0f / 60.0f; // milliseconds
+
+const size_t NUM_PARTICLES = 10000;
+const int NUM_ITERATIONS = 2000;
+
+/** Particle system loaded from a file, without textures on its materials */
+class UntexturedParticleSystem : public ParticleSystem
+{
+public:
+	UntexturedParticleSystem(const string &fileName)
+	{
+		PropertyBag bag;
+		bag.loadFromFile(fileName);
+		load(bag);
+	}
+
+protected:
+	virtual Material loadMaterial(PropertyBag &data)
+	{
+		Material mat;
+		string name;
+		data.get("name", name);
+		mat.setName(name);
+		return mat;
+	}
+};
+
+float random(float low, float high)
+{
+	return low + (high - low) * (float)rand() / (float)RAND_MAX;
+}
+
+double millisecondsSince(clock_t start)
+{
+	return double(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/**
+Times the update of many instances of one particle system
+@param fileName File name of the particle system
+@param totalUpdated Accumulates the number of particles updated
+@param totalMilliseconds Accumulates the time spent updating
+*/
+void run(const string &fileName, size_t &totalUpdated, double &totalMilliseconds)
+{
+	srand(1);
+
+	vector<UntexturedParticleSystem*> instances;
+
+	for(int i=0; i<NUM_INSTANCES; ++i)
+	{
+		instances.push_back(new UntexturedParticleSystem(fileName));
+	}
+
+	size_t peak = 0;
+	const size_t updatedBefore = ParticleSystem::getNumParticlesUpdated();
+	const clock_t start = clock();
+
+	for(int frame=0; frame<NUM_FRAMES; ++frame)
+	{
+		const int numStarted = min(NUM_INSTANCES, frame / STAGGER + 1);
+		size_t live = 0;
+
+		for(int i=0; i<numStarted; ++i)
+		{
+			instances[i]->update(FRAME);
+			live += instances[i]->getNumParticles();
+		}
+
+		peak = max(peak, live);
+	}
+
+	const double milliseconds = millisecondsSince(start);
+	const size_t updated = ParticleSystem::getNumParticlesUpdated() - updatedBefore;
+
+	printf("%-40s %9u updates, peak %5u live: %8.0f particles/ms\n",
+	       fileName.c_str(),
+	       (unsigned int)updated,
+	       (unsigned int)peak,
+	       (milliseconds > 0.0) ? updated / milliseconds : 0.0);
+
+	for(size_t i=0; i<instances.size(); ++i)
+	{
+		delete instances[i];
+	}
+
+	totalUpdated += updated;
+	totalMilliseconds += milliseconds;
+}
+
+/** Times the integrators on their own over a run of particles */
+void runIntegrators(void)
+{
+	srand(1);
+
+	ParticleVectors p0, v, a, positions;
+	vector<float> ages(NUM_PARTICLES);
+
+	p0.resize(NUM_PARTICLES);
+	v.resize(NUM_PARTICLES);
+	a.resize(NUM_PARTICLES);
+	positions.resize(NUM_PARTICLES);
+
+	for(size_t i=0; i<NUM_PARTICLES; ++i)
+	{
+		p0.set(i, vec3(random(-1, 1), random(-1, 1), random(-1, 1)));
+		v.set(i, vec3(random(-1, 1), random(-1, 1), random(-1, 1)));
+		a.set(i, vec3(0, random(-1, 0), 0));
+		ages[i] = random(0, 1000);
+	}
+
+	clock_t start = clock();
+	for(int n=0; n<NUM_ITERATIONS; ++n)
+	{
+		ParticleSystem::integrate(NUM_PARTICLES, 0.01f, &ages[0], p0, v, a, positions);
+	}
+	const double simd = millisecondsSince(start);
+
+	start = clock();
+	for(int n=0; n<NUM_ITERATIONS; ++n)
+	{
+		ParticleSystem::integrateScalar(NUM_PARTICLES, 0.01f, &ages[0], p0, v, a, positions);
+	}
+	const double scalar = millisecondsSince(start);
+
+	printf("integrate:       %.1f us per 10k (%.0f particles/ms)\n",
+	       simd * 1000.0 / NUM_ITERATIONS, double(NUM_PARTICLES) * NUM_ITERATIONS / simd);
+	printf("integrateScalar: %.1f us per 10k (%.0f particles/ms)\n",
+	       scalar * 1000.0 / NUM_ITERATIONS, double(NUM_PARTICLES) * NUM_ITERATIONS / scalar);
+	printf("(%g)\n", positions.x[NUM_PARTICLES/2]); // keeps the loops from being optimized away
+}
+
+/** Times the graph evaluators on their own over a run of particles */
+void runEvaluators(void)
+{
+	srand(1);
+
+	PropertyBag bag;
+	bag.loadFromFile("data/particle/fireball.xml");
+
+	UntexturedParticleSystem system("data/particle/fireball.xml");
+
+	vector<const ParticleElement*> templates;
+
+	for(size_t i=0; i<bag.count("template"); ++i)
+	{
+		PropertyBag templateBag;
+		string name;
+		bag.get("template", templateBag, i);
+		templateBag.get("name", name);
+		templates.push_back(&system.getTemplate(name));
+	}
+
+	vector<const ParticleElement*> particleTemplates(NUM_PARTICLES);
+	vector<float> ages(NUM_PARTICLES), lifeSpans(NUM_PARTICLES), sizeMultipliers(NUM_PARTICLES);
+	vector<float> radii(NUM_PARTICLES), reds(NUM_PARTICLES), greens(NUM_PARTICLES), blues(NUM_PARTICLES), alphas(NUM_PARTICLES);
+
+	for(size_t i=0; i<NUM_PARTICLES; ++i)
+	{
+		particleTemplates[i] = templates[i % templates.size()];
+		lifeSpans[i] = random(100, 2000);
+		ages[i] = random(0, lifeSpans[i]);
+		sizeMultipliers[i] = random(0.5f, 1.5f);
+	}
+
+	clock_t start = clock();
+	for(int n=0; n<NUM_ITERATIONS; ++n)
+	{
+		ParticleSystem::evaluate(NUM_PARTICLES, &particleTemplates[0], &ages[0], &lifeSpans[0], &sizeMultipliers[0],
+		                         &radii[0], &reds[0], &greens[0], &blues[0], &alphas[0]);
+	}
+	const double simd = millisecondsSince(start);
+
+	start = clock();
+	for(int n=0; n<NUM_ITERATIONS; ++n)
+	{
+		ParticleSystem::evaluateScalar(NUM_PARTICLES, &particleTemplates[0], &ages[0], &lifeSpans[0], &sizeMultipliers[0],
+		                               &radii[0], &reds[0], &greens[0], &blues[0], &alphas[0]);
+	}
+	const double scalar = millisecondsSince(start);
+
+	printf("evaluate:        %.1f us per 10k (%.0f particles/ms)\n",
+	       simd * 1000.0 / NUM_ITERATIONS, double(NUM_PARTICLES) * NUM_ITERATIONS / simd);
+	printf("evaluateScalar:  %.1f us per 10k (%.0f particles/ms)\n",
+	       scalar * 1000.0 / NUM_ITERATIONS, double(NUM_PARTICLES) * NUM_ITERATIONS / scalar);
+	printf("(%g)\n", radii[NUM_PARTICLES/2] + alphas[NUM_PARTICLES/3]); // keeps the loops from being optimized away
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const string dataDirectory = (argc > 1) ? argv[1] : "redist/share/arbarlith2";
+
+	if(!setWorkingDirectory(dataDirectory))
+	{
+		printf("could not change to the data directory %s\n", dataDirectory.c_str());
+		return EXIT_FAILURE;
+	}
+
+#ifdef ENGINE_USE_SSE2
+	printf("ParticleSystem::integrate is using SSE2\n");
+#else
+	printf("ParticleSystem::integrate is using the scalar loop\n");
+#endif
+
+	size_t totalUpdated = 0;
+	double totalMilliseconds = 0.0;
+
+	for(size_t i=0; i<sizeof(SYSTEMS)/sizeof(SYSTEMS[0]); ++i)
+	{
+		run(SYSTEMS[i], totalUpdated, totalMilliseconds);
+	}
+
+	printf("all systems: %.0f particles/ms\n\n",
+	       (totalMilliseconds > 0.0) ? totalUpdated / totalMilliseconds : 0.0);
+
+	runIntegrators();
+	runEvaluators();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,365 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+Runs each of the shipped particle systems and checks that the particles
+moved by ParticleSystem::integrate, which uses SSE2 when it is available,
+stay within a small tolerance of ParticleSystem::integrateScalar.  The
+graphs evaluated by ParticleSystem::evaluate are checked the same way
+against ParticleSystem::evaluateScalar, and every particle template graph
+in the shipped systems is checked against the curve its lookup table was
+baked from.  (Emitters evaluate the curves directly, without the table.)
+Textures are not loaded, so no GL context is needed.
+
+usage: particle_test [data directory]
+The data directory defaults to redist/share/arbarlith2, relative to the top
+of the source tree.
+*/
+
+#include "engine/stdafx.h"
+#include "engine/file.h"
+#include "engine/particle.h"
+#include "engine/simd.h"
+
+using namespace Engine;
+
+namespace {
+
+const char *SYSTEMS[] =
+{
+	"data/particle/arctic-wind.xml",
+	"data/particle/chill-explosion.xml",
+	"data/particle/chill.xml",
+	"data/particle/fireball-explosion.xml",
+	"data/particle/fireball.xml",
+	"data/particle/heal.xml",
+	"data/particle/ice-blast.xml",
+	"data/particle/ice-explosion.xml",
+	"data/particle/small-ice-explosion.xml",
+	"data/particle/summon.xml"
+};
+
+const int NUM_FRAMES = 300;
+const float FRAME = 1000.0f / 60.0f; // milliseconds
+
+/** Particle system loaded from a file, without textures on its materials */
+class UntexturedParticleSystem : public ParticleSystem
+{
+public:
+	UntexturedParticleSystem(const string &fileName)
+	{
+		PropertyBag bag;
+		bag.loadFromFile(fileName);
+		load(bag);
+	}
+
+protected:
+	virtual Material loadMaterial(PropertyBag &data)
+	{
+		Material mat;
+		string name;
+		data.get("name", name);
+		mat.setName(name);
+		return mat;
+	}
+};
+
+/** Allowed difference, relative to the size of the coordinate */
+const float TOLERANCE = 1e-5f;
+
+/** Largest difference seen, relative to the size of the coordinate */
+float worstError = 0.0f;
+
+/** Times at which each graph's lookup table is checked against its curve */
+const int NUM_GRAPH_SAMPLES = 4096;
+
+/** Allowed difference between a lookup table and its curve, relative to the size of the value */
+const float GRAPH_TOLERANCE = 1e-6f;
+
+/** Largest difference seen between a lookup table and its curve */
+float worstGraphError = 0.0f;
+
+/** Graphs of each particle template */
+const char *TEMPLATE_GRAPHS[] = { "size", "alpha", "red", "green", "blue" };
+
+/** Particles with random ages evaluated per template */
+const int NUM_EVALUATED = 1000;
+
+bool close(float a, float b)
+{
+	const float error = fabsf(a - b) / max(1.0f, fabsf(b));
+	worstError = max(worstError, error);
+	return error <= TOLERANCE;
+}
+
+bool close(const vec3 &a, const vec3 &b)
+{
+	return close(a.x, b.x) && close(a.y, b.y) && close(a.z, b.z);
+}
+
+/**
+Runs one particle system, comparing the two integrators every frame
+@return number of particles that were out of tolerance
+*/
+int run(const string &fileName, size_t &numCompared)
+{
+	srand(1);
+
+	UntexturedParticleSystem system(fileName);
+
+	ParticleVectors p0, v, a, current, simd, scalar, reference;
+	vector<float> ages, simdAges, scalarAges, referenceAges;
+
+	int failures = 0;
+
+	for(int frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		system.update(FRAME);
+
+		const size_t count = system.getNumParticles();
+		if(count == 0)
+			continue;
+
+		p0.resize(count);
+		v.resize(count);
+		a.resize(count);
+		current.resize(count);
+		reference.resize(count);
+		simd.resize(count);
+		scalar.resize(count);
+		ages.resize(count);
+
+		for(size_t i=0; i<count; ++i)
+		{
+			vec3 initialPosition, velocity, acceleration, position;
+			system.getParticle(i, initialPosition, velocity, acceleration, position, ages[i]);
+			p0.set(i, initialPosition);
+			v.set(i, velocity);
+			a.set(i, acceleration);
+			current.set(i, position);
+		}
+
+		// The positions left by update() against the scalar integrator
+		referenceAges = ages;
+		ParticleSystem::integrateScalar(count, 0.0f, &referenceAges[0], p0, v, a, reference);
+
+		// Both integrators stepped forward one more frame
+		simdAges = ages;
+		scalarAges = ages;
+		ParticleSystem::integrate(count, FRAME, &simdAges[0], p0, v, a, simd);
+		ParticleSystem::integrateScalar(count, FRAME, &scalarAges[0], p0, v, a, scalar);
+
+		for(size_t i=0; i<count; ++i)
+		{
+			if(!close(current.get(i), reference.get(i)) ||
+			   !close(simd.get(i), scalar.get(i)) ||
+			   !close(simdAges[i], scalarAges[i]))
+			{
+				failures++;
+			}
+		}
+
+		numCompared += count;
+	}
+
+	return failures;
+}
+
+/**
+Compares a graph's lookup table against the curve it was baked from
+@param graph Graph to check
+@return true if every sample is within tolerance
+*/
+bool checkGraph(const ParticleGraph &graph)
+{
+	bool ok = true;
+
+	for(int i=0; i<=NUM_GRAPH_SAMPLES; ++i)
+	{
+		const float t = (float)i / NUM_GRAPH_SAMPLES;
+		const float expected = graph.calculateValue(t);
+		const float error = fabsf(graph.getValue(t) - expected) / max(1.0f, fabsf(expected));
+
+		worstGraphError = max(worstGraphError, error);
+		ok = ok && (error <= GRAPH_TOLERANCE);
+	}
+
+	return ok;
+}
+
+/**
+Checks the lookup table of each graph of each particle template
+@param bag Data describing the particle system
+@param numChecked Accumulates the number of graphs checked
+@return number of graphs that were out of tolerance
+*/
+int checkGraphs(const PropertyBag &bag, size_t &numChecked)
+{
+	int failures = 0;
+
+	for(size_t i=0; i<bag.count("template"); ++i)
+	{
+		PropertyBag templateBag;
+		bag.get("template", templateBag, i);
+
+		for(size_t j=0; j<sizeof(TEMPLATE_GRAPHS)/sizeof(TEMPLATE_GRAPHS[0]); ++j)
+		{
+			PropertyBag graphBag;
+			templateBag.get(TEMPLATE_GRAPHS[j], graphBag);
+
+			if(!checkGraph(ParticleGraph(graphBag)))
+			{
+				failures++;
+			}
+
+			numChecked++;
+		}
+	}
+
+	return failures;
+}
+
+/**
+Evaluates particles of random ages spawned from each template of a particle
+system, comparing ParticleSystem::evaluate against evaluateScalar.  Templates
+alternate from one particle to the next, as they do in a system with
+several emitters.
+@return number of particles that were out of tolerance
+*/
+int evaluateTemplates(const string &fileName, const PropertyBag &bag, size_t &numCompared)
+{
+	srand(1);
+
+	UntexturedParticleSystem system(fileName);
+
+	vector<const ParticleElement*> templates;
+
+	for(size_t i=0; i<bag.count("template"); ++i)
+	{
+		PropertyBag templateBag;
+		string name;
+		bag.get("template", templateBag, i);
+		templateBag.get("name", name);
+		templates.push_back(&system.getTemplate(name));
+	}
+
+	const size_t count = NUM_EVALUATED * templates.size();
+
+	vector<const ParticleElement*> particleTemplates(count);
+	vector<float> ages(count), lifeSpans(count), sizeMultipliers(count);
+
+	for(size_t i=0; i<count; ++i)
+	{
+		particleTemplates[i] = templates[i % templates.size()];
+		lifeSpans[i] = 100.0f + 2000.0f * (float)rand() / RAND_MAX;
+		ages[i] = (i % 7 == 0) ? lifeSpans[i] : lifeSpans[i] * (float)rand() / RAND_MAX;
+		sizeMultipliers[i] = 0.5f + (float)rand() / RAND_MAX;
+	}
+
+	vector<float> simd[5], scalar[5];
+
+	for(int j=0; j<5; ++j)
+	{
+		simd[j].resize(count);
+		scalar[j].resize(count);
+	}
+
+	ParticleSystem::evaluate(count, &particleTemplates[0], &ages[0], &lifeSpans[0], &sizeMultipliers[0],
+	                         &simd[0][0], &simd[1][0], &simd[2][0], &simd[3][0], &simd[4][0]);
+
+	ParticleSystem::evaluateScalar(count, &particleTemplates[0], &ages[0], &lifeSpans[0], &sizeMultipliers[0],
+	                               &scalar[0][0], &scalar[1][0], &scalar[2][0], &scalar[3][0], &scalar[4][0]);
+
+	int failures = 0;
+
+	for(size_t i=0; i<count; ++i)
+	{
+		bool ok = true;
+
+		for(int j=0; j<5; ++j)
+		{
+			ok = close(simd[j][i], scalar[j][i]) && ok;
+		}
+
+		if(!ok)
+		{
+			failures++;
+		}
+	}
+
+	numCompared += count;
+
+	return failures;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const string dataDirectory = (argc > 1) ? argv[1] : "redist/share/arbarlith2";
+
+	if(!setWorkingDirectory(dataDirectory))
+	{
+		printf("could not change to the data directory %s\n", dataDirectory.c_str());
+		return EXIT_FAILURE;
+	}
+
+#ifdef ENGINE_USE_SSE2
+	printf("ParticleSystem::integrate is using SSE2\n");
+#else
+	printf("ParticleSystem::integrate is using the scalar loop\n");
+#endif
+
+	int failures = 0;
+
+	for(size_t i=0; i<sizeof(SYSTEMS)/sizeof(SYSTEMS[0]); ++i)
+	{
+		PropertyBag bag;
+		bag.loadFromFile(SYSTEMS[i]);
+
+		size_t numCompared = 0, numEvaluated = 0, numGraphs = 0;
+		const int n = run(SYSTEMS[i], numCompared);
+		const int e = evaluateTemplates(SYSTEMS[i], bag, numEvaluated);
+		const int g = checkGraphs(bag, numGraphs);
+
+		printf("%s: %s (%u particle updates, %u evaluations and %u graphs compared)\n",
+		       SYSTEMS[i], (n==0 && e==0 && g==0) ? "ok" : "FAILED",
+		       (unsigned int)numCompared, (unsigned int)numEvaluated, (unsigned int)numGraphs);
+
+		failures += n + e + g;
+	}
+
+	printf("largest relative difference: %g (tolerance %g)\n", worstError, TOLERANCE);
+	printf("largest relative difference of a lookup table from its curve: %g (tolerance %g)\n",
+	       worstGraphError, GRAPH_TOLERANCE);
+
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
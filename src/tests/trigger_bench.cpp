@@ -0,0 +1,168 @@
+/*
+Original Author: Andrew Fox
+E-Mail: mailto:foxostro@gmail.com
+
+Copyright (c) 2009 Game Creation Society
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Game Creation Society nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE Game Creation Society ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE Game Creation Society BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/*
+Times the actor and region update of a zone full of triggers while some
+occupants walk through it.  In the "polling" runs every trigger is woken at
+the start of each tick, which is how triggers behaved before they were
+driven by the events of their regions.  In the "event" runs triggers sleep
+until an occupant enters their region.
+
+The first table varies the number of triggers under a single occupant, and
+the second varies the number of occupants, and so of occupied cells, under
+a fixed number of triggers.
+*/
+
+#include "engine/stdafx.h"
+#include "engine/world.h"
+#include "engine/Trigger.h"
+
+#include <ctime>
+
+using namespace Engine;
+
+namespace {
+
+const float SPACING = 8.0f;       // meters between triggers
+const int NUM_TICKS = 500;
+const float TICK = 1000.0f / 60.0f; // milliseconds
+
+/**
+Times one zone
+@param gridSide Number of triggers along each side of the zone
+@param numOccupants Number of occupants walking through the zone
+@param polling true to wake every trigger on every tick
+*/
+void run(int gridSide, int numOccupants, bool polling)
+{
+	World *world = new World;
+	ActorSet &objects = world->getObjects();
+	RegionManager &regions = world->getRegions();
+
+	regions.create(gridSide * 2, gridSide * 2, SPACING);
+
+	vector<Actor*> triggers;
+
+	for(int z=0; z<gridSide; ++z)
+	{
+		for(int x=0; x<gridSide; ++x)
+		{
+			Actor *trigger = objects.createPtr("class Engine::Trigger", world);
+			trigger->clear(); // the trigger's own defaults, as it is not loaded from a file
+			trigger->Place(vec3((x + 0.5f) * SPACING, 0.0f, (z + 0.5f) * SPACING));
+			triggers.push_back(trigger);
+		}
+	}
+
+	vector<Actor*> walkers;
+
+	for(int i=0; i<numOccupants; ++i)
+	{
+		Actor *walker = objects.createPtr("class Engine::Actor", world);
+		regions.addOccupant(walker->m_ID, REGION_OCCUPANT_PLAYER);
+		walkers.push_back(walker);
+	}
+
+	const float side = gridSide * SPACING;
+
+	// Let the triggers settle before timing
+	for(int i=0; i<100; ++i)
+	{
+		objects.update(TICK, world);
+		regions.update(objects);
+	}
+
+	size_t occupiedCells = 0;
+
+	const clock_t start = clock();
+
+	for(int i=0; i<NUM_TICKS; ++i)
+	{
+		// Each occupant walks east along its own row, wrapping around at the edge
+		for(int j=0; j<numOccupants; ++j)
+		{
+			const float x = fmodf(i * 0.05f + j * 37.0f, side);
+			const float z = fmodf((j + 0.5f) * side / numOccupants, side);
+			walkers[j]->Place(vec3(x, 0.0f, z));
+		}
+
+		if(polling)
+		{
+			for(vector<Actor*>::iterator j = triggers.begin(); j != triggers.end(); ++j)
+				(*j)->wake();
+		}
+
+		objects.update(TICK, world);
+		regions.update(objects);
+
+		occupiedCells += regions.getNumOccupiedCells();
+	}
+
+	const double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("%-8s %5d triggers %3d occupants %5.1f occupied cells: %.4f ms/tick, %u awake at the end\n",
+	       polling ? "polling" : "event",
+	       gridSide * gridSide,
+	       numOccupants,
+	       double(occupiedCells) / NUM_TICKS,
+	       seconds * 1000.0 / NUM_TICKS,
+	       (unsigned int)objects.getNumAwake());
+
+	delete world;
+}
+
+} // namespace
+
+int main(int, char**)
+{
+	// Actors reach the scheduler through the application, which is never started here
+	g_pApplication = new Application();
+
+	const int sides[] = { 16, 32, 64 };
+	const int occupants[] = { 1, 4, 16, 64 };
+
+	printf("Varying the number of triggers:\n");
+
+	for(size_t i=0; i<sizeof(sides)/sizeof(sides[0]); ++i)
+	{
+		run(sides[i], 1, true);
+		run(sides[i], 1, false);
+	}
+
+	printf("\nVarying the number of occupants:\n");
+
+	for(size_t i=0; i<sizeof(occupants)/sizeof(occupants[0]); ++i)
+	{
+		run(32, occupants[i], false);
+	}
+
+	return EXIT_SUCCESS;
+}